@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Batch entry: the same stream of crossing pairs over 8 symbols, submitted
+// through submitOrders in batches of 1, 16, 256 and 4096. Two traders swap
+// the same shares back and forth so balances never run out.
+
+namespace
+{
+    constexpr int kSymbols = 8;
+    constexpr int kStream = 4096;
+
+    std::vector<OrderRequest> makeStream(const std::vector<SymbolId> &symbols)
+    {
+        std::vector<OrderRequest> stream;
+        stream.reserve(kStream);
+        for (int i = 0; i < kStream / 2; ++i)
+        {
+            SymbolId symbol = symbols[i % kSymbols];
+            int seller = 1 + (i / kSymbols) % 2;
+            int buyer = 3 - seller;
+            stream.push_back(OrderRequest{seller, symbol, 10, 100.0, OrderSide::SELL});
+            stream.push_back(OrderRequest{buyer, symbol, 10, 100.0, OrderSide::BUY});
+        }
+        return stream;
+    }
+}
+
+static void BM_Engine_SubmitBatch(benchmark::State &state)
+{
+    size_t batchSize = static_cast<size_t>(state.range(0));
+
+    MatchingEngine engine;
+    std::vector<SymbolId> symbols;
+    for (int i = 0; i < kSymbols; ++i)
+    {
+        std::string name = "BATCHBENCH" + std::to_string(i);
+        symbols.push_back(SymbolRegistry::instance().intern(name));
+    }
+    for (int traderId = 1; traderId <= 2; ++traderId)
+    {
+        engine.registerTrader(std::make_shared<Trader>(traderId, "T" + std::to_string(traderId), 1e9));
+        for (SymbolId symbol : symbols)
+        {
+            engine.getTrader(traderId)->onOrderFilled(SymbolRegistry::instance().name(symbol), 1e6, 0.01, true);
+        }
+    }
+
+    std::vector<OrderRequest> stream = makeStream(symbols);
+    std::vector<OrderResult> results(batchSize);
+    for (auto _ : state)
+    {
+        for (size_t offset = 0; offset < stream.size(); offset += batchSize)
+        {
+            std::span<const OrderRequest> batch(stream.data() + offset, batchSize);
+            benchmark::DoNotOptimize(engine.submitOrders(batch, results));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kStream);
+}
+BENCHMARK(BM_Engine_SubmitBatch)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,200 @@
+#include <benchmark/benchmark.h>
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Engine entry and settlement. SubmitOrder rests `depth` orders on both
+// sides of one book (100 orders per level) and then sends a stream in
+// which fill ratio percent of the orders take the oldest ask at the top,
+// which is sent again, and the rest rest inside the spread and are
+// cancelled. OnOrderFilled settles fills against a trader holding a given
+// number of positions, and MarkAndQuery marks one of them and reads the
+// portfolio totals.
+
+namespace
+{
+    constexpr double kMidPrice = 1000.00;
+    constexpr int kOrdersPerLevel = 100;
+
+    std::unique_ptr<MatchingEngine> makeEngine(int depth, SymbolId &symbol)
+    {
+        auto engine = std::make_unique<MatchingEngine>(depth + 1024);
+        symbol = SymbolRegistry::instance().intern("ENGINEBENCH");
+        engine->registerTrader(std::make_shared<Trader>(1, "Buyer", 1e12));
+        engine->registerTrader(std::make_shared<Trader>(2, "Seller", 1e12));
+        engine->getTrader(2)->onOrderFilled("ENGINEBENCH", 1e12, 0.01, true);
+        for (int i = 0; i < depth; ++i)
+        {
+            bool isBuy = (i % 2) == 0;
+            double offset = 0.01 * (1 + (i / 2) / kOrdersPerLevel);
+            engine->submitOrder(isBuy ? 1 : 2, symbol, 10, isBuy ? kMidPrice - offset : kMidPrice + offset,
+                                isBuy ? OrderSide::BUY : OrderSide::SELL);
+        }
+        return engine;
+    }
+}
+
+static void BM_Engine_SubmitOrder(benchmark::State &state)
+{
+    SymbolId symbol;
+    auto engine = makeEngine(static_cast<int>(state.range(0)), symbol);
+    int fillPercent = static_cast<int>(state.range(1));
+    int step = 0;
+
+    for (auto _ : state)
+    {
+        step = (step + 37) % 100;
+        if (step < fillPercent)
+        {
+            benchmark::DoNotOptimize(engine->submitOrder(1, symbol, 10, kMidPrice + 0.01, OrderSide::BUY));
+            benchmark::DoNotOptimize(engine->submitOrder(2, symbol, 10, kMidPrice + 0.01, OrderSide::SELL));
+        }
+        else
+        {
+            int orderId = engine->submitOrder(1, symbol, 10, kMidPrice, OrderSide::BUY);
+            benchmark::DoNotOptimize(engine->cancelOrder(orderId));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Engine_SubmitOrder)->ArgsProduct({{1000, 10000, 100000}, {0, 10, 50, 100}});
+
+// Looking up live orders among `depth` resting ones, and finished ones in
+// the order history
+static void BM_Engine_GetOrder(benchmark::State &state)
+{
+    SymbolId symbol;
+    int depth = static_cast<int>(state.range(0));
+    auto engine = makeEngine(depth, symbol);
+    int finished = engine->submitOrder(1, symbol, 10, kMidPrice, OrderSide::BUY);
+    engine->cancelOrder(finished);
+
+    int next = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(engine->getOrder(1 + next));
+        benchmark::DoNotOptimize(engine->getOrderRecord(finished));
+        next = (next + 7919) % depth;
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Engine_GetOrder)->Arg(1000)->Arg(100000);
+
+static void BM_Trader_OnOrderFilled(benchmark::State &state)
+{
+    int positions = static_cast<int>(state.range(0));
+    Trader trader(1, "Trader", 1e12);
+    std::vector<Instrument> instruments;
+    for (int i = 0; i < positions; ++i)
+    {
+        instruments.emplace_back("FILLBENCH" + std::to_string(i));
+        trader.onOrderFilled(instruments.back(), 1000000, 10000, true);
+    }
+
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        // Buy then sell the same lots, so the trader's holdings stay put
+        const Instrument &instrument = instruments[next];
+        trader.onOrderFilled(instrument, 10, 10000, true);
+        trader.onOrderFilled(instrument, 10, 10001, false);
+        next = (next + 7919) % instruments.size();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Trader_OnOrderFilled)->Arg(1)->Arg(100)->Arg(5000);
+
+// Marking one position and reading the portfolio totals back
+static void BM_Trader_MarkAndQuery(benchmark::State &state)
+{
+    int positions = static_cast<int>(state.range(0));
+    Trader trader(1, "Trader", 1e12);
+    std::vector<Instrument> instruments;
+    for (int i = 0; i < positions; ++i)
+    {
+        instruments.emplace_back("FILLBENCH" + std::to_string(i));
+        trader.onOrderFilled(instruments.back(), 1000000, 10000, true);
+    }
+
+    size_t next = 0;
+    double price = 100.0;
+    for (auto _ : state)
+    {
+        trader.updatePosition(instruments[next].symbolId, price);
+        benchmark::DoNotOptimize(trader.getTotalPnL());
+        benchmark::DoNotOptimize(trader.getPortfolioValue());
+        benchmark::DoNotOptimize(trader.getGrossExposure());
+        next = (next + 7919) % instruments.size();
+        price = price == 100.0 ? 100.01 : 100.0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Trader_MarkAndQuery)->Arg(1)->Arg(100)->Arg(5000);
+
+// Entry through the throwing submitOrder (0) and the OrderResult form (1).
+// Accept rests a buy and cancels it; Reject sends a buy from a trader with
+// no cash, as in a reject storm from a misbehaving client.
+static void BM_Engine_Accept(benchmark::State &state)
+{
+    SymbolId symbol;
+    auto engine = makeEngine(1000, symbol);
+    bool results = state.range(0) != 0;
+    OrderRequest request{1, symbol, 10, kMidPrice, OrderSide::BUY};
+
+    for (auto _ : state)
+    {
+        int orderId = results ? engine->submitOrder(request).orderId
+                              : engine->submitOrder(1, symbol, 10, kMidPrice, OrderSide::BUY);
+        benchmark::DoNotOptimize(engine->cancelOrder(orderId));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Engine_Accept)->Arg(0)->Arg(1);
+
+static void BM_Engine_Reject(benchmark::State &state)
+{
+    SymbolId symbol;
+    auto engine = makeEngine(1000, symbol);
+    engine->registerTrader(std::make_shared<Trader>(3, "Broke", 0.0));
+    bool results = state.range(0) != 0;
+    OrderRequest request{3, symbol, 10, kMidPrice, OrderSide::BUY};
+
+    for (auto _ : state)
+    {
+        if (results)
+        {
+            benchmark::DoNotOptimize(engine->submitOrder(request));
+        }
+        else
+        {
+            try
+            {
+                engine->submitOrder(3, symbol, 10, kMidPrice, OrderSide::BUY);
+            }
+            catch (const std::runtime_error &error)
+            {
+                benchmark::DoNotOptimize(error.what());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Engine_Reject)->Arg(0)->Arg(1);
+
+// The crossing half of SubmitOrder with stage profiling off and on
+static void BM_Engine_SubmitOrderProfiled(benchmark::State &state)
+{
+    SymbolId symbol;
+    auto engine = makeEngine(10000, symbol);
+    engine->enableLatencyProfiling(state.range(0) != 0);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(engine->submitOrder(1, symbol, 10, kMidPrice + 0.01, OrderSide::BUY));
+        benchmark::DoNotOptimize(engine->submitOrder(2, symbol, 10, kMidPrice + 0.01, OrderSide::SELL));
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_Engine_SubmitOrderProfiled)->Arg(0)->Arg(1);
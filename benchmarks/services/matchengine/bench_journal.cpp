@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include "MatchingEngine.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Journal cost: crossing pairs over 8 symbols with the journal off (group
+// size 0) and on with several group sizes, committing after every 4096
+// orders as a gateway acknowledging a batch would. Replay reads back a
+// journal of 100k orders into a fresh engine.
+
+namespace
+{
+    constexpr int kSymbols = 8;
+    constexpr int kStream = 4096;
+    constexpr int kReplayOrders = 100000;
+
+    std::string benchJournalPath()
+    {
+        return (std::filesystem::temp_directory_path() / "matchengine_bench.journal").string();
+    }
+
+    std::unique_ptr<MatchingEngine> makeEngine(std::vector<SymbolId> &symbols)
+    {
+        auto engine = std::make_unique<MatchingEngine>();
+        symbols.clear();
+        for (int i = 0; i < kSymbols; ++i)
+        {
+            symbols.push_back(SymbolRegistry::instance().intern("JRNLBENCH" + std::to_string(i)));
+        }
+        for (int traderId = 1; traderId <= 2; ++traderId)
+        {
+            engine->registerTrader(std::make_shared<Trader>(traderId, "T" + std::to_string(traderId), 1e12));
+            for (SymbolId symbol : symbols)
+            {
+                engine->getTrader(traderId)->onOrderFilled(SymbolRegistry::instance().name(symbol), 1e9, 0.01, true);
+            }
+        }
+        return engine;
+    }
+
+    // Two traders swap the same shares back and forth
+    void submitStream(MatchingEngine &engine, const std::vector<SymbolId> &symbols, int orders)
+    {
+        for (int i = 0; i < orders / 2; ++i)
+        {
+            SymbolId symbol = symbols[i % kSymbols];
+            int seller = 1 + (i / kSymbols) % 2;
+            engine.submitOrder(seller, symbol, 10, 100.0, OrderSide::SELL);
+            engine.submitOrder(3 - seller, symbol, 10, 100.0, OrderSide::BUY);
+        }
+    }
+}
+
+static void BM_Journal_Submit(benchmark::State &state)
+{
+    std::string path = benchJournalPath();
+    std::filesystem::remove(path);
+
+    std::vector<SymbolId> symbols;
+    auto engine = makeEngine(symbols);
+    if (state.range(0) > 0)
+    {
+        JournalConfig config;
+        config.groupSize = static_cast<size_t>(state.range(0));
+        engine->enableJournal(path, config);
+    }
+
+    for (auto _ : state)
+    {
+        submitStream(*engine, symbols, kStream);
+        if (Journal *journal = engine->getJournal())
+        {
+            journal->commit();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kStream);
+    if (Journal *journal = engine->getJournal())
+    {
+        state.counters["syncs"] = static_cast<double>(journal->getGroupCount());
+    }
+
+    engine.reset();
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Journal_Submit)->Arg(0)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+static void BM_Journal_Replay(benchmark::State &state)
+{
+    std::string path = benchJournalPath();
+    std::filesystem::remove(path);
+    std::vector<SymbolId> symbols;
+    {
+        auto engine = makeEngine(symbols);
+        engine->enableJournal(path);
+        submitStream(*engine, symbols, kReplayOrders);
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto engine = makeEngine(symbols);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(engine->enableJournal(path));
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kReplayOrders);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Journal_Replay)->Unit(benchmark::kMillisecond)->UseRealTime();
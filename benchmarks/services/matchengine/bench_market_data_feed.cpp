@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "MarketDataFeed.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+// Shared-memory feed: the cost of publishing one message, and the one-way
+// latency from publish to a reader polling its own mapping of the file. The
+// latency run publishes one message at a time and waits for the reader, so
+// it measures the handoff rather than queueing.
+
+namespace
+{
+    std::string benchFeedPath()
+    {
+        return "/dev/shm/matchengine_bench_feed." + std::to_string(::getpid());
+    }
+
+    std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    double percentile(std::vector<std::int64_t> &samples, double fraction)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return static_cast<double>(samples[index]);
+    }
+}
+
+static void BM_Feed_Publish(benchmark::State &state)
+{
+    std::string path = benchFeedPath();
+    MarketDataPublisher publisher(path);
+    Trade trade(1, 2, 1, 2, 0, 10, 10000);
+    for (auto _ : state)
+    {
+        publisher.onTrade(trade);
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_Feed_Publish);
+
+static void BM_Feed_PublishToReadLatency(benchmark::State &state)
+{
+    std::string path = benchFeedPath();
+    MarketDataPublisher publisher(path);
+    MarketDataReader reader(path);
+
+    std::atomic<std::uint64_t> consumed{0};
+    std::atomic<bool> done{false};
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(1 << 20);
+
+    std::thread consumer([&]()
+    {
+        FeedMessage message;
+        while (!done.load(std::memory_order_acquire))
+        {
+            if (!reader.poll(message))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            latencies.push_back(now() - message.timestamp);
+            consumed.store(message.sequence, std::memory_order_release);
+        }
+    });
+
+    Trade trade(1, 2, 1, 2, 0, 10, 10000);
+    std::uint64_t sequence = 0;
+    for (auto _ : state)
+    {
+        publisher.onTrade(trade);
+        ++sequence;
+        while (consumed.load(std::memory_order_acquire) < sequence)
+        {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    state.counters["p50_ns"] = percentile(latencies, 0.50);
+    state.counters["p99_ns"] = percentile(latencies, 0.99);
+    state.counters["p999_ns"] = percentile(latencies, 0.999);
+    state.counters["missed"] = static_cast<double>(reader.getMissedCount());
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_Feed_PublishToReadLatency)->UseRealTime();
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include "MarkToMarket.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Revaluing 10k traders over a 5k symbol universe after every symbol
+// moves. Each trader holds 100 of the symbols, 1M positions in all.
+// PerTrader marks every trader on every symbol through
+// Trader::updatePosition; Batch reprices the same positions as columns,
+// on the given number of threads; Symbol reprices one column.
+
+namespace
+{
+    constexpr int kTraders = 10000;
+    constexpr int kSymbols = 5000;
+    constexpr int kHoldings = 100;
+
+    struct Universe
+    {
+        std::vector<SymbolId> symbols;
+        std::vector<std::unique_ptr<Trader>> traders;
+        std::vector<double> prices; // by SymbolId
+    };
+
+    Universe &universe()
+    {
+        static Universe universe = []()
+        {
+            Universe built;
+            std::mt19937 rng(11);
+            std::vector<Instrument> instruments;
+            for (int s = 0; s < kSymbols; ++s)
+            {
+                instruments.emplace_back("MTMBENCH" + std::to_string(s));
+                built.symbols.push_back(instruments.back().symbolId);
+            }
+            for (int t = 0; t < kTraders; ++t)
+            {
+                built.traders.push_back(std::make_unique<Trader>(t, "Trader", 1e12));
+                for (int h = 0; h < kHoldings; ++h)
+                {
+                    Price price = 1000 + static_cast<Price>(rng() % 10000);
+                    built.traders.back()->onOrderFilled(instruments[rng() % kSymbols], 1 + rng() % 1000, price, true);
+                }
+            }
+            built.prices.assign(SymbolRegistry::instance().size(), 0.0);
+            for (SymbolId symbolId : built.symbols)
+            {
+                built.prices[symbolId] = 10.0 + static_cast<double>(rng() % 10000) / 100.0;
+            }
+            return built;
+        }();
+        return universe;
+    }
+
+    size_t positionCount(const Universe &universe)
+    {
+        size_t count = 0;
+        for (const auto &trader : universe.traders)
+        {
+            count += trader->getPositions().size();
+        }
+        return count;
+    }
+}
+
+static void BM_MarkToMarket_PerTrader(benchmark::State &state)
+{
+    Universe &u = universe();
+    for (auto _ : state)
+    {
+        for (SymbolId symbolId : u.symbols)
+        {
+            for (const auto &trader : u.traders)
+            {
+                trader->updatePosition(symbolId, u.prices[symbolId]);
+            }
+        }
+        benchmark::DoNotOptimize(u.traders.front()->getUnrealizedPnL());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(positionCount(u)));
+}
+BENCHMARK(BM_MarkToMarket_PerTrader)->Unit(benchmark::kMillisecond);
+
+static void BM_MarkToMarket_Batch(benchmark::State &state)
+{
+    Universe &u = universe();
+    MarkToMarket batch(static_cast<unsigned>(state.range(0)));
+    for (const auto &trader : u.traders)
+    {
+        batch.addTrader(*trader);
+    }
+    for (auto _ : state)
+    {
+        batch.revalue(u.prices);
+        benchmark::DoNotOptimize(batch.getUnrealizedPnL(0));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.getPositionCount()));
+}
+BENCHMARK(BM_MarkToMarket_Batch)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_MarkToMarket_Symbol(benchmark::State &state)
+{
+    Universe &u = universe();
+    MarkToMarket batch(1);
+    for (const auto &trader : u.traders)
+    {
+        batch.addTrader(*trader);
+    }
+    size_t next = 0;
+    for (auto _ : state)
+    {
+        SymbolId symbolId = u.symbols[next];
+        batch.revalue(symbolId, u.prices[symbolId]);
+        next = (next + 1) % u.symbols.size();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch.getPositionCount() / kSymbols));
+}
+BENCHMARK(BM_MarkToMarket_Symbol);
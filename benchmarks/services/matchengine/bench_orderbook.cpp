@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+#include "OrderBook.hpp"
+#include "OrderPool.hpp"
+#include <vector>
+
+// Depth-scaling benchmarks: each case first rests `depth` orders on both
+// sides of the book (100 orders per price level) and then measures one
+// operation while keeping the depth constant.
+
+namespace
+{
+    constexpr Price kMidPrice = 100000; // $1000.00 in cent ticks
+    constexpr int kOrdersPerLevel = 100;
+
+    struct DeepBook
+    {
+        OrderBook book{"BENCH"};
+        OrderPool pool;
+        std::vector<OrderHandle> resting;
+        int nextOrderId = 1;
+
+        explicit DeepBook(int depth) : pool(depth + 16)
+        {
+            resting.reserve(depth);
+            for (int i = 0; i < depth; ++i)
+            {
+                bool isBuy = (i % 2) == 0;
+                Price offset = 1 + (i / 2) / kOrdersPerLevel;
+                Price price = isBuy ? kMidPrice - offset : kMidPrice + offset;
+                resting.push_back(add(10, price, isBuy ? OrderSide::BUY : OrderSide::SELL));
+            }
+        }
+
+        OrderHandle add(Quantity quantity, Price price, OrderSide side)
+        {
+            OrderHandle handle = pool.allocate(nextOrderId++, 1, book.getSymbolId(), quantity, price, side);
+            book.addOrder(pool.get(handle));
+            return handle;
+        }
+    };
+}
+
+static void BM_OrderBook_AddRestingAndCancel(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        OrderHandle handle = deep.add(10, kMidPrice - 5, OrderSide::BUY);
+        benchmark::DoNotOptimize(deep.book.cancelOrder(deep.pool.get(handle)));
+        deep.pool.release(handle);
+    }
+}
+BENCHMARK(BM_OrderBook_AddRestingAndCancel)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OrderBook_CancelDeep(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+    size_t next = 0;
+
+    for (auto _ : state)
+    {
+        // Cancel an order from the middle of its level and put a replacement
+        // back so the depth stays constant
+        OrderHandle &victim = deep.resting[next];
+        Order *order = deep.pool.get(victim);
+        benchmark::DoNotOptimize(deep.book.cancelOrder(order));
+
+        state.PauseTiming();
+        Price price = order->getPrice();
+        OrderSide side = order->getSide();
+        deep.pool.release(victim);
+        victim = deep.add(10, price, side);
+        next = (next + 7919) % deep.resting.size();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_OrderBook_CancelDeep)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OrderBook_CrossingOrder(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+
+    // The best ask level in arrival order; odd indices are asks
+    std::vector<OrderHandle> bestAsks;
+    for (int i = 1; i < 2 * kOrdersPerLevel; i += 2)
+    {
+        bestAsks.push_back(deep.resting[i]);
+    }
+    size_t oldest = 0;
+
+    for (auto _ : state)
+    {
+        // Take the oldest ask at the top of the book, then replace it
+        OrderHandle buy = deep.add(10, kMidPrice + 1, OrderSide::BUY);
+        deep.pool.release(buy);
+        deep.pool.release(bestAsks[oldest]);
+        bestAsks[oldest] = deep.add(10, kMidPrice + 1, OrderSide::SELL);
+        oldest = (oldest + 1) % bestAsks.size();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_OrderBook_CrossingOrder)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OrderBook_TopOfBookQuery(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(deep.book.getBestBidPrice());
+        benchmark::DoNotOptimize(deep.book.getBestAskPrice());
+        benchmark::DoNotOptimize(deep.book.getSpread());
+        benchmark::DoNotOptimize(deep.book.getTopOfBook());
+    }
+}
+BENCHMARK(BM_OrderBook_TopOfBookQuery)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_OrderBook_BestBidPrice(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(deep.book.getBestBidPrice());
+    }
+}
+BENCHMARK(BM_OrderBook_BestBidPrice)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// A stream where fill ratio percent of the orders take the oldest ask at the
+// top of the book (which is then replaced) and the rest rest inside the
+// spread and are cancelled again. Args are depth and fill ratio.
+static void BM_OrderBook_MixedFlow(benchmark::State &state)
+{
+    DeepBook deep(static_cast<int>(state.range(0)));
+    int fillPercent = static_cast<int>(state.range(1));
+
+    std::vector<OrderHandle> bestAsks;
+    for (int i = 1; i < 2 * kOrdersPerLevel; i += 2)
+    {
+        bestAsks.push_back(deep.resting[i]);
+    }
+    size_t oldest = 0;
+    int step = 0;
+
+    for (auto _ : state)
+    {
+        // Spread the crossing orders evenly through the stream
+        step = (step + 37) % 100;
+        if (step < fillPercent)
+        {
+            OrderHandle buy = deep.add(10, kMidPrice + 1, OrderSide::BUY);
+            deep.pool.release(buy);
+            deep.pool.release(bestAsks[oldest]);
+            bestAsks[oldest] = deep.add(10, kMidPrice + 1, OrderSide::SELL);
+            oldest = (oldest + 1) % bestAsks.size();
+        }
+        else
+        {
+            OrderHandle handle = deep.add(10, kMidPrice, OrderSide::BUY);
+            benchmark::DoNotOptimize(deep.book.cancelOrder(deep.pool.get(handle)));
+            deep.pool.release(handle);
+        }
+    }
+}
+BENCHMARK(BM_OrderBook_MixedFlow)->ArgsProduct({{1000, 10000, 100000}, {0, 10, 50, 100}});
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include "ShardedMatchingEngine.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+// Shard scaling: one order-entry thread streams crossing sell/buy pairs
+// round-robin over 64 symbols and collects the results. Throughput should
+// grow with the shard count up to the number of free cores.
+
+namespace
+{
+    constexpr int kSymbols = 64;
+    constexpr int kBatch = 1024;
+    constexpr int kBuyer = 1;
+    constexpr int kSeller = 2;
+
+    // Collects whatever results are ready; gives the shards the core when
+    // there are none, in case they share it with this thread
+    size_t drain(ShardedMatchingEngine &engine, std::vector<ShardResult> &results)
+    {
+        size_t count = engine.pollResults(results.data(), results.size());
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+        return count;
+    }
+}
+
+static void BM_ShardedEngine_CrossingPairs(benchmark::State &state)
+{
+    ShardedMatchingEngine engine(static_cast<size_t>(state.range(0)));
+
+    std::vector<SymbolId> symbols;
+    engine.registerTrader(kBuyer, "Buyer", 1e12);
+    engine.registerTrader(kSeller, "Seller", 1e12);
+    for (int i = 0; i < kSymbols; ++i)
+    {
+        std::string name = "SHARDBENCH" + std::to_string(i);
+        symbols.push_back(SymbolRegistry::instance().intern(name));
+        engine.getTrader(kSeller, symbols.back())->onOrderFilled(name, 1e9, 0.01, true);
+    }
+    engine.start();
+
+    std::vector<ShardResult> results(kBatch);
+    std::uint64_t tag = 0;
+    for (auto _ : state)
+    {
+        size_t outstanding = 0;
+        for (int i = 0; i < kBatch; ++i)
+        {
+            SymbolId symbol = symbols[(i / 2) % kSymbols];
+            bool isSell = (i % 2) == 0;
+            while (!engine.submitOrder(++tag, isSell ? kSeller : kBuyer, symbol, 1, 100.0,
+                                       isSell ? OrderSide::SELL : OrderSide::BUY))
+            {
+                outstanding -= drain(engine, results);
+            }
+            ++outstanding;
+        }
+        while (outstanding > 0)
+        {
+            outstanding -= drain(engine, results);
+        }
+    }
+    engine.stop();
+
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+BENCHMARK(BM_ShardedEngine_CrossingPairs)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
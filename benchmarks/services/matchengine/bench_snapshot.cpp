@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include "MatchingEngine.hpp"
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Snapshot cost against book size: Capture is the pause on the matching
+// thread (the file is written in the background), Restore loads the
+// snapshot into a fresh engine, which is what a restart pays instead of
+// replaying the journal.
+
+namespace
+{
+    std::string benchSnapshotPath()
+    {
+        return (std::filesystem::temp_directory_path() / "matchengine_bench.snapshot").string();
+    }
+
+    std::unique_ptr<MatchingEngine> makeEngine()
+    {
+        auto engine = std::make_unique<MatchingEngine>(1 << 20);
+        engine->registerTrader(std::make_shared<Trader>(1, "T1", 1e12));
+        engine->registerTrader(std::make_shared<Trader>(2, "T2", 1e12));
+        engine->getTrader(2)->onOrderFilled("SNAPBENCH", 1e9, 0.01, true);
+        return engine;
+    }
+
+    // Resting orders spread over 200 levels a side
+    void fillBook(MatchingEngine &engine, int orders)
+    {
+        SymbolId symbol = engine.getSymbolId("SNAPBENCH");
+        for (int i = 0; i < orders / 2; ++i)
+        {
+            engine.submitOrder(1, symbol, 10, 100.0 - 0.01 * (i % 200), OrderSide::BUY);
+            engine.submitOrder(2, symbol, 10, 100.01 + 0.01 * (i % 200), OrderSide::SELL);
+        }
+    }
+}
+
+static void BM_Snapshot_Capture(benchmark::State &state)
+{
+    std::string path = benchSnapshotPath();
+    auto engine = makeEngine();
+    fillBook(*engine, static_cast<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        engine->takeSnapshot(path);
+        state.PauseTiming();
+        engine->flushSnapshots();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Snapshot_Capture)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+static void BM_Snapshot_Restore(benchmark::State &state)
+{
+    std::string path = benchSnapshotPath();
+    {
+        auto engine = makeEngine();
+        fillBook(*engine, static_cast<int>(state.range(0)));
+        engine->takeSnapshot(path);
+        engine->flushSnapshots();
+    }
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(1 << 20);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(engine->restoreSnapshot(path));
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Snapshot_Restore)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include "OrderBook.hpp"
+#include "OrderPool.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// One matcher thread moving the top of book while `readers` threads poll
+// the published quote. Every iteration adds an order that improves the
+// bid and cancels it again, so each one publishes two quotes. The
+// readers' completed copies are reported as reads per second.
+
+namespace
+{
+    constexpr Price kMidPrice = 100000;
+}
+
+static void BM_TopOfBook_Contention(benchmark::State &state)
+{
+    OrderBook book("TOPBENCH");
+    OrderPool pool(64);
+    int nextOrderId = 1;
+    for (Price offset = 1; offset <= 10; ++offset)
+    {
+        book.addOrder(pool.get(pool.allocate(nextOrderId++, 1, book.getSymbolId(), 10, kMidPrice - offset, OrderSide::BUY)));
+        book.addOrder(pool.get(pool.allocate(nextOrderId++, 1, book.getSymbolId(), 10, kMidPrice + offset, OrderSide::SELL)));
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<std::int64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int64_t r = 0; r < state.range(0); ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            std::int64_t count = 0;
+            BookQuote quote{};
+            while (!done.load(std::memory_order_relaxed))
+            {
+                count += book.tryGetQuote(quote);
+                benchmark::DoNotOptimize(quote);
+            }
+            reads.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+
+    for (auto _ : state)
+    {
+        OrderHandle handle = pool.allocate(nextOrderId++, 1, book.getSymbolId(), 5, kMidPrice, OrderSide::BUY);
+        book.addOrder(pool.get(handle));
+        benchmark::DoNotOptimize(book.cancelOrder(pool.get(handle)));
+        pool.release(handle);
+    }
+
+    done.store(true, std::memory_order_relaxed);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["reads"] = benchmark::Counter(static_cast<double>(reads.load()), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_TopOfBook_Contention)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
@@ -0,0 +1,152 @@
+#pragma once
+#include "ConcurrentQueue.hpp"
+#include "SymbolRegistry.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Records below this level are removed at compile time. Set through the
+// MATCHENGINE_LOG_LEVEL cache variable (0 = DEBUG ... 3 = ERROR).
+#ifndef MATCHENGINE_LOG_LEVEL
+#define MATCHENGINE_LOG_LEVEL 0
+#endif
+
+enum class LogLevel : std::uint8_t
+{
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR
+};
+
+constexpr LogLevel kCompiledLogLevel = static_cast<LogLevel>(MATCHENGINE_LOG_LEVEL);
+
+enum class LogEvent : std::uint16_t
+{
+    SYMBOL,                 // symbol name; written by the logger itself
+    INSTRUMENT,             // priceScale, tickSize, lotSize
+    ORDER_ACCEPTED,         // orderId, traderId, quantity, price
+    ORDER_REJECTED,         // traderId, reason
+    ORDER_PARTIALLY_FILLED, // orderId, traderId, fillQuantity, fillPrice, remaining
+    ORDER_FILLED,           // as ORDER_PARTIALLY_FILLED
+    ORDER_CANCELLED,        // orderId, traderId, cancelledQuantity
+    TRADE,                  // buyOrderId, sellOrderId, buyTraderId, sellTraderId, quantity, price
+    LOG_STATS               // records logged, records dropped; last record of a file
+};
+
+// Flag bits of a record
+constexpr std::uint8_t kLogFlagSell = 1;
+constexpr std::uint8_t kLogFlagAggressor = 2;
+
+// One cache line per record; arguments are raw integers (ticks, lots, ids)
+// and are only turned into text by the decoder
+struct LogRecord
+{
+    std::int64_t timestamp; // nanoseconds since the epoch
+    LogEvent event;
+    LogLevel level;
+    std::uint8_t flags;
+    SymbolId symbolId;
+    std::int64_t args[6];
+};
+static_assert(sizeof(LogRecord) == 64, "LogRecord should fill one cache line");
+
+// Binary log file: the magic, the record size, then raw records
+constexpr char kLogFileMagic[8] = {'M', 'E', 'L', 'O', 'G', '\0', '\0', '1'};
+
+// Asynchronous binary logger. Producers copy a fixed-size record into a
+// bounded lock-free ring and return; when the ring is full the record is
+// dropped and counted rather than waiting. A background thread drains the
+// ring into the file, so producers never block on I/O or take a lock.
+class BinaryLogger
+{
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 14;
+
+    // Capacity is rounded up to a power of two
+    explicit BinaryLogger(const std::string &path, LogLevel level = LogLevel::INFO,
+                          size_t capacity = kDefaultCapacity,
+                          std::chrono::milliseconds idleInterval = std::chrono::milliseconds(1));
+    ~BinaryLogger();
+
+    BinaryLogger(const BinaryLogger &) = delete;
+    BinaryLogger &operator=(const BinaryLogger &) = delete;
+
+    template <LogLevel Level>
+    void log(LogEvent event, SymbolId symbolId, std::uint8_t flags = 0,
+             std::int64_t a0 = 0, std::int64_t a1 = 0, std::int64_t a2 = 0,
+             std::int64_t a3 = 0, std::int64_t a4 = 0, std::int64_t a5 = 0)
+    {
+        if constexpr (Level >= kCompiledLogLevel)
+        {
+            if (Level >= level_.load(std::memory_order_relaxed))
+            {
+                push(LogRecord{now(), event, Level, flags, symbolId, {a0, a1, a2, a3, a4, a5}});
+            }
+        }
+    }
+
+    // Runtime threshold on top of the compiled one
+    void setLevel(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return level_.load(std::memory_order_relaxed); }
+
+    // Waits until every record logged so far is in the file
+    void flush();
+
+    const std::string &getPath() const { return path_; }
+    std::uint64_t getLoggedCount() const { return queue_.getPushedCount(); }
+    std::uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t getWrittenCount() const { return written_.load(std::memory_order_acquire); }
+
+private:
+    static std::int64_t now();
+    void push(const LogRecord &record);
+    void run();
+    size_t drain();
+    void write(const LogRecord &record);
+
+    MpscQueue<LogRecord> queue_;
+    alignas(64) std::atomic<std::uint64_t> dropped_;
+    alignas(64) std::atomic<std::uint64_t> written_;
+    std::atomic<LogLevel> level_;
+    std::atomic<bool> stopping_;
+
+    std::string path_;
+    std::ofstream out_;
+    std::vector<bool> namedSymbols_; // writer thread only
+    std::chrono::milliseconds idleInterval_;
+    std::thread thread_;
+};
+
+// Turns a binary log back into text, one line per record
+class LogDecoder
+{
+public:
+    // Throws std::runtime_error if the stream is not a binary log
+    size_t decode(std::istream &in, std::ostream &out);
+
+    static const char *levelName(LogLevel level);
+    static const char *eventName(LogEvent event);
+
+private:
+    struct Scale
+    {
+        int priceScale = 2;
+        std::int64_t tickSize = 1;
+        std::int64_t lotSize = 1;
+    };
+
+    void format(const LogRecord &record, std::ostream &out);
+    std::string price(SymbolId symbolId, std::int64_t ticks) const;
+    std::int64_t shares(SymbolId symbolId, std::int64_t lots) const;
+
+    std::unordered_map<SymbolId, std::string> names_;
+    std::unordered_map<SymbolId, Scale> scales_;
+};
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queues. Neither ever waits: tryPush fails when the queue
+// is full and tryPop fails when it is empty. Capacities are rounded up to a
+// power of two.
+
+// Any number of producers, one consumer. Every slot carries a sequence
+// number; a producer claims a slot with one CAS and publishes it with a
+// release store, so a stalled producer never corrupts its neighbours.
+template <typename T>
+class MpscQueue
+{
+public:
+    explicit MpscQueue(size_t capacity);
+
+    bool tryPush(const T &value);
+    bool tryPop(T &value);
+
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+    // Values pushed so far
+    std::uint64_t getPushedCount() const { return tail_.load(std::memory_order_acquire); }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::uint64_t mask_;
+    alignas(64) std::atomic<std::uint64_t> tail_; // next slot to claim
+    alignas(64) std::uint64_t head_;              // consumer only
+};
+
+// One producer, one consumer. Each side caches the other's index and only
+// reloads it when the queue looks full or empty.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity);
+
+    bool tryPush(const T &value);
+    bool tryPop(T &value);
+
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    std::uint64_t mask_;
+    alignas(64) std::atomic<std::uint64_t> tail_;
+    std::uint64_t cachedHead_; // producer only
+    alignas(64) std::atomic<std::uint64_t> head_;
+    std::uint64_t cachedTail_; // consumer only
+};
+
+inline std::uint64_t roundUpToPowerOfTwo(size_t capacity)
+{
+    std::uint64_t rounded = 1;
+    while (rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+template <typename T>
+MpscQueue<T>::MpscQueue(size_t capacity)
+    : slots_(new Slot[roundUpToPowerOfTwo(capacity)]),
+      mask_(roundUpToPowerOfTwo(capacity) - 1), tail_(0), head_(0)
+{
+    for (std::uint64_t i = 0; i <= mask_; ++i)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MpscQueue<T>::tryPush(const T &value)
+{
+    std::uint64_t position = tail_.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;)
+    {
+        slot = &slots_[position & mask_];
+        std::uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::int64_t diff = static_cast<std::int64_t>(sequence - position);
+        if (diff == 0)
+        {
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false; // the consumer has not released this slot yet
+        }
+        else
+        {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->value = value;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool MpscQueue<T>::tryPop(T &value)
+{
+    Slot &slot = slots_[head_ & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != head_ + 1)
+    {
+        return false;
+    }
+    value = slot.value;
+    slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+}
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity)
+    : slots_(new T[roundUpToPowerOfTwo(capacity)]),
+      mask_(roundUpToPowerOfTwo(capacity) - 1),
+      tail_(0), cachedHead_(0), head_(0), cachedTail_(0) {}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(const T &value)
+{
+    std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ > mask_)
+    {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        if (tail - cachedHead_ > mask_)
+        {
+            return false;
+        }
+    }
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPop(T &value)
+{
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_)
+    {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        if (head == cachedTail_)
+        {
+            return false;
+        }
+    }
+    value = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
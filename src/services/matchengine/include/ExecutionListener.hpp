@@ -0,0 +1,121 @@
+#pragma once
+#include "Order.hpp"
+#include "Trade.hpp"
+#include <cstdint>
+
+// Execution events are small value structs built on the matcher's stack and
+// passed by reference; listeners copy what they need before returning.
+struct OrderAcceptedEvent
+{
+    int orderId;
+    int traderId;
+    SymbolId symbolId;
+    OrderSide side;
+    OrderType type;
+    Quantity quantity;
+    Price price;
+};
+
+// Rejected before an order id was assigned
+struct OrderRejectedEvent
+{
+    int traderId;
+    SymbolId symbolId;
+    OrderSide side;
+    RejectReason reason;
+};
+
+struct OrderFillEvent
+{
+    int orderId;
+    int traderId;
+    SymbolId symbolId;
+    OrderSide side;
+    Quantity fillQuantity;
+    Price fillPrice;
+    Quantity remainingQuantity;
+    bool aggressor; // the incoming order rather than the resting one
+};
+
+struct OrderCancelledEvent
+{
+    int orderId;
+    int traderId;
+    SymbolId symbolId;
+    OrderSide side;
+    Quantity cancelledQuantity;
+};
+
+// A stop whose trigger price has traded, about to run as a market (STOP) or
+// limit (STOP_LIMIT) order
+struct StopTriggeredEvent
+{
+    int orderId;
+    int traderId;
+    SymbolId symbolId;
+    OrderSide side;
+    OrderType type;
+    Quantity quantity; // remaining
+    Price stopPrice;
+};
+
+enum class LevelAction : std::uint8_t
+{
+    ADD,    // a new price level
+    UPDATE, // new aggregate quantity or order count
+    DELETE  // the level is gone
+};
+
+// Change to one aggregated price level. Every change in a book gets the next
+// sequence number, so applying updates after OrderBook::getBookSequence() to
+// a depth snapshot taken at that sequence rebuilds the book; a gap means an
+// update was missed.
+struct BookUpdateEvent
+{
+    std::uint64_t sequence;
+    SymbolId symbolId;
+    OrderSide side;
+    LevelAction action;
+    Price price;
+    Quantity quantity; // 0 for DELETE
+    std::uint32_t orderCount;
+};
+
+// Receives execution events synchronously on the matcher thread. For every
+// match the book reports the trade first, then the resting order's fill,
+// then the incoming order's fill. Once a resting order's final fill has been
+// reported the book no longer touches it, so its storage may be reclaimed
+// from the callback. Level updates for a matched price follow the last fill
+// taken there.
+class ExecutionListener
+{
+public:
+    virtual ~ExecutionListener() = default;
+
+    virtual void onOrderAccepted(const OrderAcceptedEvent &) {}
+    virtual void onOrderRejected(const OrderRejectedEvent &) {}
+    virtual void onOrderPartiallyFilled(const OrderFillEvent &) {}
+    virtual void onOrderFilled(const OrderFillEvent &) {}
+    virtual void onOrderCancelled(const OrderCancelledEvent &) {}
+    virtual void onTrade(const Trade &) {}
+    virtual void onBookUpdate(const BookUpdateEvent &) {}
+
+    // Asked just before a triggered stop executes, with the book as the stop
+    // will find it; returning false cancels the stop instead
+    virtual bool onStopTriggered(const StopTriggeredEvent &) { return true; }
+};
+
+// The same events without virtual dispatch, for a listener fixed at compile
+// time: a BasicOrderBook<L> calls L's functions directly. Derive from this
+// and declare the events L handles; the rest fall through to these no-ops.
+struct StaticExecutionListener
+{
+    void onOrderAccepted(const OrderAcceptedEvent &) {}
+    void onOrderRejected(const OrderRejectedEvent &) {}
+    void onOrderPartiallyFilled(const OrderFillEvent &) {}
+    void onOrderFilled(const OrderFillEvent &) {}
+    void onOrderCancelled(const OrderCancelledEvent &) {}
+    void onTrade(const Trade &) {}
+    void onBookUpdate(const BookUpdateEvent &) {}
+    bool onStopTriggered(const StopTriggeredEvent &) { return true; }
+};
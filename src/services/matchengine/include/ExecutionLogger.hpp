@@ -0,0 +1,21 @@
+#pragma once
+#include "BinaryLogger.hpp"
+#include "ExecutionListener.hpp"
+
+// Writes execution events to a binary log. Trades are logged at INFO,
+// rejects at WARN and order lifecycle events at DEBUG.
+class ExecutionLogger : public ExecutionListener
+{
+public:
+    explicit ExecutionLogger(BinaryLogger &logger) : logger_(logger) {}
+
+    void onOrderAccepted(const OrderAcceptedEvent &event) override;
+    void onOrderRejected(const OrderRejectedEvent &event) override;
+    void onOrderPartiallyFilled(const OrderFillEvent &event) override;
+    void onOrderFilled(const OrderFillEvent &event) override;
+    void onOrderCancelled(const OrderCancelledEvent &event) override;
+    void onTrade(const Trade &trade) override;
+
+private:
+    BinaryLogger &logger_;
+};
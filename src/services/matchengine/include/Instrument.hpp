@@ -0,0 +1,107 @@
+#pragma once
+#include "SymbolRegistry.hpp"
+#include <cstdint>
+#include <cmath>
+#include <optional>
+#include <string>
+
+// Prices are carried as integer ticks and quantities as integer lots of the
+// instrument; doubles only appear at the API edges.
+using Price = std::int64_t;
+using Quantity = std::int64_t;
+
+// Cash is carried in fixed 1/kCashScale currency units
+using Cash = std::int64_t;
+constexpr std::int64_t kCashScale = 10000;
+
+inline Cash toCash(double amount) { return static_cast<Cash>(std::llround(amount * kCashScale)); }
+inline double fromCash(Cash amount) { return static_cast<double>(amount) / kCashScale; }
+
+struct Instrument
+{
+    static constexpr std::int64_t kDefaultMaxLots = 1'000'000'000'000;
+    static constexpr std::int64_t kDefaultMaxTicks = 1'000'000'000'000;
+
+    std::string symbol;
+    SymbolId symbolId;
+    int priceScale;        // decimal places of a price (at most 4)
+    std::int64_t tickSize; // minimum price increment, in units of 10^-priceScale
+    std::int64_t lotSize;  // shares per lot
+    // Largest order quantity and price accepted; maxLots * lotSize shares
+    // must fit in an int64
+    std::int64_t maxLots = kDefaultMaxLots;
+    std::int64_t maxTicks = kDefaultMaxTicks;
+
+    explicit Instrument(const std::string &symbol = "", int priceScale = 2,
+                        std::int64_t tickSize = 1, std::int64_t lotSize = 1)
+        : symbol(symbol),
+          symbolId(symbol.empty() ? kInvalidSymbolId : SymbolRegistry::instance().intern(symbol)),
+          priceScale(priceScale), tickSize(tickSize), lotSize(lotSize) {}
+
+    std::int64_t scaleFactor() const
+    {
+        std::int64_t factor = 1;
+        for (int i = 0; i < priceScale; ++i)
+        {
+            factor *= 10;
+        }
+        return factor;
+    }
+
+    // Whether a quantity or price is within the limits; the conversions
+    // below are only defined for values that are. NaN is in neither.
+    bool isQuantityInRange(double quantity) const
+    {
+        return std::abs(quantity) <= static_cast<double>(maxLots) * static_cast<double>(lotSize);
+    }
+    bool isPriceInRange(double price) const
+    {
+        return std::abs(price) * static_cast<double>(scaleFactor()) <=
+               static_cast<double>(maxTicks) * static_cast<double>(tickSize);
+    }
+
+    // Conversions at the API edge
+    Price toTicks(double price) const
+    {
+        return static_cast<Price>(std::llround(price * scaleFactor() / tickSize));
+    }
+    double toPrice(Price ticks) const
+    {
+        return static_cast<double>(ticks * tickSize) / scaleFactor();
+    }
+    Quantity toLots(double quantity) const
+    {
+        return static_cast<Quantity>(std::llround(quantity / lotSize));
+    }
+    double toQuantity(Quantity lots) const { return static_cast<double>(lots * lotSize); }
+
+    bool isOnTick(double price) const
+    {
+        double ticks = price * scaleFactor() / tickSize;
+        return std::abs(ticks - std::round(ticks)) < 1e-6;
+    }
+    bool isWholeLots(double quantity) const
+    {
+        double lots = quantity / lotSize;
+        return std::abs(lots - std::round(lots)) < 1e-9;
+    }
+
+    // Shares and cash value of a fill, exact in integer arithmetic
+    std::int64_t toShares(Quantity lots) const { return lots * lotSize; }
+    Cash notional(Quantity lots, Price ticks) const
+    {
+        return lots * lotSize * ticks * tickSize * (kCashScale / scaleFactor());
+    }
+    // The same, or nothing if it does not fit in Cash
+    std::optional<Cash> checkedNotional(Quantity lots, Price ticks) const
+    {
+        Cash value;
+        if (__builtin_mul_overflow(lots, lotSize, &value) || __builtin_mul_overflow(value, ticks, &value) ||
+            __builtin_mul_overflow(value, tickSize, &value) ||
+            __builtin_mul_overflow(value, kCashScale / scaleFactor(), &value))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+};
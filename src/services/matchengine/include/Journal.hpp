@@ -0,0 +1,146 @@
+#pragma once
+#include "ConcurrentQueue.hpp"
+#include "OrderRequest.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class JournalRecordType : std::uint8_t
+{
+    SYMBOL, // symbol name follows the record; maps the writer's SymbolId
+    SUBMIT, // an accepted order and the id it was given
+    CANCEL  // an accepted cancel
+};
+
+// Fixed-size journal record. Quantities and prices are the values the
+// caller submitted, so replay takes exactly the same path through the engine.
+struct JournalRecord
+{
+    std::uint64_t sequence;  // from 1, no gaps
+    std::uint32_t checksum;  // FNV-1a of the record with this field zero, then the name
+    JournalRecordType type;
+    std::uint8_t side;       // OrderSide
+    std::uint8_t orderType;  // OrderType
+    std::uint8_t reserved;
+    SymbolId symbolId;
+    std::int32_t traderId;
+    std::int32_t orderId;
+    std::uint32_t nameLength; // SYMBOL only
+    double quantity;
+    double price;
+    double stopPrice;
+};
+static_assert(sizeof(JournalRecord) == 56, "JournalRecord layout is part of the file format");
+
+// Journal file: the magic, the record size, then records
+constexpr char kJournalFileMagic[8] = {'M', 'E', 'J', 'R', 'N', 'L', '\0', '1'};
+
+struct JournalConfig
+{
+    // A group is written and synced once it holds this many records, or
+    // once its oldest record has waited maxDelay
+    size_t groupSize = 256;
+    std::chrono::microseconds maxDelay{500};
+    bool sync = true; // fdatasync each group; false leaves flushing to the OS
+    // Records appended but not yet taken by the writer; rounded up to a
+    // power of two. Appends only wait when it is full.
+    size_t capacity = 1 << 14;
+    // How often an idle writer looks for new records
+    std::chrono::microseconds pollInterval{50};
+};
+
+// Write-ahead journal of engine inputs. The matching thread copies each
+// record into a lock-free ring and carries on, taking no lock; a background
+// thread drains the ring into groups and writes each with one write and one
+// fdatasync (group commit), so a burst of orders costs one disk sync rather
+// than one each. Records are sequenced when appended; getDurableSequence()
+// tells how far they have reached disk, and commit() waits for everything
+// appended so far. Once a group fails to write nothing later becomes
+// durable, and commit() throws.
+class Journal
+{
+public:
+    // Appends to path, creating it if needed; an existing file must be a
+    // journal and its last record should be nextSequence - 1. Throws
+    // std::runtime_error if the file cannot be opened.
+    explicit Journal(const std::string &path, const JournalConfig &config = JournalConfig(),
+                     std::uint64_t nextSequence = 1);
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    // Matching thread only; return the record's sequence
+    std::uint64_t appendSubmit(const OrderRequest &request, int orderId);
+    std::uint64_t appendCancel(int orderId);
+
+    // Waits until every record appended so far is durable
+    void commit();
+
+    const std::string &getPath() const { return path_; }
+    std::uint64_t getLastSequence() const { return nextSequence_ - 1; }
+    std::uint64_t getDurableSequence() const { return durable_.load(std::memory_order_acquire); }
+    std::uint64_t getGroupCount() const { return groups_.load(std::memory_order_relaxed); }
+    // Appends that found the ring full and waited for the writer
+    std::uint64_t getStallCount() const { return stalls_; }
+
+private:
+    std::uint64_t append(JournalRecord &record);
+    void run();
+    // Writer side: adds a record, with its name and checksum, to the group
+    static void encode(std::vector<char> &group, JournalRecord &record);
+    void writeGroup(const std::vector<char> &group, std::uint64_t last);
+    bool commitPending() const
+    {
+        return commitRequested_.load(std::memory_order_acquire) > getDurableSequence() &&
+               !failed_.load(std::memory_order_acquire);
+    }
+
+    std::string path_;
+    JournalConfig config_;
+    int fd_;
+    SpscQueue<JournalRecord> queue_;
+    std::uint64_t nextSequence_;     // matching thread only
+    std::vector<bool> namedSymbols_; // matching thread only
+    std::uint64_t stalls_ = 0;       // matching thread only
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable committed_;
+    std::atomic<std::uint64_t> commitRequested_{0};
+    std::atomic<bool> stopping_{false};
+    std::atomic<bool> failed_{false}; // a group could not be written
+    std::atomic<std::uint64_t> durable_;
+    std::atomic<std::uint64_t> groups_{0};
+    std::thread thread_;
+};
+
+// Reads a journal back. next() returns SUBMIT and CANCEL records in order
+// with symbol ids translated to this process's registry; it stops at the end
+// of the file or at the first torn or corrupt record, which is where a crash
+// mid-write leaves the tail.
+class JournalReader
+{
+public:
+    // Throws std::runtime_error if the file cannot be read or is not a journal
+    explicit JournalReader(const std::string &path);
+
+    bool next(JournalRecord &record);
+
+    std::uint64_t getLastSequence() const { return lastSequence_; }
+    // Bytes up to the end of the last good record
+    std::uint64_t getValidSize() const { return validSize_; }
+
+private:
+    std::ifstream in_;
+    std::uint64_t lastSequence_ = 0;
+    std::uint64_t validSize_ = 0;
+    std::unordered_map<SymbolId, SymbolId> symbols_; // journal id to local id
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Stage timing is compiled in unless MATCHENGINE_LATENCY_PROFILING is 0, set
+// through the cache variable of the same name. Compiled out, every timing
+// point folds away; compiled in, it is one load and a branch until
+// switched on at runtime.
+#ifndef MATCHENGINE_LATENCY_PROFILING
+#define MATCHENGINE_LATENCY_PROFILING 1
+#endif
+
+constexpr bool kLatencyProfilingCompiled = MATCHENGINE_LATENCY_PROFILING != 0;
+
+// Stages of an accepted submit. Settlement runs inside matching, once per
+// trade, so its time is also part of MATCH.
+enum class LatencyStage : std::uint8_t
+{
+    BOOK_LOOKUP, // trader and book lookup, book creation
+    VALIDATE,    // unit conversion, cash and share checks
+    CREATE,      // pool slot, order id, journal append
+    MATCH,       // OrderBook::addOrder
+    SETTLE,      // trader settlement and listeners for one trade
+    RELEASE,     // giving back the slots of finished orders
+    PUBLISH,     // market data and snapshot bookkeeping
+    TOTAL,       // VALIDATE through PUBLISH
+    COUNT
+};
+
+constexpr size_t kLatencyStageCount = static_cast<size_t>(LatencyStage::COUNT);
+
+// Cheap timestamp in cycles: the time stamp counter where there is one,
+// otherwise steady_clock nanoseconds
+inline std::uint64_t readCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// readCycles() ticks per nanosecond, measured once against steady_clock
+double cyclesPerNanosecond();
+
+// Log-linear histogram of cycle counts in the style of HdrHistogram: values
+// below 64 have a bucket each, larger ones 32 buckets per power of two, so a
+// recorded value is known to within about 3%. One thread records with plain
+// relaxed stores; any thread may read.
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) << kSubBucketBits;
+
+    void record(std::uint64_t value)
+    {
+        std::atomic<std::uint64_t> &bucket = buckets_[bucketIndex(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getCount(size_t bucket) const { return buckets_[bucket].load(std::memory_order_relaxed); }
+
+    static size_t bucketIndex(std::uint64_t value);
+    // Largest value that falls into the bucket
+    static std::uint64_t bucketLimit(size_t bucket);
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+};
+
+// Percentiles of one stage since the last reset, in nanoseconds
+struct LatencySummary
+{
+    LatencyStage stage;
+    std::uint64_t count;
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+// One histogram per stage. The matching thread records; snapshots may be
+// taken from any thread. A reset does not touch the histograms, which stay
+// single-writer: it remembers the counts so far and later snapshots report
+// only what came after.
+class LatencyProfiler
+{
+public:
+    // The histograms are allocated the first time profiling is switched on
+    void setEnabled(bool enabled);
+    bool isEnabled() const
+    {
+        return kLatencyProfilingCompiled && enabled_.load(std::memory_order_acquire);
+    }
+
+    void record(LatencyStage stage, std::uint64_t cycles)
+    {
+        (*histograms_)[static_cast<size_t>(stage)].record(cycles);
+    }
+
+    // Records the time since start and returns now, for timing back-to-back
+    // stages
+    std::uint64_t lap(LatencyStage stage, std::uint64_t start)
+    {
+        std::uint64_t now = readCycles();
+        record(stage, now - start);
+        return now;
+    }
+
+    std::vector<LatencySummary> snapshot(bool reset = false);
+    void reset() { snapshot(true); }
+    // One line per stage that has samples
+    void print(std::ostream &out);
+
+    static const char *stageName(LatencyStage stage);
+
+private:
+    using Counts = std::vector<std::uint64_t>;
+
+    std::atomic<bool> enabled_{false};
+    std::unique_ptr<std::array<LatencyHistogram, kLatencyStageCount>> histograms_;
+    std::mutex readMutex_; // snapshot callers only
+    std::vector<Counts> baseline_;
+};
@@ -0,0 +1,130 @@
+#pragma once
+#include "ExecutionListener.hpp"
+#include "Trader.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Unrealized P&L for many traders at once. Positions are copied out of the
+// traders' ledgers into one column per symbol, held as parallel arrays of
+// Cash, so repricing a symbol is one pass over contiguous quantities:
+// marketValue = quantity * price, pnl = marketValue - costBasis. Repricing
+// every symbol splits the columns across persistent worker threads once the
+// universe is large enough.
+//
+// Each trader has one row, found by trader id. Added as an execution
+// listener, the batch re-reads a position from the trader's ledger after
+// every fill; otherwise call updatePosition or addTrader again after the
+// ledger changes. applyMarks writes the batch's prices back into the
+// ledgers. All calls are for one thread, normally the matcher's.
+class MarkToMarket : public ExecutionListener
+{
+public:
+    // Revaluations of fewer positions than this stay on the calling thread
+    static constexpr size_t kParallelThreshold = 1 << 16;
+
+    explicit MarkToMarket(unsigned threads = std::thread::hardware_concurrency(),
+                          size_t parallelThreshold = kParallelThreshold);
+    ~MarkToMarket();
+
+    MarkToMarket(const MarkToMarket &) = delete;
+    MarkToMarket &operator=(const MarkToMarket &) = delete;
+
+    // Copies the trader's open positions in, replacing what an earlier call
+    // copied for the same trader id. The trader must stay alive until it is
+    // removed or the batch is cleared.
+    void addTrader(Trader &trader);
+    void removeTrader(int traderId);
+    // Re-reads one of an added trader's positions from its ledger
+    void updatePosition(int traderId, SymbolId symbolId);
+    void clear();
+
+    void onOrderPartiallyFilled(const OrderFillEvent &event) override;
+    void onOrderFilled(const OrderFillEvent &event) override;
+
+    // Reprices one symbol's column, or every symbol given a price in prices,
+    // which is indexed by SymbolId. Columns past its end or priced NaN keep
+    // their last marks.
+    void revalue(SymbolId symbolId, double price);
+    void revalue(const std::vector<double> &prices);
+    // Marks the traders' ledgers at the batch's prices, for the columns
+    // revalued or added to since the last call
+    void applyMarks();
+
+    size_t getTraderCount() const { return traderCount_; }
+    size_t getPositionCount() const { return positionCount_; }
+    // Unrealized P&L by trader, by symbol, and in total
+    Cash getUnrealizedPnL(int traderId) const;
+    Cash getSymbolPnL(SymbolId symbolId) const
+    {
+        return symbolId < columns_.size() ? columns_[symbolId].pnl : 0;
+    }
+    Cash getTotalPnL() const;
+
+private:
+    static constexpr std::uint32_t kNoRow = 0xFFFFFFFF;
+
+    struct Column
+    {
+        std::vector<std::uint32_t> rows;
+        std::vector<std::int64_t> quantity; // shares
+        std::vector<Cash> costBasis;
+        std::vector<Cash> marketValue;
+        Cash pnl = 0;        // column total
+        double price = 0.0;  // of the last revaluation
+        bool priced = false; // revalued at least once
+        bool marked = false; // changed since applyMarks
+    };
+
+    // Where one of a row's positions sits in its column
+    struct Entry
+    {
+        SymbolId symbolId;
+        std::uint32_t index;
+    };
+
+    struct Row
+    {
+        Trader *trader = nullptr; // nullptr while the row is free
+        std::vector<Entry> entries;
+    };
+
+    std::uint32_t findRow(int traderId) const
+    {
+        auto index = static_cast<size_t>(traderId);
+        return index < rowOf_.size() ? rowOf_[index] : kNoRow;
+    }
+    Entry *findEntry(Row &row, SymbolId symbolId);
+    void insert(std::uint32_t row, const Position &position);
+    void erase(std::uint32_t row, Entry &entry);
+    void eraseRow(std::uint32_t row);
+
+    // Reprices columns [first, last) and adds every position's P&L in them
+    // into traderPnL, indexed by row
+    void revalueRange(const std::vector<double> &prices, size_t first, size_t last, Cash *traderPnL);
+    void runWorker(size_t worker);
+
+    std::vector<Column> columns_; // by SymbolId
+    std::vector<Row> rows_;
+    std::vector<Cash> traderPnL_;      // by row
+    std::vector<std::uint32_t> rowOf_; // by trader id
+    std::vector<std::uint32_t> freeRows_;
+    size_t traderCount_ = 0;
+    size_t positionCount_ = 0;
+    size_t parallelThreshold_;
+
+    // Helpers for revalue(prices); the calling thread takes the first run
+    // of columns and worker w the run after bounds_[w]
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable done_;
+    const std::vector<double> *prices_ = nullptr;
+    std::vector<size_t> bounds_;
+    std::vector<std::vector<Cash>> partials_; // row totals, one per thread
+    std::uint64_t generation_ = 0;
+    size_t running_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
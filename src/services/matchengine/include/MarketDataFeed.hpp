@@ -0,0 +1,118 @@
+#pragma once
+#include "ExecutionListener.hpp"
+#include "OrderBook.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shared-memory market data feed. The publisher writes fixed-size messages
+// into a ring in a memory-mapped file (normally under /dev/shm) and any
+// number of reader processes map the same file and poll it. Neither side
+// makes a system call or takes a lock per message.
+
+enum class FeedMessageType : std::uint8_t
+{
+    INSTRUMENT,   // name (16 bytes in fields[0..1]), priceScale, tickSize, lotSize
+    TRADE,        // price, quantity, buyOrderId, sellOrderId
+    TOP_OF_BOOK,  // bidPrice, bidQuantity, askPrice, askQuantity
+    LEVEL_UPDATE  // price, quantity, orderCount, book sequence
+};
+
+// One cache line per message; prices in ticks and quantities in lots
+struct FeedMessage
+{
+    std::uint64_t sequence; // from 1, one per message across all symbols
+    std::int64_t timestamp; // steady clock nanoseconds, comparable across processes on one host
+    FeedMessageType type;
+    std::uint8_t side;   // OrderSide, LEVEL_UPDATE only
+    std::uint8_t action; // LevelAction, LEVEL_UPDATE only
+    std::uint8_t reserved;
+    SymbolId symbolId;
+    std::int64_t fields[5];
+};
+static_assert(sizeof(FeedMessage) == 64, "FeedMessage should fill one cache line");
+
+constexpr char kFeedFileMagic[8] = {'M', 'E', 'F', 'E', 'E', 'D', '\0', '1'};
+
+// Start of the feed file; the message ring follows it
+struct FeedHeader
+{
+    char magic[8];
+    std::uint32_t messageSize;
+    std::uint32_t reserved;
+    std::uint64_t capacity;                 // messages, a power of two
+    alignas(64) std::uint64_t lastSequence; // last published, 0 before the first
+};
+
+// Writes the feed. Each slot's sequence field doubles as a seqlock: it is
+// zeroed before the slot is rewritten and set to the message's sequence once
+// the message is complete, so a reader can tell a torn copy from a good one.
+// The publisher never waits for readers; a reader that falls a whole ring
+// behind loses messages and sees the gap.
+//
+// As an execution listener it publishes trades and level updates; top of
+// book is published by publishTopOfBook when it has changed.
+class MarketDataPublisher : public ExecutionListener
+{
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    // Creates or truncates the file; capacity is rounded up to a power of
+    // two. The file is left in place on destruction.
+    explicit MarketDataPublisher(const std::string &path, size_t capacity = kDefaultCapacity);
+    ~MarketDataPublisher();
+
+    MarketDataPublisher(const MarketDataPublisher &) = delete;
+    MarketDataPublisher &operator=(const MarketDataPublisher &) = delete;
+
+    void publishInstrument(const Instrument &instrument);
+    void publishTopOfBook(const OrderBook &orderBook);
+
+    void onTrade(const Trade &trade) override;
+    void onBookUpdate(const BookUpdateEvent &event) override;
+
+    const std::string &getPath() const { return path_; }
+    std::uint64_t getPublishedCount() const { return sequence_; }
+
+private:
+    FeedMessage &claim(FeedMessageType type, SymbolId symbolId);
+    void publish(FeedMessage &message);
+
+    std::string path_;
+    size_t mappedSize_;
+    FeedHeader *header_;
+    FeedMessage *ring_;
+    std::uint64_t mask_;
+    std::uint64_t sequence_ = 0;
+    std::vector<TopOfBook> tops_; // last published per SymbolId
+};
+
+// Reads a feed file from any process. poll() returns messages in sequence
+// order; when the reader has been lapped it skips ahead to the oldest message
+// still in the ring and counts what it missed.
+class MarketDataReader
+{
+public:
+    // From the next message published, or from the oldest still in the ring.
+    // Throws std::runtime_error if the file is missing or not a feed.
+    explicit MarketDataReader(const std::string &path, bool fromOldest = false);
+    ~MarketDataReader();
+
+    MarketDataReader(const MarketDataReader &) = delete;
+    MarketDataReader &operator=(const MarketDataReader &) = delete;
+
+    // False when no new message has been published
+    bool poll(FeedMessage &message);
+
+    std::uint64_t getNextSequence() const { return next_; }
+    std::uint64_t getMissedCount() const { return missed_; }
+    std::uint64_t getLastPublished() const;
+
+private:
+    size_t mappedSize_;
+    const FeedHeader *header_;
+    const FeedMessage *ring_;
+    std::uint64_t mask_;
+    std::uint64_t next_;
+    std::uint64_t missed_ = 0;
+};
@@ -1,48 +1,237 @@
 #pragma once
+#include "ExecutionLogger.hpp"
+#include "Journal.hpp"
+#include "LatencyProfiler.hpp"
+#include "MarketDataFeed.hpp"
 #include "OrderBook.hpp"
+#include "OrderHistory.hpp"
+#include "OrderIndex.hpp"
+#include "OrderPool.hpp"
+#include "OrderRequest.hpp"
+#include "RiskAccounts.hpp"
+#include "Snapshot.hpp"
 #include "Trader.hpp"
 #include <map>
 #include <memory>
+#include <span>
 #include <vector>
 
-class MatchingEngine
+// The engine listens to its own books: it settles traders on trades and
+// reclaims order slots on fills, then forwards every event to the
+// registered execution listeners.
+class MatchingEngine : private ExecutionListener
 {
 public:
-    MatchingEngine();
+    static constexpr size_t kDefaultOrderPoolCapacity = 1 << 16;
+
+    explicit MatchingEngine(size_t orderPoolCapacity = kDefaultOrderPoolCapacity);
     ~MatchingEngine() = default;
 
-    // Trader management
+    // Trader management. Ids index the risk account table and must be in
+    // [0, RiskAccounts::kMaxTraderId].
     void registerTrader(std::shared_ptr<Trader> trader);
     std::shared_ptr<Trader> getTrader(int traderId) const;
 
-    // Order management
+    // Accepted orders reserve what they could spend: buys their limit (or
+    // stop) price times quantity, market buys the cost of sweeping the book,
+    // sells their shares. Pre-trade checks are against balances less these
+    // reservations; fills settle against them and never throw. A stop buy
+    // that triggers runs as a market order, so its reservation is re-priced
+    // then at the cost of sweeping the book; if the trader cannot cover it
+    // the stop is cancelled.
+    const RiskAccount *getRiskAccount(int traderId) const { return accounts_.find(traderId); }
+
+    // Instrument definitions; symbols that are never defined trade on the
+    // default instrument (cent ticks, single-share lots)
+    void defineInstrument(const Instrument &instrument);
+    const Instrument &getInstrument(SymbolId symbolId);
+    const Instrument &getInstrument(const std::string &symbol);
+
+    // The symbol's id, or kInvalidSymbolId if no symbol by that name has been
+    // seen; looking a name up never adds it to the registry
+    SymbolId getSymbolId(const std::string &symbol) const { return SymbolRegistry::instance().find(symbol); }
+
+    // OHLCV bar size and ring length for books created from now on
+    void configureBars(std::chrono::nanoseconds barInterval, size_t barCount);
+
+    // In-memory trades kept per book for books created from now on
+    void configureTradeHistory(size_t capacity);
+
+    // Spills every book's trades to <directory>/<symbol>.trades on a
+    // background writer; applies to existing and future books
+    void enableTradeSpill(const std::string &directory);
+    void flushTradeSpill();
+
+    // Binary execution log written off the matching thread; decode it with
+    // matchengine_logdecode. Null until enabled.
+    void enableLogging(const std::string &path, LogLevel level = LogLevel::INFO);
+    BinaryLogger *getLogger() const { return logger_.get(); }
+
+    // Publishes instruments, trades, level updates and top of book to a
+    // shared-memory ring at path (e.g. /dev/shm/<name>) for other processes
+    // to read with MarketDataReader. Null until enabled.
+    void enableMarketDataFeed(const std::string &path,
+                              size_t capacity = MarketDataPublisher::kDefaultCapacity);
+    MarketDataPublisher *getMarketDataFeed() const { return feed_.get(); }
+
+    // Write-ahead journal of every accepted submit and cancel, appended
+    // before the order reaches the book. Whatever the file already holds is
+    // replayed first, so enabling the journal at startup restores the books,
+    // open orders and trader balances; traders, instruments and the order id
+    // sequence must be set up as they were when it was written. A torn tail
+    // left by a crash is cut off. Returns the number of records replayed.
+    //
+    // Appends are group-committed in the background: callers that must not
+    // acknowledge before the disk has the order call getJournal()->commit().
+    size_t enableJournal(const std::string &path, const JournalConfig &config = JournalConfig());
+    Journal *getJournal() const { return journal_.get(); }
+
+    // Snapshots of the books (resting orders and pending stops in priority
+    // order, session totals), trader cash and positions, and the order id
+    // sequence. Capture copies the state into a flat image on the calling
+    // thread; the file is written in the background. Bars and the trade
+    // history are not included. takeSnapshot returns the last journal
+    // record the snapshot covers.
+    std::uint64_t takeSnapshot(const std::string &path);
+    // Takes a snapshot to path after every everyInputs accepted submits and
+    // cancels
+    void enableSnapshots(const std::string &path, size_t everyInputs);
+    void flushSnapshots();
+
+    // Loads a snapshot into an engine with no open orders and no journal.
+    // Books and traders it names are created if missing. Enabling the
+    // journal afterwards replays only the records after the snapshot, and a
+    // journal that ends before the snapshot is started afresh. Returns the
+    // last journal record the snapshot covers.
+    std::uint64_t restoreSnapshot(const std::string &path);
+
+    // Per-stage latency histograms of accepted submits, recorded on the
+    // matching thread; snapshot or print them from any thread. Off until
+    // enabled, and compiled out entirely with MATCHENGINE_LATENCY_PROFILING=0.
+    void enableLatencyProfiling(bool enabled) { profiler_.setEnabled(enabled); }
+    LatencyProfiler &getLatencyProfiler() { return profiler_; }
+
+    // Order ids are firstOrderId, firstOrderId + stride, ...; lets several
+    // engines hand out ids that never collide
+    void setOrderIdSequence(int firstOrderId, int stride);
+
+    // Execution listeners are not owned and must outlive the engine or be
+    // removed first
+    void addExecutionListener(ExecutionListener *listener);
+    void removeExecutionListener(ExecutionListener *listener);
+
+    // Order entry that never throws: the result carries the new order id or
+    // why the order was rejected, which listeners also see through
+    // onOrderRejected. Gateways facing untrusted clients should use this or
+    // submitOrders, since a reject costs no more than an accept.
+    OrderResult submitOrder(const OrderRequest &request);
+
+    // Order management; quantity and prices are converted to lots and ticks.
+    // Callers on the hot path should resolve the SymbolId once and use it.
+    // Market and stop orders pass a zero price; stops also give stopPrice.
+    // These forms throw on a reject: std::invalid_argument for a malformed
+    // order or unknown trader or symbol, std::runtime_error otherwise.
+    int submitOrder(int traderId, SymbolId symbolId, double quantity,
+                    double price, OrderSide side, OrderType type = OrderType::LIMIT,
+                    double stopPrice = 0.0);
     int submitOrder(int traderId, const std::string &symbol, double quantity,
-                    double price, OrderSide side, OrderType type = OrderType::LIMIT);
+                    double price, OrderSide side, OrderType type = OrderType::LIMIT,
+                    double stopPrice = 0.0);
     bool cancelOrder(int orderId);
-    std::shared_ptr<Order> getOrder(int orderId) const;
+
+    // Batch entry. Requests are grouped per book, keeping their order within
+    // a book, and results[i] answers requests[i]; rejects are reported in the
+    // results rather than thrown. Both return how many were accepted.
+    size_t submitOrders(std::span<const OrderRequest> requests, std::span<OrderResult> results);
+    size_t cancelOrders(std::span<const int> orderIds, std::span<OrderResult> results);
+    // Live (resting or pending stop) orders only; filled and cancelled orders
+    // give back their slot
+    const Order *getOrder(int orderId) const;
+    // Final state of a filled or cancelled order, kept while the order is
+    // among the last window ids handed out; nullptr for live orders and
+    // older ones. Fills made before a snapshot restore count at the order's
+    // limit price.
+    const OrderRecord *getOrderRecord(int orderId) const
+    {
+        return history_.find(orderId, nextOrderId_, orderIdStride_);
+    }
+    // Sets how many recent order ids keep a final state (default
+    // OrderHistory::kDefaultWindow); drops the records kept so far
+    void configureOrderHistory(size_t window) { history_ = OrderHistory(window); }
 
     // Market data
-    std::shared_ptr<OrderBook> getOrderBook(const std::string &symbol);
+    std::shared_ptr<OrderBook> getOrderBook(SymbolId symbolId) const;
+    std::shared_ptr<OrderBook> getOrderBook(const std::string &symbol) const;
+    double getLastPrice(SymbolId symbolId) const;
     double getLastPrice(const std::string &symbol) const;
+    double getBestBid(SymbolId symbolId) const;
     double getBestBid(const std::string &symbol) const;
+    double getBestAsk(SymbolId symbolId) const;
     double getBestAsk(const std::string &symbol) const;
 
     // Statistics and reporting
     void printMarketSummary() const;
     void printAllOrderBooks() const;
+    // Every retained trade, read back from the spill files where needed
     std::vector<Trade> getAllTrades() const;
 
     // Engine state
     size_t getTotalTradeCount() const;
     double getTotalVolume() const;
+    OrderPoolStats getOrderPoolStats() const { return orderPool_.getStats(); }
 
 private:
     int nextOrderId_;
-    std::map<std::string, std::shared_ptr<OrderBook>> orderBooks_;
+    int orderIdStride_;
+    std::vector<std::shared_ptr<OrderBook>> orderBooks_; // indexed by SymbolId
+    OrderBookConfig bookConfig_;
+    std::string spillDirectory_;
+    std::unique_ptr<TradeSpillWriter> spillWriter_; // stops before the books go
     std::map<int, std::shared_ptr<Trader>> traders_;
-    std::map<int, std::shared_ptr<Order>> orders_;
+    RiskAccounts accounts_;
+    OrderPool orderPool_;
+    std::vector<Cash> reservedCash_;           // by OrderHandle: what a buy still holds
+    std::vector<std::int64_t> filledNotional_; // by OrderHandle: ticks x lots filled
+    OrderIndex orders_;                        // live orders
+    OrderHistory history_;                     // finished orders
+    std::vector<ExecutionListener *> listeners_;
+    std::unique_ptr<BinaryLogger> logger_;
+    std::unique_ptr<ExecutionLogger> executionLogger_;
+    std::unique_ptr<MarketDataPublisher> feed_;
+    std::unique_ptr<Journal> journal_;
+    std::uint64_t journalSequence_ = 0; // last journal record applied
+    std::unique_ptr<SnapshotWriter> snapshotWriter_;
+    std::string snapshotPath_;
+    size_t snapshotInterval_ = 0;
+    size_t inputsSinceSnapshot_ = 0;
+    std::vector<const Order *> snapshotOrders_; // scratch for takeSnapshot
+    LatencyProfiler profiler_;
+    std::vector<std::uint64_t> batchOrder_; // scratch for submitOrders
+    std::vector<int> finishedOrders_;      // left the book during the current call
+
+    // Events from the books
+    void onOrderAccepted(const OrderAcceptedEvent &event) override;
+    void onOrderPartiallyFilled(const OrderFillEvent &event) override;
+    void onOrderFilled(const OrderFillEvent &event) override;
+    void onOrderCancelled(const OrderCancelledEvent &event) override;
+    void onTrade(const Trade &trade) override;
+    void onBookUpdate(const BookUpdateEvent &event) override;
+    bool onStopTriggered(const StopTriggeredEvent &event) override;
 
     // Helper methods
-    void processTradeNotifications(const std::vector<Trade> &trades);
-    std::shared_ptr<OrderBook> getOrCreateOrderBook(const std::string &symbol);
+    OrderResult placeOrder(RiskAccount *account, OrderBook &orderBook, const OrderRequest &request);
+    OrderResult reject(const OrderRequest &request, RejectReason reason);
+    Trader *findTrader(int traderId) const;
+    void reserve(RiskAccount &account, OrderHandle handle, const Instrument &instrument, Cash cash);
+    void settleFill(int orderId, const Instrument &instrument, Quantity lots, Price price);
+    OrderBook *findOrderBook(SymbolId symbolId) const;
+    OrderBook &getOrCreateOrderBook(SymbolId symbolId);
+    // nullptr for ids the symbol registry never handed out
+    OrderBook *findOrCreateOrderBook(SymbolId symbolId);
+    void startSpilling(OrderBook &orderBook);
+    void replay(const JournalRecord &record);
+    void countInput();
+    void logInstrument(const Instrument &instrument);
+    void releaseOrder(OrderHandle handle);
+    void releaseFinishedOrders();
 };
@@ -1,7 +1,9 @@
 #pragma once
+#include "Instrument.hpp"
 #include <string>
 #include <chrono>
 #include <memory>
+#include <optional>
 
 enum class OrderSide
 {
@@ -26,33 +28,66 @@ enum class OrderStatus
     REJECTED
 };
 
+enum class RejectReason
+{
+    UNKNOWN_TRADER,
+    INVALID_QUANTITY, // not whole lots, not positive, over the instrument limit, or too large a notional
+    INVALID_PRICE,    // off tick, not positive where required, or over the instrument limit
+    INSUFFICIENT_CASH,
+    INSUFFICIENT_SHARES,
+    POOL_EXHAUSTED,
+    UNKNOWN_ORDER, // cancel of an order that is not resting
+    UNKNOWN_SYMBOL // symbol id the registry never handed out
+};
+
+struct PriceLevel;
+template <typename Listener>
+class BasicOrderBook;
+
 class Order
 {
 public:
-    Order(int orderId, int traderId, const std::string &symbol,
-          double quantity, double price, OrderSide side, OrderType type = OrderType::LIMIT);
+    // Limit orders carry a price, market orders none. Stop orders carry a
+    // trigger price and become market (STOP) or limit (STOP_LIMIT) orders
+    // once a trade reaches it. Throws std::invalid_argument for what
+    // validate() rejects.
+    Order(int orderId, int traderId, SymbolId symbolId,
+          Quantity quantity, Price price, OrderSide side, OrderType type = OrderType::LIMIT,
+          Price stopPrice = 0);
+
+    // Why an order with these fields cannot be built, or nothing if it can;
+    // the entry path checks here so construction never throws
+    static std::optional<RejectReason> validate(Quantity quantity, Price price, OrderType type, Price stopPrice);
 
     // Getters
     int getOrderId() const { return orderId_; }
     int getTraderId() const { return traderId_; }
-    const std::string &getSymbol() const { return symbol_; }
-    double getQuantity() const { return quantity_; }
-    double getPrice() const { return price_; }
+    SymbolId getSymbolId() const { return symbolId_; }
+    const std::string &getSymbol() const { return SymbolRegistry::instance().name(symbolId_); }
+    Quantity getQuantity() const { return quantity_; }
+    Price getPrice() const { return price_; }
     OrderSide getSide() const { return side_; }
     OrderType getType() const { return type_; }
+    Price getStopPrice() const { return stopPrice_; }
     OrderStatus getStatus() const { return status_; }
-    double getFilledQuantity() const { return filledQuantity_; }
-    double getRemainingQuantity() const { return quantity_ - filledQuantity_; }
+    Quantity getFilledQuantity() const { return filledQuantity_; }
+    Quantity getRemainingQuantity() const { return quantity_ - filledQuantity_; }
     std::chrono::steady_clock::time_point getTimestamp() const { return timestamp_; }
 
     // Setters
     void setStatus(OrderStatus status) { status_ = status; }
-    void addFill(double quantity);
+    void addFill(Quantity quantity);
+    // Progress of an order read back from a snapshot
+    void restore(Quantity filledQuantity, bool triggered);
 
     // Utility methods
     bool isComplete() const { return filledQuantity_ >= quantity_; }
     bool isBuy() const { return side_ == OrderSide::BUY; }
     bool isSell() const { return side_ == OrderSide::SELL; }
+    bool isStop() const { return type_ == OrderType::STOP || type_ == OrderType::STOP_LIMIT; }
+    bool isTriggered() const { return triggered_; }
+    // Matches at any price and never rests
+    bool isMarketable() const { return type_ == OrderType::MARKET || type_ == OrderType::STOP; }
 
     // For priority queue comparison (price-time priority)
     bool operator<(const Order &other) const;
@@ -60,12 +95,25 @@ public:
 private:
     int orderId_;
     int traderId_;
-    std::string symbol_;
-    double quantity_;
-    double price_;
+    SymbolId symbolId_;
+    Quantity quantity_; // lots
+    Price price_;       // ticks
+    Price stopPrice_;   // ticks
     OrderSide side_;
     OrderType type_;
     OrderStatus status_;
-    double filledQuantity_;
+    Quantity filledQuantity_;
     std::chrono::steady_clock::time_point timestamp_;
+
+    bool triggered_ = false;
+
+    // Intrusive links for the FIFO of the price level (or stop trigger
+    // level) the order waits in, and that level; null while not waiting
+    Order *prev_ = nullptr;
+    Order *next_ = nullptr;
+    PriceLevel *level_ = nullptr;
+
+    friend struct PriceLevel;
+    template <typename Listener>
+    friend class BasicOrderBook;
 };
@@ -1,80 +1,800 @@
 #pragma once
+#include "ExecutionListener.hpp"
 #include "Order.hpp"
-#include <queue>
+#include "PriceLevel.hpp"
+#include "Seqlock.hpp"
+#include "TradeHistory.hpp"
+#include "TradeStats.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
 #include <map>
+#include <span>
 #include <vector>
 #include <memory>
 
-struct Trade
-{
-    int buyOrderId;
-    int sellOrderId;
-    int buyTraderId;
-    int sellTraderId;
-    std::string symbol;
-    double quantity;
-    double price;
-    std::chrono::steady_clock::time_point timestamp;
-
-    Trade(int buyOrderId, int sellOrderId, int buyTraderId, int sellTraderId,
-          const std::string &symbol, double quantity, double price)
-        : buyOrderId(buyOrderId), sellOrderId(sellOrderId),
-          buyTraderId(buyTraderId), sellTraderId(sellTraderId),
-          symbol(symbol), quantity(quantity), price(price),
-          timestamp(std::chrono::steady_clock::now()) {}
+// Per-book sizing of the statistics bars and the in-memory trade history
+struct OrderBookConfig
+{
+    std::chrono::nanoseconds barInterval = TradeStats::kDefaultBarInterval;
+    size_t barCount = TradeStats::kDefaultBarCount;
+    size_t tradeHistoryCapacity = TradeHistory::kDefaultCapacity;
+};
+
+// Best bid and ask with the aggregate resting quantity at each; a side with
+// no orders has zero price and quantity
+struct TopOfBook
+{
+    Price bidPrice;
+    Quantity bidQuantity;
+    Price askPrice;
+    Quantity askQuantity;
+};
+
+// Top of book with the last trade price, as published for readers on other
+// threads; sequence is the book sequence it reflects
+struct BookQuote
+{
+    Price bidPrice;
+    Quantity bidQuantity;
+    Price askPrice;
+    Quantity askQuantity;
+    Price lastPrice;
+    std::uint64_t sequence;
+};
+
+// One aggregated price level of a depth snapshot
+struct DepthLevel
+{
+    Price price;
+    Quantity quantity;
+    size_t orderCount;
 };
 
-class OrderBook
+// One instrument's book. Execution events go to a Listener called directly
+// from the matcher: OrderBook reports to an ExecutionListener through its
+// virtual functions, while a book instantiated with a concrete listener type
+// (see StaticExecutionListener) resolves every event at compile time, so the
+// calls can be inlined into matching.
+template <typename Listener = ExecutionListener>
+class BasicOrderBook
 {
 public:
-    explicit OrderBook(const std::string &symbol);
+    explicit BasicOrderBook(const std::string &symbol);
+    explicit BasicOrderBook(const Instrument &instrument, const OrderBookConfig &config = OrderBookConfig());
+
+    // Order management. The book does not own orders: a resting order or
+    // pending stop must stay alive until it fills or is cancelled.
+    //
+    // Market orders take whatever liquidity there is and the remainder is
+    // cancelled. Stop orders wait in a trigger index until a trade prints at
+    // or through their stop price (or are activated on arrival if the last
+    // trade already has). Activated stops are executed in a fixed order:
+    // buy stops by ascending, then sell stops by descending stop price, each
+    // level in arrival order; stops triggered by those executions queue
+    // behind them, so a cascade finishes within the same addOrder call. The
+    // listener may refuse a triggered stop, which is then cancelled.
+    //
+    // Orders are cancelled by pointer in O(1), through the level the order
+    // links back to. The book keeps no index by id; callers that look orders
+    // up by id, as the engine does with its OrderIndex, keep their own.
+    // cancelOrder returns false for an order not resting or pending here.
+    void addOrder(Order *order);
+    bool cancelOrder(Order *order);
+    // Whether the order is resting or a pending stop in this book
+    bool hasOrder(const Order *order) const
+    {
+        return order && order->level_ && order->getSymbolId() == instrument_.symbolId;
+    }
 
-    // Order management
-    void addOrder(std::shared_ptr<Order> order);
-    bool cancelOrder(int orderId);
-    std::shared_ptr<Order> getOrder(int orderId) const;
+    // Snapshot support. collectOrders appends every resting order and pending
+    // stop in priority order: bids best first, asks best first, then buy and
+    // sell stops in trigger order, each level in time priority. restoreOrder
+    // puts such an order back without matching; restoring them in the order
+    // collected rebuilds the same priorities.
+    void collectOrders(std::vector<const Order *> &orders) const;
+    void restoreOrder(Order *order);
 
-    // Market data
+    // Receives this book's execution events; not owned, may be null
+    void setExecutionListener(Listener *listener) { listener_ = listener; }
+
+    // Market data in ticks and lots; top of book is cached and O(1)
+    Price getBestBidTicks() const { return bestBid_ ? bestBid_->price : 0; }
+    Price getBestAskTicks() const { return bestAsk_ ? bestAsk_->price : 0; }
+    TopOfBook getTopOfBook() const;
+    Price getLastTradeTicks() const;
+    // Lots x ticks an order on this side would pay taking up to lots from
+    // the other side of the book as it stands; saturates at the largest
+    // int64 rather than overflowing
+    std::int64_t getSweepCost(OrderSide side, Quantity lots) const;
+
+    // Market data converted to prices at the API edge
     double getBestBidPrice() const;
     double getBestAskPrice() const;
+    double getBestBidQuantity() const;
+    double getBestAskQuantity() const;
     double getSpread() const;
-    size_t getBidDepth() const { return bids_.size(); }
-    size_t getAskDepth() const { return asks_.size(); }
+    size_t getBidDepth() const { return bidOrderCount_; }
+    size_t getAskDepth() const { return askOrderCount_; }
+    size_t getPendingStopCount() const { return stopCount_; }
+
+    // Level-2 depth: fills `levels` with up to levels.size() price levels from
+    // the best price outwards and returns how many were written. Nothing is
+    // allocated. Pair with getBookSequence() to join the update stream.
+    size_t getBidLevels(std::span<DepthLevel> levels) const;
+    size_t getAskLevels(std::span<DepthLevel> levels) const;
+    size_t getBidLevelCount() const { return bids_.size(); }
+    size_t getAskLevelCount() const { return asks_.size(); }
+    // Sequence of the last level update
+    std::uint64_t getBookSequence() const { return bookSequence_; }
+
+    // Every other accessor belongs to the thread that drives the book. The
+    // quote may be read from any thread at any time: it is published
+    // through a seqlock when a book call that changed it returns, so readers
+    // see the state between calls and never slow the matcher down. Whoever
+    // changes the book behind its back, as a snapshot restore does with the
+    // trade statistics, calls publishQuote() afterwards.
+    BookQuote getQuote() const { return quote_.load(); }
+    bool tryGetQuote(BookQuote &quote) const { return quote_.tryLoad(quote); }
+    void publishQuote();
 
     // Order book state
-    const std::string &getSymbol() const { return symbol_; }
-    const std::vector<Trade> &getTrades() const { return trades_; }
+    const std::string &getSymbol() const { return instrument_.symbol; }
+    SymbolId getSymbolId() const { return instrument_.symbolId; }
+    const Instrument &getInstrument() const { return instrument_; }
+    const TradeHistory &getTrades() const { return trades_; }
+    TradeHistory &getTradeHistory() { return trades_; }
 
-    // Statistics
+    // Statistics, maintained per trade
+    const TradeStats &getStats() const { return stats_; }
+    TradeStats &getTradeStats() { return stats_; }
     double getLastTradePrice() const;
     double getTotalVolume() const;
-    size_t getTradeCount() const { return trades_.size(); }
+    double getVwap() const;
+    size_t getTradeCount() const { return stats_.getTradeCount(); }
 
     void printOrderBook() const;
 
 private:
-    std::string symbol_;
+    Instrument instrument_;
+
+    // Price levels keyed by price; the best bid is the last bid level and the
+    // best ask is the first ask level
+    using LevelMap = std::map<Price, PriceLevel>;
+    LevelMap bids_;
+    LevelMap asks_;
+    size_t bidOrderCount_ = 0;
+    size_t askOrderCount_ = 0;
+
+    // Cached best levels, refreshed whenever a level is added or removed
+    const PriceLevel *bestBid_ = nullptr;
+    const PriceLevel *bestAsk_ = nullptr;
+
+    // Pending stops by stop price, with the same per-level FIFO as resting
+    // orders. Buy stops fire when trades reach up to their level, sell stops
+    // when trades reach down to it.
+    LevelMap buyStops_;
+    LevelMap sellStops_;
+    size_t stopCount_ = 0;
+
+    // Price range traded since stops were last checked
+    Price sweepLow_ = std::numeric_limits<Price>::max();
+    Price sweepHigh_ = std::numeric_limits<Price>::min();
+    std::vector<Order *> activated_; // FIFO of stops waiting to execute
+
+    // Bounded trade history
+    TradeHistory trades_;
+    TradeStats stats_;
+
+    Listener *listener_ = nullptr;
+    std::uint64_t bookSequence_ = 0;
+
+    BookQuote publishedQuote_{}; // writer's copy, to skip unchanged quotes
+    Seqlock<BookQuote> quote_;
+
+    // Helper methods
+    void execute(Order &order);
+    bool admitTriggeredStop(Order &order);
+    void cancelRemainder(Order &order);
+    void matchOrder(Order &newOrder);
+    bool stopReached(const Order &order) const;
+    void parkStop(Order *order);
+    void collectTriggeredStops();
+    void runActivatedStops();
+    void matchAtLevel(Order &newOrder, LevelMap &levels, typename LevelMap::iterator levelIt);
+    void restOrder(Order *order);
+    void removeRestingOrder(Order *order);
+    void refreshBestLevels();
+    void reportFill(const Order &order, Quantity quantity, Price price, bool aggressor);
+    void reportLevel(OrderSide side, const PriceLevel &level, LevelAction action);
+};
+
+using OrderBook = BasicOrderBook<>;
+
+template <typename Listener>
+BasicOrderBook<Listener>::BasicOrderBook(const std::string &symbol) : instrument_(symbol) {}
+
+template <typename Listener>
+BasicOrderBook<Listener>::BasicOrderBook(const Instrument &instrument, const OrderBookConfig &config)
+    : instrument_(instrument), trades_(config.tradeHistoryCapacity),
+      stats_(config.barInterval, config.barCount) {}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::addOrder(Order *order)
+{
+    if (order->getSymbolId() != instrument_.symbolId)
+    {
+        throw std::invalid_argument("Order symbol does not match order book symbol");
+    }
+
+    if (listener_)
+    {
+        OrderAcceptedEvent event{order->getOrderId(), order->getTraderId(), order->getSymbolId(),
+                                 order->getSide(), order->getType(), order->getQuantity(), order->getPrice()};
+        listener_->onOrderAccepted(event);
+    }
+
+    if (order->isStop())
+    {
+        if (!stopReached(*order))
+        {
+            parkStop(order);
+            return;
+        }
+        order->triggered_ = true;
+        if (!admitTriggeredStop(*order))
+        {
+            return;
+        }
+    }
+
+    execute(*order);
+    runActivatedStops();
+    publishQuote();
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::execute(Order &order)
+{
+    // Try to match the order
+    matchOrder(order);
+    if (order.isComplete())
+    {
+        return;
+    }
+
+    // Rest what is left of a limit order; a market order never rests
+    if (!order.isMarketable())
+    {
+        restOrder(&order);
+        return;
+    }
+    cancelRemainder(order);
+}
+
+template <typename Listener>
+bool BasicOrderBook<Listener>::admitTriggeredStop(Order &order)
+{
+    if (listener_)
+    {
+        StopTriggeredEvent event{order.getOrderId(), order.getTraderId(), order.getSymbolId(), order.getSide(),
+                                 order.getType(), order.getRemainingQuantity(), order.getStopPrice()};
+        if (!listener_->onStopTriggered(event))
+        {
+            cancelRemainder(order);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::cancelRemainder(Order &order)
+{
+    order.setStatus(OrderStatus::CANCELLED);
+    if (listener_)
+    {
+        OrderCancelledEvent event{order.getOrderId(), order.getTraderId(), order.getSymbolId(),
+                                  order.getSide(), order.getRemainingQuantity()};
+        listener_->onOrderCancelled(event);
+    }
+}
+
+template <typename Listener>
+bool BasicOrderBook<Listener>::stopReached(const Order &order) const
+{
+    if (stats_.getTradeCount() == 0)
+    {
+        return false;
+    }
+    Price last = stats_.getLast();
+    return order.isBuy() ? last >= order.getStopPrice() : last <= order.getStopPrice();
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::parkStop(Order *order)
+{
+    LevelMap &stops = order->isBuy() ? buyStops_ : sellStops_;
+    auto levelIt = stops.try_emplace(order->getStopPrice(), order->getStopPrice()).first;
+    levelIt->second.insert(order);
+    ++stopCount_;
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::collectTriggeredStops()
+{
+    if (sweepLow_ > sweepHigh_)
+    {
+        return; // no trades since the last check
+    }
+    Price low = sweepLow_;
+    Price high = sweepHigh_;
+    sweepLow_ = std::numeric_limits<Price>::max();
+    sweepHigh_ = std::numeric_limits<Price>::min();
+
+    // Buy stops at or below the highest trade, lowest trigger first
+    while (!buyStops_.empty() && buyStops_.begin()->first <= high)
+    {
+        PriceLevel &level = buyStops_.begin()->second;
+        for (Order *order = level.head; order; order = order->next_)
+        {
+            order->triggered_ = true;
+            order->level_ = nullptr;
+            activated_.push_back(order);
+        }
+        stopCount_ -= level.orderCount;
+        buyStops_.erase(buyStops_.begin());
+    }
+
+    // Sell stops at or above the lowest trade, highest trigger first
+    while (!sellStops_.empty() && std::prev(sellStops_.end())->first >= low)
+    {
+        auto levelIt = std::prev(sellStops_.end());
+        for (Order *order = levelIt->second.head; order; order = order->next_)
+        {
+            order->triggered_ = true;
+            order->level_ = nullptr;
+            activated_.push_back(order);
+        }
+        stopCount_ -= levelIt->second.orderCount;
+        sellStops_.erase(levelIt);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::runActivatedStops()
+{
+    collectTriggeredStops();
+
+    // Executions may trigger further stops, which queue behind the rest
+    for (size_t next = 0; next < activated_.size(); ++next)
+    {
+        // Time priority from activation, behind orders already resting
+        Order *order = activated_[next];
+        order->prev_ = order->next_ = nullptr;
+        order->timestamp_ = std::chrono::steady_clock::now();
+        if (admitTriggeredStop(*order))
+        {
+            execute(*order);
+        }
+        collectTriggeredStops();
+    }
+    activated_.clear();
+}
+
+template <typename Listener>
+bool BasicOrderBook<Listener>::cancelOrder(Order *order)
+{
+    // Only orders waiting in one of this book's levels can be cancelled
+    if (!hasOrder(order))
+    {
+        return false;
+    }
+
+    if (order->isStop() && !order->isTriggered())
+    {
+        LevelMap &stops = order->isBuy() ? buyStops_ : sellStops_;
+        PriceLevel &level = *order->level_;
+        level.erase(order);
+        if (level.empty())
+        {
+            stops.erase(level.price);
+        }
+        --stopCount_;
+    }
+    else
+    {
+        removeRestingOrder(order);
+        publishQuote();
+    }
+
+    order->setStatus(OrderStatus::CANCELLED);
+    if (listener_)
+    {
+        OrderCancelledEvent event{order->getOrderId(), order->getTraderId(), order->getSymbolId(),
+                                  order->getSide(), order->getRemainingQuantity()};
+        listener_->onOrderCancelled(event);
+    }
+    return true;
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::collectOrders(std::vector<const Order *> &orders) const
+{
+    auto collect = [&orders](const PriceLevel &level)
+    {
+        for (const Order *order = level.head; order; order = order->next_)
+        {
+            orders.push_back(order);
+        }
+    };
+    for (auto levelIt = bids_.rbegin(); levelIt != bids_.rend(); ++levelIt)
+    {
+        collect(levelIt->second);
+    }
+    for (const auto &[price, level] : asks_)
+    {
+        collect(level);
+    }
+    for (const auto &[price, level] : buyStops_)
+    {
+        collect(level);
+    }
+    for (auto levelIt = sellStops_.rbegin(); levelIt != sellStops_.rend(); ++levelIt)
+    {
+        collect(levelIt->second);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::restoreOrder(Order *order)
+{
+    if (order->getSymbolId() != instrument_.symbolId)
+    {
+        throw std::invalid_argument("Order symbol does not match order book symbol");
+    }
+    if (order->isStop() && !order->isTriggered())
+    {
+        parkStop(order);
+    }
+    else
+    {
+        restOrder(order);
+        publishQuote();
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::publishQuote()
+{
+    TopOfBook top = getTopOfBook();
+    BookQuote quote{top.bidPrice, top.bidQuantity, top.askPrice, top.askQuantity, stats_.getLast(), bookSequence_};
+    if (std::memcmp(&quote, &publishedQuote_, sizeof(BookQuote)) != 0)
+    {
+        publishedQuote_ = quote;
+        quote_.store(quote);
+    }
+}
+
+template <typename Listener>
+TopOfBook BasicOrderBook<Listener>::getTopOfBook() const
+{
+    return TopOfBook{
+        getBestBidTicks(), bestBid_ ? bestBid_->totalQuantity : 0,
+        getBestAskTicks(), bestAsk_ ? bestAsk_->totalQuantity : 0};
+}
+
+template <typename Listener>
+size_t BasicOrderBook<Listener>::getBidLevels(std::span<DepthLevel> levels) const
+{
+    size_t count = 0;
+    for (auto levelIt = bids_.rbegin(); levelIt != bids_.rend() && count < levels.size(); ++levelIt)
+    {
+        const PriceLevel &level = levelIt->second;
+        levels[count++] = DepthLevel{level.price, level.totalQuantity, level.orderCount};
+    }
+    return count;
+}
+
+template <typename Listener>
+size_t BasicOrderBook<Listener>::getAskLevels(std::span<DepthLevel> levels) const
+{
+    size_t count = 0;
+    for (auto levelIt = asks_.begin(); levelIt != asks_.end() && count < levels.size(); ++levelIt)
+    {
+        const PriceLevel &level = levelIt->second;
+        levels[count++] = DepthLevel{level.price, level.totalQuantity, level.orderCount};
+    }
+    return count;
+}
+
+template <typename Listener>
+Price BasicOrderBook<Listener>::getLastTradeTicks() const
+{
+    return stats_.getLast();
+}
+
+template <typename Listener>
+double BasicOrderBook<Listener>::getBestBidPrice() const
+{
+    return instrument_.toPrice(getBestBidTicks());
+}
+
+template <typename Listener>
+double BasicOrderBook<Listener>::getBestAskPrice() const
+{
+    return instrument_.toPrice(getBestAskTicks());
+}
+
+template <typename Listener>
+double BasicOrderBook<Listener>::getBestBidQuantity() const
+{
+    return instrument_.toQuantity(bestBid_ ? bestBid_->totalQuantity : 0);
+}
+
+template <typename Listener>
+double BasicOrderBook<Listener>::getBestAskQuantity() const
+{
+    return instrument_.toQuantity(bestAsk_ ? bestAsk_->totalQuantity : 0);
+}
 
-    // Priority queues for orders (best prices at top)
-    // Use a comparator that dereferences the shared_ptr to compare Orders
-    struct OrderPtrCompare
+template <typename Listener>
+std::int64_t BasicOrderBook<Listener>::getSweepCost(OrderSide side, Quantity lots) const
+{
+    std::int64_t cost = 0;
+    auto take = [&cost, &lots](const PriceLevel &level)
     {
-        bool operator()(const std::shared_ptr<Order> &a, const std::shared_ptr<Order> &b) const
+        Quantity taken = std::min(lots, level.totalQuantity);
+        std::int64_t levelCost;
+        if (__builtin_mul_overflow(taken, level.price, &levelCost) ||
+            __builtin_add_overflow(cost, levelCost, &cost))
         {
-            return *a < *b;
+            cost = std::numeric_limits<std::int64_t>::max();
+            lots = 0;
+            return;
         }
+        lots -= taken;
     };
+    if (side == OrderSide::BUY)
+    {
+        for (auto levelIt = asks_.begin(); levelIt != asks_.end() && lots > 0; ++levelIt)
+        {
+            take(levelIt->second);
+        }
+    }
+    else
+    {
+        for (auto levelIt = bids_.rbegin(); levelIt != bids_.rend() && lots > 0; ++levelIt)
+        {
+            take(levelIt->second);
+        }
+    }
+    return cost;
+}
+
+template <typename Listener>
+double BasicOrderBook<Listener>::getSpread() const
+{
+    Price bestBid = getBestBidTicks();
+    Price bestAsk = getBestAskTicks();
 
-    std::priority_queue<std::shared_ptr<Order>, std::vector<std::shared_ptr<Order>>, OrderPtrCompare> bids_; // Buy orders (highest price first)
-    std::priority_queue<std::shared_ptr<Order>, std::vector<std::shared_ptr<Order>>, OrderPtrCompare> asks_; // Sell orders (lowest price first)
+    if (bestBid > 0 && bestAsk > 0)
+    {
+        return instrument_.toPrice(bestAsk - bestBid);
+    }
+    return 0.0;
+}
 
-    // Map for quick order lookup
-    std::map<int, std::shared_ptr<Order>> orderMap_;
+template <typename Listener>
+double BasicOrderBook<Listener>::getLastTradePrice() const
+{
+    return instrument_.toPrice(getLastTradeTicks());
+}
 
-    // Trade history
-    std::vector<Trade> trades_;
+template <typename Listener>
+double BasicOrderBook<Listener>::getTotalVolume() const
+{
+    return instrument_.toQuantity(stats_.getVolume());
+}
 
-    // Helper methods
-    std::vector<Trade> matchOrder(std::shared_ptr<Order> newOrder);
-    void removeCompletedOrders();
-};
+template <typename Listener>
+double BasicOrderBook<Listener>::getVwap() const
+{
+    return stats_.getVwap() * instrument_.tickSize / instrument_.scaleFactor();
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::matchOrder(Order &newOrder)
+{
+    if (newOrder.isBuy())
+    {
+        // Match buy order against sell orders, lowest ask first
+        while (!asks_.empty() && !newOrder.isComplete())
+        {
+            auto bestAsk = asks_.begin();
+            if (!newOrder.isMarketable() && newOrder.getPrice() < bestAsk->first)
+            {
+                break; // No more matches possible
+            }
+            matchAtLevel(newOrder, asks_, bestAsk);
+        }
+    }
+    else
+    {
+        // Match sell order against buy orders, highest bid first
+        while (!bids_.empty() && !newOrder.isComplete())
+        {
+            auto bestBid = std::prev(bids_.end());
+            if (!newOrder.isMarketable() && newOrder.getPrice() > bestBid->first)
+            {
+                break; // No more matches possible
+            }
+            matchAtLevel(newOrder, bids_, bestBid);
+        }
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::matchAtLevel(Order &newOrder, LevelMap &levels, typename LevelMap::iterator levelIt)
+{
+    PriceLevel &level = levelIt->second;
+
+    // Fill resting orders in time priority
+    while (!level.empty() && !newOrder.isComplete())
+    {
+        Order *resting = level.head;
+
+        Quantity tradeQuantity = std::min(newOrder.getRemainingQuantity(),
+                                          resting->getRemainingQuantity());
+        Price tradePrice = level.price; // Price improvement for incoming order
+
+        // Execute trade
+        newOrder.addFill(tradeQuantity);
+        resting->addFill(tradeQuantity);
+        level.totalQuantity -= tradeQuantity;
+
+        // Record trade
+        const Order &buy = newOrder.isBuy() ? newOrder : *resting;
+        const Order &sell = newOrder.isBuy() ? *resting : newOrder;
+        Trade trade(buy.getOrderId(), sell.getOrderId(),
+                    buy.getTraderId(), sell.getTraderId(),
+                    instrument_.symbolId, tradeQuantity, tradePrice);
+        trades_.append(trade);
+        stats_.onTrade(tradePrice, tradeQuantity, trade.timestamp);
+        sweepLow_ = std::min(sweepLow_, tradePrice);
+        sweepHigh_ = std::max(sweepHigh_, tradePrice);
+
+        if (resting->isComplete())
+        {
+            level.erase(resting);
+            --(resting->isBuy() ? bidOrderCount_ : askOrderCount_);
+        }
+
+        // The resting order is not touched again once its fill is reported
+        if (listener_)
+        {
+            listener_->onTrade(trade);
+            reportFill(*resting, tradeQuantity, tradePrice, false);
+            reportFill(newOrder, tradeQuantity, tradePrice, true);
+        }
+    }
+
+    // One update per level swept, however many orders it took
+    OrderSide restingSide = newOrder.isBuy() ? OrderSide::SELL : OrderSide::BUY;
+    if (level.empty())
+    {
+        reportLevel(restingSide, level, LevelAction::DELETE);
+        levels.erase(levelIt);
+        refreshBestLevels();
+    }
+    else
+    {
+        reportLevel(restingSide, level, LevelAction::UPDATE);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::restOrder(Order *order)
+{
+    LevelMap &levels = order->isBuy() ? bids_ : asks_;
+    auto [levelIt, created] = levels.try_emplace(order->getPrice(), order->getPrice());
+    levelIt->second.insert(order);
+    ++(order->isBuy() ? bidOrderCount_ : askOrderCount_);
+    refreshBestLevels();
+    reportLevel(order->getSide(), levelIt->second, created ? LevelAction::ADD : LevelAction::UPDATE);
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::removeRestingOrder(Order *order)
+{
+    LevelMap &levels = order->isBuy() ? bids_ : asks_;
+    PriceLevel &level = *order->level_;
+
+    level.erase(order);
+    --(order->isBuy() ? bidOrderCount_ : askOrderCount_);
+    if (level.empty())
+    {
+        reportLevel(order->getSide(), level, LevelAction::DELETE);
+        levels.erase(level.price);
+        refreshBestLevels();
+    }
+    else
+    {
+        reportLevel(order->getSide(), level, LevelAction::UPDATE);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::reportFill(const Order &order, Quantity quantity, Price price, bool aggressor)
+{
+    OrderFillEvent event{order.getOrderId(), order.getTraderId(), order.getSymbolId(), order.getSide(),
+                         quantity, price, order.getRemainingQuantity(), aggressor};
+    if (order.isComplete())
+    {
+        listener_->onOrderFilled(event);
+    }
+    else
+    {
+        listener_->onOrderPartiallyFilled(event);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::reportLevel(OrderSide side, const PriceLevel &level, LevelAction action)
+{
+    ++bookSequence_;
+    if (listener_)
+    {
+        BookUpdateEvent event{bookSequence_, instrument_.symbolId, side, action, level.price,
+                              level.totalQuantity, static_cast<std::uint32_t>(level.orderCount)};
+        listener_->onBookUpdate(event);
+    }
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::refreshBestLevels()
+{
+    bestBid_ = bids_.empty() ? nullptr : &bids_.rbegin()->second;
+    bestAsk_ = asks_.empty() ? nullptr : &asks_.begin()->second;
+}
+
+template <typename Listener>
+void BasicOrderBook<Listener>::printOrderBook() const
+{
+    std::cout << "\n=== Order Book for " << instrument_.symbol << " ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(instrument_.priceScale);
+
+    // Print asks (sells) in descending price order
+    std::cout << "\nAsks (Sells):" << std::endl;
+    for (auto levelIt = asks_.rbegin(); levelIt != asks_.rend(); ++levelIt)
+    {
+        for (const Order *order = levelIt->second.head; order; order = order->next_)
+        {
+            std::cout << "  $" << instrument_.toPrice(order->getPrice())
+                      << " x " << instrument_.toQuantity(order->getRemainingQuantity()) << std::endl;
+        }
+    }
+
+    std::cout << "\n--- Spread: $" << getSpread() << " ---" << std::endl;
+
+    // Print bids (buys) in descending price order
+    std::cout << "\nBids (Buys):" << std::endl;
+    for (auto levelIt = bids_.rbegin(); levelIt != bids_.rend(); ++levelIt)
+    {
+        for (const Order *order = levelIt->second.head; order; order = order->next_)
+        {
+            std::cout << "  $" << instrument_.toPrice(order->getPrice())
+                      << " x " << instrument_.toQuantity(order->getRemainingQuantity()) << std::endl;
+        }
+    }
+
+    std::cout << "\nLast Trade: $" << getLastTradePrice() << std::endl;
+    std::cout << "Total Volume: " << getTotalVolume() << std::endl;
+    std::cout << "===========================\n"
+              << std::endl;
+}
+
+// Instantiated once, in OrderBook.cpp
+extern template class BasicOrderBook<ExecutionListener>;
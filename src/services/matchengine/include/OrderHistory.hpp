@@ -0,0 +1,44 @@
+#pragma once
+#include "Order.hpp"
+#include <cstdint>
+#include <vector>
+
+// What is kept of an order once it has filled or been cancelled
+struct OrderRecord
+{
+    int orderId; // 0 in an empty slot
+    SymbolId symbolId;
+    OrderStatus status; // FILLED or CANCELLED
+    OrderSide side;
+    Quantity filledQuantity; // lots
+    double averagePrice;     // of the fills, 0 with none
+};
+
+// Final states of the most recent order ids, in a table indexed by id. An
+// order's record lives in slot (id / stride) mod window, so ids handed out
+// in sequence get consecutive slots and a record is evicted once the id
+// `window` places later finishes. Records are also dropped from lookups as
+// soon as their id falls out of the window, whether or not the slot has
+// been reused. Memory is fixed at window records.
+class OrderHistory
+{
+public:
+    static constexpr size_t kDefaultWindow = 1 << 16;
+
+    explicit OrderHistory(size_t window = kDefaultWindow);
+
+    // A record older than the one in its slot is not kept
+    void add(const OrderRecord &record, int stride);
+    // nextOrderId is the next id the sequence will hand out
+    const OrderRecord *find(int orderId, int nextOrderId, int stride) const;
+
+    size_t getWindow() const { return records_.size(); }
+
+private:
+    size_t slot(int orderId, int stride) const
+    {
+        return static_cast<size_t>(orderId / stride) % records_.size();
+    }
+
+    std::vector<OrderRecord> records_;
+};
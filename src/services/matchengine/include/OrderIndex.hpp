@@ -0,0 +1,55 @@
+#pragma once
+#include "OrderPool.hpp"
+#include <cstdint>
+#include <vector>
+
+// Live order ids to pool slots, in one open-addressing table with linear
+// probing. The table is sized once for the pool it indexes and kept at
+// most half full, so lookups are a probe or two and it never rehashes or
+// allocates. Erasing shifts later entries of the run back instead of
+// leaving tombstones.
+class OrderIndex
+{
+public:
+    // Room for maxOrders live orders
+    explicit OrderIndex(size_t maxOrders);
+
+    OrderHandle find(int orderId) const
+    {
+        for (size_t slot = home(orderId);; slot = (slot + 1) & mask_)
+        {
+            const Entry &entry = entries_[slot];
+            if (entry.orderId == orderId || entry.handle == kInvalidOrderHandle)
+            {
+                return entry.handle;
+            }
+        }
+    }
+
+    // The id must not already be present
+    void insert(int orderId, OrderHandle handle);
+    // Does nothing for ids not present
+    void erase(int orderId);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    struct Entry
+    {
+        int orderId;
+        OrderHandle handle; // kInvalidOrderHandle when the entry is free
+    };
+
+    // Order ids are mostly consecutive, or spaced by the stride of a shared
+    // sequence; a multiplicative hash spreads both over the table
+    size_t home(int orderId) const
+    {
+        return static_cast<size_t>((static_cast<std::uint32_t>(orderId) * 0x9E3779B1u) >> shift_) & mask_;
+    }
+
+    std::vector<Entry> entries_;
+    size_t mask_;
+    int shift_;
+    size_t size_ = 0;
+};
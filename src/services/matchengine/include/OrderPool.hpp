@@ -0,0 +1,66 @@
+#pragma once
+#include "Order.hpp"
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Small integer handle to an order slot; stays valid until the slot is released
+using OrderHandle = std::uint32_t;
+constexpr OrderHandle kInvalidOrderHandle = UINT32_MAX;
+
+struct OrderPoolStats
+{
+    size_t capacity;
+    size_t inUse;
+    size_t highWaterMark;
+    size_t allocationFailures;
+};
+
+// Fixed-capacity order storage. All slots are reserved up front, so
+// allocating and releasing orders never touches the global allocator and
+// slot addresses never move.
+class OrderPool
+{
+public:
+    explicit OrderPool(size_t capacity);
+
+    // Constructs an order in a free slot; returns kInvalidOrderHandle when the
+    // pool is exhausted
+    template <typename... Args>
+    OrderHandle allocate(Args &&...args);
+    void release(OrderHandle handle);
+
+    Order *get(OrderHandle handle) { return &*slots_[handle]; }
+    const Order *get(OrderHandle handle) const { return &*slots_[handle]; }
+
+    size_t capacity() const { return slots_.size(); }
+    size_t inUse() const { return slots_.size() - freeList_.size(); }
+    OrderPoolStats getStats() const;
+
+private:
+    std::vector<std::optional<Order>> slots_;
+    std::vector<OrderHandle> freeList_;
+    size_t highWaterMark_;
+    size_t allocationFailures_;
+};
+
+template <typename... Args>
+OrderHandle OrderPool::allocate(Args &&...args)
+{
+    if (freeList_.empty())
+    {
+        ++allocationFailures_;
+        return kInvalidOrderHandle;
+    }
+
+    OrderHandle handle = freeList_.back();
+    slots_[handle].emplace(std::forward<Args>(args)...);
+    freeList_.pop_back();
+
+    if (inUse() > highWaterMark_)
+    {
+        highWaterMark_ = inUse();
+    }
+    return handle;
+}
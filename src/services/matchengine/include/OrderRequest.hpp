@@ -0,0 +1,24 @@
+#pragma once
+#include "ExecutionListener.hpp"
+
+// One order as received from a gateway; quantity and prices are in shares
+// and currency and are converted to lots and ticks by the engine. Market
+// and stop orders leave price at zero.
+struct OrderRequest
+{
+    int traderId;
+    SymbolId symbolId;
+    double quantity;
+    double price;
+    OrderSide side;
+    OrderType type = OrderType::LIMIT;
+    double stopPrice = 0.0; // STOP and STOP_LIMIT only
+};
+
+// Outcome of one submit or cancel. A rejected submit has no order id.
+struct OrderResult
+{
+    int orderId;
+    bool accepted;
+    RejectReason reason; // when not accepted
+};
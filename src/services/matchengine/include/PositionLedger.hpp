@@ -0,0 +1,123 @@
+#pragma once
+#include "Instrument.hpp"
+#include <cstdint>
+#include <vector>
+
+// One symbol's holding. Quantity is negative when short, and the money
+// fields carry the same sign. Cost basis is what the open shares cost;
+// market value prices them at the last mark, which every fill moves to the
+// fill price.
+struct Position
+{
+    SymbolId symbolId;
+    std::int64_t quantity; // shares
+    double averagePrice;
+    double marketPrice;
+    double unrealizedPnL;
+    Cash costBasis;
+    Cash marketValue;
+    Cash realizedPnL; // kept after the position goes flat
+
+    Position(SymbolId symbolId = kInvalidSymbolId, std::int64_t qty = 0, double avgPrice = 0.0)
+        : symbolId(symbolId), quantity(qty), averagePrice(avgPrice), marketPrice(avgPrice), unrealizedPnL(0.0),
+          costBasis(toCash(static_cast<double>(qty) * avgPrice)), marketValue(costBasis), realizedPnL(0) {}
+};
+
+// A trader's positions in one contiguous array, found through a table
+// indexed by SymbolId. Portfolio totals are kept up to date as fills and
+// marks change single positions, so reading them never walks the ledger.
+// Iteration visits open positions in the order their symbols were first
+// traded.
+class PositionLedger
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator(const Position *position, const Position *end) : position_(position), end_(end) { skipFlat(); }
+
+        const Position &operator*() const { return *position_; }
+        const Position *operator->() const { return position_; }
+        const_iterator &operator++()
+        {
+            ++position_;
+            skipFlat();
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return position_ == other.position_; }
+
+    private:
+        void skipFlat()
+        {
+            while (position_ != end_ && position_->quantity == 0)
+            {
+                ++position_;
+            }
+        }
+
+        const Position *position_;
+        const Position *end_;
+    };
+
+    const_iterator begin() const { return {positions_.data(), positions_.data() + positions_.size()}; }
+    const_iterator end() const { return {positions_.data() + positions_.size(), positions_.data() + positions_.size()}; }
+    size_t size() const { return openCount_; } // open positions
+    bool empty() const { return openCount_ == 0; }
+    // Every symbol ever traded, flat positions included
+    const std::vector<Position> &all() const { return positions_; }
+
+    // The symbol's open position, or nullptr when flat
+    const Position *find(SymbolId symbolId) const
+    {
+        const Position *position = slot(symbolId);
+        return position && position->quantity != 0 ? position : nullptr;
+    }
+    std::int64_t getShares(SymbolId symbolId) const
+    {
+        const Position *position = slot(symbolId);
+        return position ? position->quantity : 0;
+    }
+
+    // Books a fill of shares, negative for a sale, that cost or raised cost
+    // in total. Shares that close out the position realize P&L against its
+    // average cost; the rest open or add to it.
+    void applyFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price);
+    // Reprices a position; ignored for symbols never traded
+    void mark(SymbolId symbolId, double marketPrice);
+    // Replaces the ledger, for state read back from a snapshot. Quantity,
+    // cost basis, realized P&L and market price are taken as given; the
+    // other fields are derived from them.
+    void restore(const std::vector<Position> &positions);
+
+    // Totals over every position
+    Cash getCostBasis() const { return costBasis_; }
+    Cash getNetExposure() const { return marketValue_; }
+    Cash getGrossExposure() const { return grossExposure_; }
+    Cash getRealizedPnL() const { return realizedPnL_; }
+    Cash getUnrealizedPnL() const { return marketValue_ - costBasis_; }
+
+private:
+    static constexpr std::uint32_t kNoSlot = 0xFFFFFFFF;
+
+    const Position *slot(SymbolId symbolId) const
+    {
+        return symbolId < slots_.size() && slots_[symbolId] != kNoSlot ? &positions_[slots_[symbolId]] : nullptr;
+    }
+    Position *slot(SymbolId symbolId)
+    {
+        return symbolId < slots_.size() && slots_[symbolId] != kNoSlot ? &positions_[slots_[symbolId]] : nullptr;
+    }
+    Position &open(SymbolId symbolId);
+    // Take a position's share of the totals out before changing it and put
+    // it back afterwards
+    void remove(const Position &position);
+    void add(const Position &position);
+
+    std::vector<std::uint32_t> slots_; // by SymbolId
+    std::vector<Position> positions_;
+    size_t openCount_ = 0;
+    Cash costBasis_ = 0;
+    Cash marketValue_ = 0;
+    Cash grossExposure_ = 0;
+    Cash realizedPnL_ = 0;
+};
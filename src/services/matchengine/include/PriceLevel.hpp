@@ -0,0 +1,68 @@
+#pragma once
+#include "Order.hpp"
+#include <cstddef>
+
+// All resting orders at one price, kept as an intrusive FIFO linked through
+// the orders themselves so that linking and unlinking never allocates. Each
+// linked order points back at its level, so it can be found from the order.
+struct PriceLevel
+{
+    Price price;
+    Quantity totalQuantity;
+    size_t orderCount;
+    Order *head;
+    Order *tail;
+
+    explicit PriceLevel(Price price = 0)
+        : price(price), totalQuantity(0), orderCount(0), head(nullptr), tail(nullptr) {}
+
+    bool empty() const { return head == nullptr; }
+
+    // Appends at the tail. Orders reach a level in time priority; a stop
+    // is restamped when it activates, so it queues by activation time.
+    void insert(Order *order)
+    {
+        order->prev_ = tail;
+        order->next_ = nullptr;
+        if (tail)
+        {
+            tail->next_ = order;
+        }
+        else
+        {
+            head = order;
+        }
+        tail = order;
+        order->level_ = this;
+
+        totalQuantity += order->getRemainingQuantity();
+        ++orderCount;
+    }
+
+    // Unlinks an order in O(1); its remaining quantity is taken off the level.
+    void erase(Order *order)
+    {
+        if (order->prev_)
+        {
+            order->prev_->next_ = order->next_;
+        }
+        else
+        {
+            head = order->next_;
+        }
+        if (order->next_)
+        {
+            order->next_->prev_ = order->prev_;
+        }
+        else
+        {
+            tail = order->prev_;
+        }
+        order->prev_ = nullptr;
+        order->next_ = nullptr;
+        order->level_ = nullptr;
+
+        totalQuantity -= order->getRemainingQuantity();
+        --orderCount;
+    }
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include "Trader.hpp"
+#include <cstdint>
+#include <vector>
+
+// What a trader's open orders have set aside. Balances stay in the Trader;
+// available cash and shares are its balances less these reservations.
+struct RiskAccount
+{
+    Trader *trader = nullptr;
+    Cash reservedCash = 0;
+    std::vector<std::int64_t> reservedShares; // by SymbolId, grown on demand
+
+    Cash getAvailableCash() const { return trader->getCashUnits() - reservedCash; }
+    std::int64_t getReservedShares(SymbolId symbolId) const
+    {
+        return symbolId < reservedShares.size() ? reservedShares[symbolId] : 0;
+    }
+    std::int64_t getAvailableShares(SymbolId symbolId) const
+    {
+        return trader->getShares(symbolId) - getReservedShares(symbolId);
+    }
+
+    void reserveShares(SymbolId symbolId, std::int64_t shares)
+    {
+        if (symbolId >= reservedShares.size())
+        {
+            reservedShares.resize(symbolId + 1, 0);
+        }
+        reservedShares[symbolId] += shares;
+    }
+    void releaseShares(SymbolId symbolId, std::int64_t shares) { reservedShares[symbolId] -= shares; }
+};
+
+// Risk accounts indexed directly by trader id, so a pre-trade check is one
+// array access rather than a map lookup
+class RiskAccounts
+{
+public:
+    // Trader ids index the table, so they must be small
+    static constexpr int kMaxTraderId = 1 << 20;
+
+    // Opens the trader's account, or points an existing one at a new Trader
+    // object keeping its reservations. Throws std::invalid_argument if the
+    // id is negative or above kMaxTraderId.
+    void add(Trader *trader);
+
+    RiskAccount *find(int traderId)
+    {
+        auto index = static_cast<size_t>(traderId);
+        return index < accounts_.size() && accounts_[index].trader ? &accounts_[index] : nullptr;
+    }
+    const RiskAccount *find(int traderId) const
+    {
+        auto index = static_cast<size_t>(traderId);
+        return index < accounts_.size() && accounts_[index].trader ? &accounts_[index] : nullptr;
+    }
+
+private:
+    std::vector<RiskAccount> accounts_;
+};
@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// One writer publishes a small value that any number of readers copy out
+// without locks. The sequence is odd while a write is in progress; a reader
+// that sees it change across its copy throws the copy away. Writers never
+// wait for readers, and a reader only retries when a write overlapped its
+// copy. The value is held as atomic words so that the racing copies are
+// well defined.
+template <typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(std::uint64_t) == 0,
+                  "Seqlock values are trivially copyable whole words");
+
+public:
+    explicit Seqlock(const T &value = T{})
+    {
+        std::uint64_t words[kWords];
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    // Single writer only
+    void store(const T &value)
+    {
+        std::uint64_t words[kWords];
+        std::memcpy(words, &value, sizeof(T));
+        std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    // One attempt, wait-free: false if a write overlapped the copy
+    bool tryLoad(T &value) const
+    {
+        std::uint64_t sequence = sequence_.load(std::memory_order_acquire);
+        if (sequence & 1)
+        {
+            return false;
+        }
+        std::uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i)
+        {
+            words[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != sequence)
+        {
+            return false;
+        }
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    // Retries until a copy completes without a write overlapping it
+    T load() const
+    {
+        T value;
+        while (!tryLoad(value))
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+        return value;
+    }
+
+    // Completed writes so far
+    std::uint64_t getVersion() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = sizeof(T) / sizeof(std::uint64_t);
+
+    // The sequence and the words share a line on purpose, so a read touches
+    // one line for a value that fits. Aligning the sequence rounds the whole
+    // seqlock up to whole lines, so readers polling it do not slow the
+    // writer's neighbouring fields.
+    alignas(64) std::atomic<std::uint64_t> sequence_{0};
+    std::array<std::atomic<std::uint64_t>, kWords> words_{};
+};
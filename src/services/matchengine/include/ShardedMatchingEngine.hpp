@@ -0,0 +1,112 @@
+#pragma once
+#include "ConcurrentQueue.hpp"
+#include "MatchingEngine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+enum class ShardRequestType : std::uint8_t
+{
+    SUBMIT,
+    CANCEL
+};
+
+struct ShardRequest
+{
+    std::uint64_t tag; // caller's correlation id, echoed in the result
+    ShardRequestType type;
+    int traderId;
+    SymbolId symbolId;
+    double quantity;
+    double price;
+    OrderSide side;
+    OrderType orderType;
+    double stopPrice; // STOP and STOP_LIMIT only
+    int orderId;      // cancels only
+};
+
+enum class ShardResultStatus : std::uint8_t
+{
+    ACCEPTED,
+    REJECTED,
+    CANCELLED,
+    CANCEL_REJECTED
+};
+
+struct ShardResult
+{
+    std::uint64_t tag;
+    ShardResultStatus status;
+    RejectReason reason; // REJECTED only
+    int orderId;         // 0 when rejected
+};
+
+// Matching engine split into shards, each a MatchingEngine owned by one
+// matcher thread. A symbol always lives on shard symbolId % shardCount, so
+// books are only ever touched by their shard's thread.
+//
+// Requests go to the owning shard through a lock-free MPSC queue and may be
+// sent from any number of threads. Each shard answers every request through
+// its own SPSC queue, drained by a single consumer with pollResults.
+//
+// Trader accounts are partitioned: every shard keeps its own Trader with the
+// cash given at registration, and positions in a symbol live on the shard
+// that trades it.
+class ShardedMatchingEngine
+{
+public:
+    static constexpr size_t kDefaultQueueCapacity = 1 << 14;
+
+    explicit ShardedMatchingEngine(size_t shardCount,
+                                   size_t orderPoolCapacity = MatchingEngine::kDefaultOrderPoolCapacity,
+                                   size_t queueCapacity = kDefaultQueueCapacity);
+    ~ShardedMatchingEngine();
+
+    ShardedMatchingEngine(const ShardedMatchingEngine &) = delete;
+    ShardedMatchingEngine &operator=(const ShardedMatchingEngine &) = delete;
+
+    // Setup; only while stopped
+    void registerTrader(int traderId, const std::string &name, double cashPerShard);
+    void defineInstrument(const Instrument &instrument);
+
+    // Starts the matcher threads. stop() lets each shard finish its queue
+    // before joining; results nobody polls by then are discarded.
+    void start();
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    // Any thread; false when the owning shard's queue is full
+    bool submitOrder(std::uint64_t tag, int traderId, SymbolId symbolId, double quantity,
+                     double price, OrderSide side, OrderType type = OrderType::LIMIT, double stopPrice = 0.0);
+    bool cancelOrder(std::uint64_t tag, int orderId);
+
+    // Single consumer; copies up to maxResults results and returns how many
+    size_t pollResults(ShardResult *results, size_t maxResults);
+
+    size_t getShardCount() const { return shards_.size(); }
+    size_t getShardIndex(SymbolId symbolId) const { return symbolId % shards_.size(); }
+
+    // Shard state; only while stopped
+    MatchingEngine &getShardEngine(size_t shard) { return shards_[shard]->engine; }
+    std::shared_ptr<Trader> getTrader(int traderId, SymbolId symbolId) const;
+
+private:
+    struct Shard
+    {
+        Shard(size_t orderPoolCapacity, size_t queueCapacity);
+
+        MatchingEngine engine;
+        MpscQueue<ShardRequest> requests;
+        SpscQueue<ShardResult> results;
+        std::thread thread;
+    };
+
+    void run(Shard &shard);
+    ShardResult process(Shard &shard, const ShardRequest &request);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> running_;
+    size_t nextPollShard_; // consumer only
+};
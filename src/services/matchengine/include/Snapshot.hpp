@@ -0,0 +1,187 @@
+#pragma once
+#include "Instrument.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Point-in-time engine snapshot. The file is a header followed by arrays of
+// fixed-size records and a blob of names, all 8-byte aligned, so a loader
+// can map it and read the records in place. Prices are ticks, quantities
+// lots and cash 1/kCashScale units.
+
+constexpr char kSnapshotFileMagic[8] = {'M', 'E', 'S', 'N', 'A', 'P', '\0', '3'};
+
+// A name in the blob
+struct SnapshotName
+{
+    std::uint64_t offset;
+    std::uint64_t length;
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    std::uint64_t fileSize;
+    std::uint64_t journalSequence; // last journal record the snapshot includes
+    std::int64_t nextOrderId;
+    std::int64_t orderIdStride;
+    std::uint64_t bookCount;
+    std::uint64_t orderCount;
+    std::uint64_t traderCount;
+    std::uint64_t positionCount;
+    std::uint64_t bookOffset;
+    std::uint64_t orderOffset;
+    std::uint64_t traderOffset;
+    std::uint64_t positionOffset;
+    std::uint64_t nameOffset;
+    std::uint64_t nameSize;
+};
+
+// One book with its instrument and session statistics; its orders are
+// orderCount consecutive records from firstOrder, in the priority order of
+// OrderBook::collectOrders
+struct SnapshotBook
+{
+    SnapshotName symbol;
+    std::int64_t priceScale;
+    std::int64_t tickSize;
+    std::int64_t lotSize;
+    std::int64_t maxLots;
+    std::int64_t maxTicks;
+    std::uint64_t tradeCount;
+    std::int64_t volume;
+    std::int64_t notional;
+    std::int64_t open;
+    std::int64_t high;
+    std::int64_t low;
+    std::int64_t last;
+    std::uint64_t firstOrder;
+    std::uint64_t orderCount;
+};
+
+struct SnapshotOrder
+{
+    std::int32_t orderId;
+    std::int32_t traderId;
+    std::int64_t quantity;
+    std::int64_t filledQuantity;
+    std::int64_t price;
+    std::int64_t stopPrice;
+    std::uint8_t side;      // OrderSide
+    std::uint8_t type;      // OrderType
+    std::uint8_t triggered; // a stop that has been activated
+    std::uint8_t reserved[5];
+};
+
+struct SnapshotTrader
+{
+    SnapshotName name;
+    std::int64_t traderId;
+    std::int64_t cash;
+    std::uint64_t firstPosition;
+    std::uint64_t positionCount;
+};
+
+// Flat positions are kept while they carry realized P&L
+struct SnapshotPosition
+{
+    SnapshotName symbol;
+    std::int64_t quantity; // shares
+    std::int64_t costBasis;
+    std::int64_t realizedPnL;
+    double marketPrice; // last mark
+};
+
+// Builds a snapshot image in memory; add each book's or trader's entries
+// right after it
+class SnapshotBuilder
+{
+public:
+    void addBook(const SnapshotBook &book, std::string_view symbol);
+    void addOrder(const SnapshotOrder &order);
+    void addTrader(const SnapshotTrader &trader, std::string_view name);
+    void addPosition(const SnapshotPosition &position, std::string_view symbol);
+
+    // Lays out the file; the header's counts and offsets are filled in
+    std::vector<char> finish(SnapshotHeader header);
+
+private:
+    SnapshotName addName(std::string_view name);
+
+    std::vector<SnapshotBook> books_;
+    std::vector<SnapshotOrder> orders_;
+    std::vector<SnapshotTrader> traders_;
+    std::vector<SnapshotPosition> positions_;
+    std::string names_;
+};
+
+// Read-only mapping of a snapshot file. Throws std::runtime_error if the
+// file cannot be mapped or is not a complete snapshot.
+class SnapshotFile
+{
+public:
+    explicit SnapshotFile(const std::string &path);
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile &) = delete;
+    SnapshotFile &operator=(const SnapshotFile &) = delete;
+
+    const SnapshotHeader &header() const { return *header_; }
+    std::span<const SnapshotBook> books() const;
+    std::span<const SnapshotOrder> orders() const;
+    std::span<const SnapshotTrader> traders() const;
+    std::span<const SnapshotPosition> positions() const;
+    std::string_view name(const SnapshotName &name) const;
+
+private:
+    template <typename T>
+    std::span<const T> section(std::uint64_t offset, std::uint64_t count) const;
+
+    const char *data_;
+    size_t size_;
+    const SnapshotHeader *header_;
+};
+
+// Writes snapshot images on a background thread. Each goes to a temporary
+// file that is synced and then renamed over the target, so the target is
+// always a complete snapshot.
+class SnapshotWriter
+{
+public:
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    void write(const std::string &path, std::vector<char> image);
+
+    // Waits for every snapshot queued so far; throws std::runtime_error if
+    // one could not be written
+    void flush();
+    std::uint64_t getWrittenCount() const;
+
+private:
+    struct Job
+    {
+        std::string path;
+        std::vector<char> image;
+    };
+
+    void run();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable done_;
+    std::vector<Job> jobs_;
+    std::uint64_t queued_ = 0;
+    std::uint64_t written_ = 0;
+    std::uint64_t failed_ = 0;
+    bool stopping_ = false;
+    std::thread thread_;
+};
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Dense integer id for a symbol; ids are assigned in order of first use
+using SymbolId = std::uint32_t;
+constexpr SymbolId kInvalidSymbolId = UINT32_MAX;
+
+// Process-wide symbol table. Orders, trades, books and positions carry the
+// SymbolId; the name is only resolved when printing or exporting.
+class SymbolRegistry
+{
+public:
+    static SymbolRegistry &instance();
+
+    SymbolId intern(const std::string &symbol);
+    SymbolId find(const std::string &symbol) const;
+    const std::string &name(SymbolId id) const;
+    size_t size() const;
+
+private:
+    SymbolRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, SymbolId> ids_;
+    std::deque<std::string> names_; // deque keeps returned names stable
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "Instrument.hpp"
+#include <chrono>
+#include <type_traits>
+
+// Fixed-layout trade record; trivially copyable so trade history can be kept
+// in a ring and written to disk as raw records
+struct Trade
+{
+    int buyOrderId;
+    int sellOrderId;
+    int buyTraderId;
+    int sellTraderId;
+    SymbolId symbolId;
+    Quantity quantity; // lots
+    Price price;       // ticks
+    std::chrono::steady_clock::time_point timestamp;
+
+    Trade() = default;
+    Trade(int buyOrderId, int sellOrderId, int buyTraderId, int sellTraderId,
+          SymbolId symbolId, Quantity quantity, Price price)
+        : buyOrderId(buyOrderId), sellOrderId(sellOrderId),
+          buyTraderId(buyTraderId), sellTraderId(sellTraderId),
+          symbolId(symbolId), quantity(quantity), price(price),
+          timestamp(std::chrono::steady_clock::now()) {}
+};
+
+static_assert(std::is_trivially_copyable<Trade>::value, "Trade must stay a plain record");
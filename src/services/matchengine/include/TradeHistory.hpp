@@ -0,0 +1,114 @@
+#pragma once
+#include "Trade.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Bounded trade history for one book. The newest trades stay in a
+// fixed-capacity ring that never allocates after construction. When spilling
+// is enabled every record is also appended to a binary file by a background
+// writer, and a ring slot is only reused once its record is on disk.
+//
+// Trades are numbered from zero in the order they were appended. Appends and
+// reads happen on the matcher thread; only flushPending runs on the writer.
+//
+// A failed write stops spilling for good: later records stay in the ring
+// only, and append no longer waits for the writer.
+class TradeHistory
+{
+public:
+    static constexpr size_t kDefaultCapacity = 1 << 16;
+
+    // Capacity is rounded up to a power of two
+    explicit TradeHistory(size_t capacity = kDefaultCapacity);
+
+    void append(const Trade &trade);
+
+    // Trades still in memory, oldest first
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    const Trade &operator[](size_t index) const { return at(getFirstInMemory() + index); }
+    const Trade &back() const { return at(getTotalCount() - 1); }
+    size_t getCapacity() const { return ring_.size(); }
+
+    std::uint64_t getTotalCount() const { return head_.load(std::memory_order_relaxed); }
+    std::uint64_t getFirstInMemory() const;
+    std::uint64_t getFirstAvailable() const;
+    const Trade &at(std::uint64_t sequence) const;
+
+    // Spilling; records from the current first in-memory trade onwards go to
+    // a new append-only file of raw Trade records
+    void spillTo(const std::string &path);
+    bool isSpilling() const { return !path_.empty(); }
+    const std::string &getSpillPath() const { return path_; }
+    std::uint64_t getSpilledCount() const { return spilled_.load(std::memory_order_acquire); }
+    std::uint64_t getSpillStalls() const { return stalls_; }
+    bool hasSpillFailed() const { return spillFailed_.load(std::memory_order_acquire); }
+
+    // Writer side: appends every record not yet on disk; returns how many,
+    // 0 once a write has failed
+    size_t flushPending();
+
+    // Sequential reader over [sequence, getTotalCount()). Records that have
+    // left the ring are read back from the spill file.
+    class Cursor
+    {
+    public:
+        bool next(Trade &trade);
+        std::uint64_t position() const { return next_; }
+
+    private:
+        friend class TradeHistory;
+        Cursor(const TradeHistory &history, std::uint64_t from);
+
+        const TradeHistory *history_;
+        std::uint64_t next_;
+        std::ifstream file_;
+    };
+    Cursor readFrom(std::uint64_t sequence) const;
+
+private:
+    std::vector<Trade> ring_;
+    std::uint64_t mask_;
+    std::atomic<std::uint64_t> head_;    // next sequence to append
+    std::atomic<std::uint64_t> spilled_; // sequences below this are on disk
+    std::atomic<bool> spillFailed_;
+    std::uint64_t stalls_;
+
+    std::string path_;
+    std::uint64_t fileBase_; // sequence of the first record in the file
+    std::ofstream out_;      // writer thread only
+};
+
+// Background thread that drains the rings of any number of spilling
+// histories into their files
+class TradeSpillWriter
+{
+public:
+    explicit TradeSpillWriter(std::chrono::milliseconds idleInterval = std::chrono::milliseconds(1));
+    ~TradeSpillWriter();
+
+    TradeSpillWriter(const TradeSpillWriter &) = delete;
+    TradeSpillWriter &operator=(const TradeSpillWriter &) = delete;
+
+    void add(TradeHistory &history);
+    // Writes everything appended so far; throws std::runtime_error if a
+    // history's spill has failed
+    void flush();
+
+private:
+    void run();
+
+    std::chrono::milliseconds idleInterval_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::vector<TradeHistory *> histories_;
+    bool stopping_;
+    std::thread thread_;
+};
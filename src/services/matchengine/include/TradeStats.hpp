@@ -0,0 +1,66 @@
+#pragma once
+#include "Instrument.hpp"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// One time bucket of trading activity
+struct OhlcvBar
+{
+    std::chrono::steady_clock::time_point start;
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+    Quantity volume;
+    size_t tradeCount;
+};
+
+// Running trade statistics for one book, updated once per trade from the
+// match loop so every query is O(1) regardless of history length. Bars are
+// kept in a fixed-size ring; buckets without trades produce no bar.
+class TradeStats
+{
+public:
+    static constexpr std::chrono::nanoseconds kDefaultBarInterval = std::chrono::seconds(1);
+    static constexpr size_t kDefaultBarCount = 300;
+
+    explicit TradeStats(std::chrono::nanoseconds barInterval = kDefaultBarInterval,
+                        size_t barCount = kDefaultBarCount);
+
+    void onTrade(Price price, Quantity quantity, std::chrono::steady_clock::time_point timestamp);
+
+    // Session totals from a snapshot; bars start empty
+    void restoreTotals(size_t tradeCount, Quantity volume, std::int64_t notional,
+                       Price open, Price high, Price low, Price last);
+
+    // Session totals; prices are zero until the first trade
+    Quantity getVolume() const { return volume_; }
+    std::int64_t getNotional() const { return notional_; } // ticks x lots
+    double getVwap() const;                                 // ticks
+    Price getOpen() const { return open_; }
+    Price getHigh() const { return high_; }
+    Price getLow() const { return low_; }
+    Price getLast() const { return last_; }
+    size_t getTradeCount() const { return tradeCount_; }
+
+    // Bars, newest first: getBar(0) is the bucket of the most recent trade
+    std::chrono::nanoseconds getBarInterval() const { return barInterval_; }
+    size_t getBarCapacity() const { return bars_.size(); }
+    size_t getBarCount() const { return barCount_; }
+    const OhlcvBar &getBar(size_t barsAgo) const;
+
+private:
+    Quantity volume_;
+    std::int64_t notional_;
+    Price open_;
+    Price high_;
+    Price low_;
+    Price last_;
+    size_t tradeCount_;
+
+    std::chrono::nanoseconds barInterval_;
+    std::vector<OhlcvBar> bars_;
+    size_t newestBar_;
+    size_t barCount_;
+};
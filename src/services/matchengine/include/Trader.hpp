@@ -1,20 +1,10 @@
 #pragma once
+#include "Instrument.hpp"
+#include "PositionLedger.hpp"
 #include <string>
-#include <map>
 #include <vector>
 #include <memory>
 
-struct Position
-{
-    std::string symbol;
-    double quantity;
-    double averagePrice;
-    double unrealizedPnL;
-
-    Position(const std::string &sym = "", double qty = 0.0, double avgPrice = 0.0)
-        : symbol(sym), quantity(qty), averagePrice(avgPrice), unrealizedPnL(0.0) {}
-};
-
 class Trader
 {
 public:
@@ -23,28 +13,47 @@ public:
     // Getters
     int getTraderId() const { return traderId_; }
     const std::string &getName() const { return name_; }
-    double getCash() const { return cash_; }
-    double getPortfolioValue() const;
-    const std::map<std::string, Position> &getPositions() const { return positions_; }
+    double getCash() const { return fromCash(cash_); }
+    Cash getCashUnits() const { return cash_; }
+    // Cash plus open positions at cost
+    double getPortfolioValue() const { return fromCash(cash_ + positions_.getCostBasis()); }
+    const PositionLedger &getPositions() const { return positions_; }
 
     // Portfolio management
     void addCash(double amount);
-    bool hasSufficientCash(double amount) const { return cash_ >= amount; }
-    bool hasSufficientShares(const std::string &symbol, double quantity) const;
-
-    // Trade execution callbacks
-    void onOrderFilled(const std::string &symbol, double quantity, double price, bool isBuy);
+    // Replaces cash and positions with state read back from a snapshot
+    void restore(Cash cash, const std::vector<Position> &positions);
+    bool hasSufficientCash(Cash amount) const { return cash_ >= amount; }
+    bool hasSufficientShares(SymbolId symbolId, std::int64_t shares) const;
+    bool hasSufficientShares(const std::string &symbol, std::int64_t shares) const;
+    std::int64_t getShares(SymbolId symbolId) const { return positions_.getShares(symbolId); }
+
+    // Trade execution callbacks; the engine reports fills in instrument units.
+    // A fill the trader cannot pay for or deliver is refused: nothing
+    // changes and the call returns false.
+    bool onOrderFilled(const Instrument &instrument, Quantity lots, Price price, bool isBuy);
+    bool onOrderFilled(const std::string &symbol, double quantity, double price, bool isBuy);
+    // Engine settlement of a fill whose cash or shares were reserved when
+    // the order was accepted; applies the fill without checks and never throws
+    void settle(const Instrument &instrument, Quantity lots, Price price, bool isBuy);
+    // Marks a position to the market price
+    void updatePosition(SymbolId symbolId, double marketPrice) { positions_.mark(symbolId, marketPrice); }
     void updatePosition(const std::string &symbol, double marketPrice);
 
-    // Portfolio reporting
+    // Portfolio reporting; totals are kept up to date by fills and marks
     void printPortfolio() const;
-    double getTotalPnL() const;
+    double getRealizedPnL() const { return fromCash(positions_.getRealizedPnL()); }
+    double getUnrealizedPnL() const { return fromCash(positions_.getUnrealizedPnL()); }
+    double getTotalPnL() const { return fromCash(positions_.getRealizedPnL() + positions_.getUnrealizedPnL()); }
+    double getGrossExposure() const { return fromCash(positions_.getGrossExposure()); }
+    double getNetExposure() const { return fromCash(positions_.getNetExposure()); }
 
 private:
     int traderId_;
     std::string name_;
-    double cash_;
-    std::map<std::string, Position> positions_;
+    Cash cash_;
+    PositionLedger positions_;
 
-    void updatePositionOnTrade(const std::string &symbol, double quantity, double price);
+    bool applyFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price, bool isBuy);
+    void bookFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price, bool isBuy);
 };
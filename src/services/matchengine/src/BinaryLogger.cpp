@@ -0,0 +1,255 @@
+#include "../include/BinaryLogger.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+BinaryLogger::BinaryLogger(const std::string &path, LogLevel level, size_t capacity,
+                           std::chrono::milliseconds idleInterval)
+    : queue_(capacity), dropped_(0), written_(0), level_(level), stopping_(false),
+      path_(path), idleInterval_(idleInterval)
+{
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_)
+    {
+        throw std::runtime_error("Cannot open log file: " + path);
+    }
+    std::uint32_t recordSize = sizeof(LogRecord);
+    out_.write(kLogFileMagic, sizeof(kLogFileMagic));
+    out_.write(reinterpret_cast<const char *>(&recordSize), sizeof(recordSize));
+
+    thread_ = std::thread(&BinaryLogger::run, this);
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+
+    // Whatever raced the shutdown, then the counters as the last record
+    drain();
+    write(LogRecord{now(), LogEvent::LOG_STATS, LogLevel::INFO, 0, kInvalidSymbolId,
+                    {static_cast<std::int64_t>(getLoggedCount()),
+                     static_cast<std::int64_t>(getDroppedCount())}});
+    out_.flush();
+}
+
+std::int64_t BinaryLogger::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+void BinaryLogger::push(const LogRecord &record)
+{
+    if (!queue_.tryPush(record))
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t BinaryLogger::drain()
+{
+    size_t count = 0;
+    LogRecord record;
+    while (queue_.tryPop(record))
+    {
+        write(record);
+        ++count;
+    }
+    if (count > 0)
+    {
+        out_.flush();
+        written_.fetch_add(count, std::memory_order_release);
+    }
+    return count;
+}
+
+void BinaryLogger::write(const LogRecord &record)
+{
+    // Name each symbol once, ahead of its first record, so the file can be
+    // decoded by another process
+    if (record.symbolId != kInvalidSymbolId)
+    {
+        if (record.symbolId >= namedSymbols_.size())
+        {
+            namedSymbols_.resize(record.symbolId + 1);
+        }
+        if (!namedSymbols_[record.symbolId])
+        {
+            namedSymbols_[record.symbolId] = true;
+            LogRecord name{record.timestamp, LogEvent::SYMBOL, LogLevel::INFO, 0, record.symbolId, {}};
+            const std::string &symbol = SymbolRegistry::instance().name(record.symbolId);
+            std::memcpy(name.args, symbol.data(), std::min(symbol.size(), sizeof(name.args)));
+            out_.write(reinterpret_cast<const char *>(&name), sizeof(name));
+        }
+    }
+    out_.write(reinterpret_cast<const char *>(&record), sizeof(record));
+}
+
+void BinaryLogger::run()
+{
+    while (!stopping_.load(std::memory_order_acquire))
+    {
+        if (drain() == 0)
+        {
+            std::this_thread::sleep_for(idleInterval_);
+        }
+    }
+}
+
+void BinaryLogger::flush()
+{
+    // Dropped records were never pushed, so every pushed one gets written
+    std::uint64_t target = getLoggedCount();
+    while (getWrittenCount() < target)
+    {
+        std::this_thread::yield();
+    }
+}
+
+const char *LogDecoder::levelName(LogLevel level)
+{
+    switch (level)
+    {
+    case LogLevel::DEBUG:
+        return "DEBUG";
+    case LogLevel::INFO:
+        return "INFO";
+    case LogLevel::WARN:
+        return "WARN";
+    case LogLevel::ERROR:
+        return "ERROR";
+    }
+    return "?";
+}
+
+const char *LogDecoder::eventName(LogEvent event)
+{
+    switch (event)
+    {
+    case LogEvent::SYMBOL:
+        return "SYMBOL";
+    case LogEvent::INSTRUMENT:
+        return "INSTRUMENT";
+    case LogEvent::ORDER_ACCEPTED:
+        return "ACCEPTED";
+    case LogEvent::ORDER_REJECTED:
+        return "REJECTED";
+    case LogEvent::ORDER_PARTIALLY_FILLED:
+        return "PARTIAL";
+    case LogEvent::ORDER_FILLED:
+        return "FILLED";
+    case LogEvent::ORDER_CANCELLED:
+        return "CANCELLED";
+    case LogEvent::TRADE:
+        return "TRADE";
+    case LogEvent::LOG_STATS:
+        return "STATS";
+    }
+    return "?";
+}
+
+size_t LogDecoder::decode(std::istream &in, std::ostream &out)
+{
+    char magic[sizeof(kLogFileMagic)];
+    std::uint32_t recordSize = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&recordSize), sizeof(recordSize));
+    if (!in || std::memcmp(magic, kLogFileMagic, sizeof(magic)) != 0 || recordSize != sizeof(LogRecord))
+    {
+        throw std::runtime_error("Not a matchengine binary log");
+    }
+
+    size_t count = 0;
+    LogRecord record;
+    while (in.read(reinterpret_cast<char *>(&record), sizeof(record)))
+    {
+        if (record.event == LogEvent::SYMBOL)
+        {
+            const char *chars = reinterpret_cast<const char *>(record.args);
+            names_[record.symbolId] = std::string(chars, strnlen(chars, sizeof(record.args)));
+            continue;
+        }
+        format(record, out);
+        ++count;
+    }
+    return count;
+}
+
+void LogDecoder::format(const LogRecord &record, std::ostream &out)
+{
+    const std::int64_t *a = record.args;
+    auto name = names_.find(record.symbolId);
+    const char *side = (record.flags & kLogFlagSell) ? "SELL" : "BUY";
+
+    out << record.timestamp << ' ' << levelName(record.level) << ' ' << eventName(record.event);
+    if (name != names_.end())
+    {
+        out << ' ' << name->second;
+    }
+
+    switch (record.event)
+    {
+    case LogEvent::INSTRUMENT:
+        scales_[record.symbolId] = Scale{static_cast<int>(a[0]), a[1], a[2]};
+        out << " | Scale: " << a[0] << " | Tick: " << a[1] << " | Lot: " << a[2];
+        break;
+    case LogEvent::ORDER_ACCEPTED:
+        out << " | Order: " << a[0] << " | Trader: " << a[1] << " | " << side
+            << " | Qty: " << shares(record.symbolId, a[2])
+            << " | Price: $" << price(record.symbolId, a[3]);
+        break;
+    case LogEvent::ORDER_REJECTED:
+        out << " | Trader: " << a[0] << " | " << side << " | Reason: " << a[1];
+        break;
+    case LogEvent::ORDER_PARTIALLY_FILLED:
+    case LogEvent::ORDER_FILLED:
+        out << " | Order: " << a[0] << " | Trader: " << a[1] << " | " << side
+            << " | Qty: " << shares(record.symbolId, a[2])
+            << " | Price: $" << price(record.symbolId, a[3])
+            << " | Left: " << shares(record.symbolId, a[4])
+            << ((record.flags & kLogFlagAggressor) ? " | Aggressor" : "");
+        break;
+    case LogEvent::ORDER_CANCELLED:
+        out << " | Order: " << a[0] << " | Trader: " << a[1] << " | " << side
+            << " | Qty: " << shares(record.symbolId, a[2]);
+        break;
+    case LogEvent::TRADE:
+        out << " | Qty: " << shares(record.symbolId, a[4])
+            << " | Price: $" << price(record.symbolId, a[5])
+            << " | Buyer: " << a[2] << " | Seller: " << a[3]
+            << " | Orders: " << a[0] << "/" << a[1];
+        break;
+    case LogEvent::LOG_STATS:
+        out << " | Logged: " << a[0] << " | Dropped: " << a[1];
+        break;
+    case LogEvent::SYMBOL:
+        break;
+    }
+    out << '\n';
+}
+
+std::string LogDecoder::price(SymbolId symbolId, std::int64_t ticks) const
+{
+    auto it = scales_.find(symbolId);
+    Scale scale = (it != scales_.end()) ? it->second : Scale();
+
+    std::int64_t factor = 1;
+    for (int i = 0; i < scale.priceScale; ++i)
+    {
+        factor *= 10;
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(scale.priceScale)
+         << static_cast<double>(ticks * scale.tickSize) / factor;
+    return text.str();
+}
+
+std::int64_t LogDecoder::shares(SymbolId symbolId, std::int64_t lots) const
+{
+    auto it = scales_.find(symbolId);
+    return lots * ((it != scales_.end()) ? it->second.lotSize : 1);
+}
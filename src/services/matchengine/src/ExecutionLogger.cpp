@@ -0,0 +1,47 @@
+#include "../include/ExecutionLogger.hpp"
+
+static std::uint8_t sideFlag(OrderSide side)
+{
+    return side == OrderSide::SELL ? kLogFlagSell : 0;
+}
+
+void ExecutionLogger::onOrderAccepted(const OrderAcceptedEvent &event)
+{
+    logger_.log<LogLevel::DEBUG>(LogEvent::ORDER_ACCEPTED, event.symbolId, sideFlag(event.side),
+                                 event.orderId, event.traderId, event.quantity, event.price);
+}
+
+void ExecutionLogger::onOrderRejected(const OrderRejectedEvent &event)
+{
+    logger_.log<LogLevel::WARN>(LogEvent::ORDER_REJECTED, event.symbolId, sideFlag(event.side),
+                                event.traderId, static_cast<std::int64_t>(event.reason));
+}
+
+void ExecutionLogger::onOrderPartiallyFilled(const OrderFillEvent &event)
+{
+    logger_.log<LogLevel::DEBUG>(LogEvent::ORDER_PARTIALLY_FILLED, event.symbolId,
+                                 sideFlag(event.side) | (event.aggressor ? kLogFlagAggressor : 0),
+                                 event.orderId, event.traderId, event.fillQuantity, event.fillPrice,
+                                 event.remainingQuantity);
+}
+
+void ExecutionLogger::onOrderFilled(const OrderFillEvent &event)
+{
+    logger_.log<LogLevel::DEBUG>(LogEvent::ORDER_FILLED, event.symbolId,
+                                 sideFlag(event.side) | (event.aggressor ? kLogFlagAggressor : 0),
+                                 event.orderId, event.traderId, event.fillQuantity, event.fillPrice,
+                                 event.remainingQuantity);
+}
+
+void ExecutionLogger::onOrderCancelled(const OrderCancelledEvent &event)
+{
+    logger_.log<LogLevel::DEBUG>(LogEvent::ORDER_CANCELLED, event.symbolId, sideFlag(event.side),
+                                 event.orderId, event.traderId, event.cancelledQuantity);
+}
+
+void ExecutionLogger::onTrade(const Trade &trade)
+{
+    logger_.log<LogLevel::INFO>(LogEvent::TRADE, trade.symbolId, 0,
+                                trade.buyOrderId, trade.sellOrderId, trade.buyTraderId,
+                                trade.sellTraderId, trade.quantity, trade.price);
+}
@@ -0,0 +1,313 @@
+#include "../include/Journal.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Longest symbol name a reader accepts; anything longer is corruption
+static constexpr std::uint32_t kMaxSymbolLength = 1024;
+
+static std::uint32_t checksum(const JournalRecord &record, const char *name, size_t nameLength)
+{
+    JournalRecord copy = record;
+    copy.checksum = 0;
+
+    std::uint32_t hash = 2166136261u;
+    auto mix = [&hash](const char *bytes, size_t length)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 16777619u;
+        }
+    };
+    mix(reinterpret_cast<const char *>(&copy), sizeof(copy));
+    mix(name, nameLength);
+    return hash;
+}
+
+static bool writeAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = ::write(fd, data, length);
+        if (written < 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+Journal::Journal(const std::string &path, const JournalConfig &config, std::uint64_t nextSequence)
+    : path_(path), config_(config), queue_(config.capacity), nextSequence_(nextSequence),
+      durable_(nextSequence - 1)
+{
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd_ < 0)
+    {
+        throw std::runtime_error("Cannot open journal: " + path);
+    }
+
+    struct stat info;
+    char magic[sizeof(kJournalFileMagic)] = {};
+    std::uint32_t recordSize = sizeof(JournalRecord);
+    bool ok = ::fstat(fd_, &info) == 0;
+    if (ok && info.st_size == 0)
+    {
+        ok = writeAll(fd_, kJournalFileMagic, sizeof(kJournalFileMagic)) &&
+             writeAll(fd_, reinterpret_cast<const char *>(&recordSize), sizeof(recordSize));
+    }
+    else if (ok)
+    {
+        ok = ::pread(fd_, magic, sizeof(magic), 0) == sizeof(magic) &&
+             std::memcmp(magic, kJournalFileMagic, sizeof(magic)) == 0;
+    }
+    if (!ok)
+    {
+        ::close(fd_);
+        throw std::runtime_error("Not a matchengine journal: " + path);
+    }
+
+    thread_ = std::thread(&Journal::run, this);
+}
+
+Journal::~Journal()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_.store(true, std::memory_order_release);
+    }
+    wakeup_.notify_one();
+    thread_.join();
+    ::close(fd_);
+}
+
+std::uint64_t Journal::appendSubmit(const OrderRequest &request, int orderId)
+{
+    if (request.symbolId >= namedSymbols_.size() || !namedSymbols_[request.symbolId])
+    {
+        if (request.symbolId >= namedSymbols_.size())
+        {
+            namedSymbols_.resize(request.symbolId + 1);
+        }
+        namedSymbols_[request.symbolId] = true;
+
+        JournalRecord symbol{};
+        symbol.type = JournalRecordType::SYMBOL;
+        symbol.symbolId = request.symbolId;
+        append(symbol);
+    }
+
+    JournalRecord record{};
+    record.type = JournalRecordType::SUBMIT;
+    record.side = static_cast<std::uint8_t>(request.side);
+    record.orderType = static_cast<std::uint8_t>(request.type);
+    record.symbolId = request.symbolId;
+    record.traderId = request.traderId;
+    record.orderId = orderId;
+    record.quantity = request.quantity;
+    record.price = request.price;
+    record.stopPrice = request.stopPrice;
+    return append(record);
+}
+
+std::uint64_t Journal::appendCancel(int orderId)
+{
+    JournalRecord record{};
+    record.type = JournalRecordType::CANCEL;
+    record.symbolId = kInvalidSymbolId;
+    record.orderId = orderId;
+    return append(record);
+}
+
+std::uint64_t Journal::append(JournalRecord &record)
+{
+    // The writer fills in the symbol name and the checksum
+    record.sequence = nextSequence_++;
+    if (!queue_.tryPush(record))
+    {
+        // The writer has fallen a whole ring behind; it keeps draining even
+        // after a failed write, so this always ends
+        ++stalls_;
+        while (!queue_.tryPush(record))
+        {
+            std::this_thread::yield();
+        }
+    }
+    return record.sequence;
+}
+
+void Journal::commit()
+{
+    std::uint64_t target = nextSequence_ - 1;
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (commitRequested_.load(std::memory_order_relaxed) < target)
+    {
+        commitRequested_.store(target, std::memory_order_release);
+    }
+    wakeup_.notify_one();
+    committed_.wait(lock, [this, target]()
+    {
+        return getDurableSequence() >= target || failed_.load(std::memory_order_acquire);
+    });
+    if (failed_.load(std::memory_order_acquire))
+    {
+        throw std::runtime_error("Cannot write journal: " + path_);
+    }
+}
+
+void Journal::encode(std::vector<char> &group, JournalRecord &record)
+{
+    const std::string *name = nullptr;
+    if (record.type == JournalRecordType::SYMBOL)
+    {
+        name = &SymbolRegistry::instance().name(record.symbolId);
+    }
+    record.nameLength = name ? static_cast<std::uint32_t>(name->size()) : 0;
+    record.checksum = checksum(record, name ? name->data() : nullptr, record.nameLength);
+
+    const char *bytes = reinterpret_cast<const char *>(&record);
+    group.insert(group.end(), bytes, bytes + sizeof(record));
+    if (name)
+    {
+        group.insert(group.end(), name->begin(), name->end());
+    }
+}
+
+void Journal::run()
+{
+    std::vector<char> group;
+    size_t records = 0;
+    std::uint64_t last = 0;
+    std::chrono::steady_clock::time_point started;
+    for (;;)
+    {
+        // Whatever was appended before stopping was seen is drained below
+        bool stopping = stopping_.load(std::memory_order_acquire);
+        JournalRecord record;
+        while (records < config_.groupSize && queue_.tryPop(record))
+        {
+            if (records == 0)
+            {
+                started = std::chrono::steady_clock::now();
+            }
+            encode(group, record);
+            last = record.sequence;
+            ++records;
+        }
+
+        // Write the group once it is full, a commit asks for it, or its
+        // first record has waited maxDelay
+        std::chrono::microseconds wait = config_.pollInterval;
+        if (records > 0)
+        {
+            auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started);
+            if (records >= config_.groupSize || stopping || commitPending() || waited >= config_.maxDelay)
+            {
+                writeGroup(group, last);
+                group.clear();
+                records = 0;
+                continue;
+            }
+            wait = std::min(wait, config_.maxDelay - waited);
+        }
+        else if (stopping)
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait_for(lock, wait, [this]()
+        {
+            return commitPending() || stopping_.load(std::memory_order_relaxed);
+        });
+    }
+}
+
+void Journal::writeGroup(const std::vector<char> &group, std::uint64_t last)
+{
+    // Nothing after a failed group can be durable, so later ones are dropped
+    bool ok = !failed_.load(std::memory_order_relaxed) && writeAll(fd_, group.data(), group.size()) &&
+              (!config_.sync || ::fdatasync(fd_) == 0);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok)
+    {
+        durable_.store(last, std::memory_order_release);
+        groups_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        failed_.store(true, std::memory_order_release);
+    }
+    committed_.notify_all();
+}
+
+JournalReader::JournalReader(const std::string &path) : in_(path, std::ios::binary)
+{
+    if (!in_)
+    {
+        throw std::runtime_error("Cannot open journal: " + path);
+    }
+
+    char magic[sizeof(kJournalFileMagic)];
+    std::uint32_t recordSize = 0;
+    in_.read(magic, sizeof(magic));
+    in_.read(reinterpret_cast<char *>(&recordSize), sizeof(recordSize));
+    if (!in_ || std::memcmp(magic, kJournalFileMagic, sizeof(magic)) != 0 || recordSize != sizeof(JournalRecord))
+    {
+        throw std::runtime_error("Not a matchengine journal: " + path);
+    }
+    validSize_ = sizeof(magic) + sizeof(recordSize);
+}
+
+bool JournalReader::next(JournalRecord &record)
+{
+    std::string name;
+    while (in_.read(reinterpret_cast<char *>(&record), sizeof(record)))
+    {
+        name.clear();
+        if (record.type == JournalRecordType::SYMBOL && record.nameLength <= kMaxSymbolLength)
+        {
+            name.resize(record.nameLength);
+            in_.read(name.data(), record.nameLength);
+        }
+
+        bool inSequence = lastSequence_ == 0 || record.sequence == lastSequence_ + 1;
+        if (!in_ || !inSequence || record.checksum != checksum(record, name.data(), name.size()) ||
+            record.type > JournalRecordType::CANCEL || (record.type == JournalRecordType::SYMBOL && name.empty()))
+        {
+            break;
+        }
+
+        if (record.type == JournalRecordType::SYMBOL)
+        {
+            symbols_[record.symbolId] = SymbolRegistry::instance().intern(name);
+        }
+        else if (record.type == JournalRecordType::SUBMIT)
+        {
+            auto it = symbols_.find(record.symbolId);
+            if (it == symbols_.end())
+            {
+                break;
+            }
+            record.symbolId = it->second;
+        }
+        lastSequence_ = record.sequence;
+        validSize_ += sizeof(record) + name.size();
+
+        if (record.type != JournalRecordType::SYMBOL)
+        {
+            return true;
+        }
+    }
+
+    // Torn or corrupt: everything after this point is ignored
+    in_.setstate(std::ios::failbit);
+    return false;
+}
@@ -0,0 +1,151 @@
+#include "../include/LatencyProfiler.hpp"
+#include <bit>
+#include <iomanip>
+#include <iterator>
+#include <thread>
+#include <utility>
+
+double cyclesPerNanosecond()
+{
+    static const double rate = []()
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t startCycles = readCycles();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        std::uint64_t cycles = readCycles() - startCycles;
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return elapsed > 0 ? static_cast<double>(cycles) / elapsed : 1.0;
+    }();
+    return rate;
+}
+
+size_t LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+    constexpr std::uint64_t kLinear = std::uint64_t(2) << kSubBucketBits;
+    if (value < kLinear)
+    {
+        return static_cast<size_t>(value);
+    }
+    // The top kSubBucketBits + 1 bits pick the bucket within a power of two
+    int shift = std::bit_width(value) - (kSubBucketBits + 1);
+    return (static_cast<size_t>(shift) << kSubBucketBits) + static_cast<size_t>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::bucketLimit(size_t bucket)
+{
+    constexpr size_t kLinear = size_t(2) << kSubBucketBits;
+    if (bucket < kLinear)
+    {
+        return bucket;
+    }
+    int shift = static_cast<int>(bucket >> kSubBucketBits) - 1;
+    std::uint64_t mantissa = bucket - (static_cast<size_t>(shift) << kSubBucketBits);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyProfiler::setEnabled(bool enabled)
+{
+    if (!kLatencyProfilingCompiled)
+    {
+        return;
+    }
+    if (enabled && !histograms_)
+    {
+        histograms_ = std::make_unique<std::array<LatencyHistogram, kLatencyStageCount>>();
+    }
+    enabled_.store(enabled, std::memory_order_release);
+}
+
+std::vector<LatencySummary> LatencyProfiler::snapshot(bool reset)
+{
+    std::lock_guard<std::mutex> lock(readMutex_);
+    if (baseline_.empty())
+    {
+        baseline_.assign(kLatencyStageCount, Counts(LatencyHistogram::kBucketCount, 0));
+    }
+
+    double rate = cyclesPerNanosecond();
+    std::vector<LatencySummary> summaries;
+    Counts counts(LatencyHistogram::kBucketCount);
+    for (size_t stage = 0; stage < kLatencyStageCount; ++stage)
+    {
+        LatencySummary summary{static_cast<LatencyStage>(stage), 0, 0.0, 0.0, 0.0, 0.0};
+        if (histograms_)
+        {
+            const LatencyHistogram &histogram = (*histograms_)[stage];
+            for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+            {
+                counts[bucket] = histogram.getCount(bucket) - baseline_[stage][bucket];
+                summary.count += counts[bucket];
+            }
+
+            // Walk the buckets once, filling each percentile as it is passed
+            std::uint64_t seen = 0;
+            std::pair<double, double *> targets[] = {
+                {0.5, &summary.p50}, {0.99, &summary.p99}, {0.999, &summary.p999}, {1.0, &summary.max}};
+            size_t next = 0;
+            for (size_t bucket = 0; bucket < counts.size() && next < std::size(targets); ++bucket)
+            {
+                seen += counts[bucket];
+                while (next < std::size(targets) && counts[bucket] > 0 &&
+                       static_cast<double>(seen) >= targets[next].first * static_cast<double>(summary.count))
+                {
+                    *targets[next].second = static_cast<double>(LatencyHistogram::bucketLimit(bucket)) / rate;
+                    ++next;
+                }
+            }
+            if (reset)
+            {
+                for (size_t bucket = 0; bucket < counts.size(); ++bucket)
+                {
+                    baseline_[stage][bucket] += counts[bucket];
+                }
+            }
+        }
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+void LatencyProfiler::print(std::ostream &out)
+{
+    out << std::fixed << std::setprecision(0)
+        << std::setw(12) << "Stage" << std::setw(12) << "Count" << std::setw(10) << "p50 ns"
+        << std::setw(10) << "p99 ns" << std::setw(10) << "p99.9 ns" << std::setw(10) << "max ns" << '\n';
+    for (const LatencySummary &summary : snapshot())
+    {
+        if (summary.count == 0)
+        {
+            continue;
+        }
+        out << std::setw(12) << stageName(summary.stage) << std::setw(12) << summary.count
+            << std::setw(10) << summary.p50 << std::setw(10) << summary.p99
+            << std::setw(10) << summary.p999 << std::setw(10) << summary.max << '\n';
+    }
+}
+
+const char *LatencyProfiler::stageName(LatencyStage stage)
+{
+    switch (stage)
+    {
+    case LatencyStage::BOOK_LOOKUP:
+        return "BOOK_LOOKUP";
+    case LatencyStage::VALIDATE:
+        return "VALIDATE";
+    case LatencyStage::CREATE:
+        return "CREATE";
+    case LatencyStage::MATCH:
+        return "MATCH";
+    case LatencyStage::SETTLE:
+        return "SETTLE";
+    case LatencyStage::RELEASE:
+        return "RELEASE";
+    case LatencyStage::PUBLISH:
+        return "PUBLISH";
+    case LatencyStage::TOTAL:
+        return "TOTAL";
+    case LatencyStage::COUNT:
+        break;
+    }
+    return "?";
+}
@@ -0,0 +1,364 @@
+#include "../include/MarkToMarket.hpp"
+#include "../include/RiskAccounts.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// marketValue[i] = quantity[i] * price; returns the sum of marketValue -
+// costBasis. Plain integer arithmetic, which compilers vectorize.
+static Cash revalueColumn(const std::int64_t *quantity, const Cash *costBasis, Cash *marketValue, size_t count,
+                          Cash price)
+{
+    Cash sum = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        marketValue[i] = quantity[i] * price;
+        sum += marketValue[i] - costBasis[i];
+    }
+    return sum;
+}
+
+MarkToMarket::MarkToMarket(unsigned threads, size_t parallelThreshold) : parallelThreshold_(parallelThreshold)
+{
+    for (unsigned worker = 1; worker < threads; ++worker)
+    {
+        workers_.emplace_back(&MarkToMarket::runWorker, this, worker);
+    }
+}
+
+MarkToMarket::~MarkToMarket()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void MarkToMarket::addTrader(Trader &trader)
+{
+    int traderId = trader.getTraderId();
+    if (traderId < 0 || traderId > RiskAccounts::kMaxTraderId)
+    {
+        throw std::invalid_argument("Trader id out of range");
+    }
+
+    std::uint32_t row = findRow(traderId);
+    if (row != kNoRow)
+    {
+        eraseRow(row);
+    }
+    else
+    {
+        if (!freeRows_.empty())
+        {
+            row = freeRows_.back();
+            freeRows_.pop_back();
+        }
+        else
+        {
+            row = static_cast<std::uint32_t>(rows_.size());
+            rows_.emplace_back();
+            traderPnL_.push_back(0);
+        }
+        if (static_cast<size_t>(traderId) >= rowOf_.size())
+        {
+            rowOf_.resize(static_cast<size_t>(traderId) + 1, kNoRow);
+        }
+        rowOf_[static_cast<size_t>(traderId)] = row;
+        ++traderCount_;
+    }
+
+    rows_[row].trader = &trader;
+    for (const Position &position : trader.getPositions())
+    {
+        insert(row, position);
+    }
+}
+
+void MarkToMarket::removeTrader(int traderId)
+{
+    std::uint32_t row = findRow(traderId);
+    if (row == kNoRow)
+    {
+        return;
+    }
+    eraseRow(row);
+    rows_[row].trader = nullptr;
+    rowOf_[static_cast<size_t>(traderId)] = kNoRow;
+    freeRows_.push_back(row);
+    --traderCount_;
+}
+
+void MarkToMarket::updatePosition(int traderId, SymbolId symbolId)
+{
+    std::uint32_t row = findRow(traderId);
+    if (row == kNoRow)
+    {
+        return;
+    }
+    if (Entry *entry = findEntry(rows_[row], symbolId))
+    {
+        erase(row, *entry);
+    }
+    if (const Position *position = rows_[row].trader->getPositions().find(symbolId))
+    {
+        insert(row, *position);
+    }
+}
+
+void MarkToMarket::clear()
+{
+    columns_.clear();
+    rows_.clear();
+    traderPnL_.clear();
+    rowOf_.clear();
+    freeRows_.clear();
+    traderCount_ = 0;
+    positionCount_ = 0;
+}
+
+void MarkToMarket::onOrderPartiallyFilled(const OrderFillEvent &event)
+{
+    updatePosition(event.traderId, event.symbolId);
+}
+
+void MarkToMarket::onOrderFilled(const OrderFillEvent &event)
+{
+    updatePosition(event.traderId, event.symbolId);
+}
+
+MarkToMarket::Entry *MarkToMarket::findEntry(Row &row, SymbolId symbolId)
+{
+    for (Entry &entry : row.entries)
+    {
+        if (entry.symbolId == symbolId)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void MarkToMarket::insert(std::uint32_t row, const Position &position)
+{
+    if (position.symbolId >= columns_.size())
+    {
+        columns_.resize(static_cast<size_t>(position.symbolId) + 1);
+    }
+    Column &column = columns_[position.symbolId];
+
+    // A column that has been revalued marks new positions at its price, and
+    // the ledger catches up at the next applyMarks
+    Cash marketValue = position.marketValue;
+    if (column.priced)
+    {
+        marketValue = position.quantity * toCash(column.price);
+        column.marked = true;
+    }
+
+    rows_[row].entries.push_back(Entry{position.symbolId, static_cast<std::uint32_t>(column.rows.size())});
+    column.rows.push_back(row);
+    column.quantity.push_back(position.quantity);
+    column.costBasis.push_back(position.costBasis);
+    column.marketValue.push_back(marketValue);
+    column.pnl += marketValue - position.costBasis;
+    traderPnL_[row] += marketValue - position.costBasis;
+    ++positionCount_;
+}
+
+void MarkToMarket::erase(std::uint32_t row, Entry &entry)
+{
+    SymbolId symbolId = entry.symbolId;
+    size_t index = entry.index;
+    Column &column = columns_[symbolId];
+    Cash pnl = column.marketValue[index] - column.costBasis[index];
+    column.pnl -= pnl;
+    traderPnL_[row] -= pnl;
+
+    // Move the column's last position into the gap
+    size_t last = column.rows.size() - 1;
+    if (index != last)
+    {
+        column.rows[index] = column.rows[last];
+        column.quantity[index] = column.quantity[last];
+        column.costBasis[index] = column.costBasis[last];
+        column.marketValue[index] = column.marketValue[last];
+        findEntry(rows_[column.rows[index]], symbolId)->index = static_cast<std::uint32_t>(index);
+    }
+    column.rows.pop_back();
+    column.quantity.pop_back();
+    column.costBasis.pop_back();
+    column.marketValue.pop_back();
+
+    std::vector<Entry> &entries = rows_[row].entries;
+    entry = entries.back();
+    entries.pop_back();
+    --positionCount_;
+}
+
+void MarkToMarket::eraseRow(std::uint32_t row)
+{
+    while (!rows_[row].entries.empty())
+    {
+        erase(row, rows_[row].entries.back());
+    }
+}
+
+void MarkToMarket::revalue(SymbolId symbolId, double price)
+{
+    if (symbolId >= columns_.size())
+    {
+        return;
+    }
+    Column &column = columns_[symbolId];
+    size_t count = column.rows.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        traderPnL_[column.rows[i]] -= column.marketValue[i] - column.costBasis[i];
+    }
+    column.pnl = revalueColumn(column.quantity.data(), column.costBasis.data(), column.marketValue.data(), count,
+                               toCash(price));
+    column.price = price;
+    column.priced = true;
+    column.marked = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        traderPnL_[column.rows[i]] += column.marketValue[i] - column.costBasis[i];
+    }
+}
+
+void MarkToMarket::revalue(const std::vector<double> &prices)
+{
+    size_t threads = workers_.size() + 1;
+    if (threads == 1 || positionCount_ < parallelThreshold_)
+    {
+        std::fill(traderPnL_.begin(), traderPnL_.end(), 0);
+        revalueRange(prices, 0, columns_.size(), traderPnL_.data());
+        return;
+    }
+
+    // Give each thread a run of columns holding about the same number of
+    // positions, and its own row totals to add into
+    bounds_.assign(1, 0);
+    size_t share = (positionCount_ + threads - 1) / threads;
+    size_t seen = 0;
+    for (size_t symbolId = 0; symbolId < columns_.size() && bounds_.size() < threads; ++symbolId)
+    {
+        seen += columns_[symbolId].rows.size();
+        if (seen >= share * bounds_.size())
+        {
+            bounds_.push_back(symbolId + 1);
+        }
+    }
+    bounds_.resize(threads + 1, columns_.size());
+    partials_.resize(threads);
+    for (std::vector<Cash> &partial : partials_)
+    {
+        partial.assign(traderPnL_.size(), 0);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prices_ = &prices;
+        running_ = workers_.size();
+        ++generation_;
+    }
+    wakeup_.notify_all();
+    revalueRange(prices, bounds_[0], bounds_[1], partials_[0].data());
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return running_ == 0; });
+    }
+
+    std::fill(traderPnL_.begin(), traderPnL_.end(), 0);
+    for (const std::vector<Cash> &partial : partials_)
+    {
+        for (size_t row = 0; row < traderPnL_.size(); ++row)
+        {
+            traderPnL_[row] += partial[row];
+        }
+    }
+}
+
+void MarkToMarket::runWorker(size_t worker)
+{
+    std::uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wakeup_.wait(lock, [this, seen]() { return generation_ != seen || stopping_; });
+        if (stopping_)
+        {
+            return;
+        }
+        seen = generation_;
+        lock.unlock();
+
+        revalueRange(*prices_, bounds_[worker], bounds_[worker + 1], partials_[worker].data());
+
+        lock.lock();
+        if (--running_ == 0)
+        {
+            done_.notify_one();
+        }
+    }
+}
+
+void MarkToMarket::revalueRange(const std::vector<double> &prices, size_t first, size_t last, Cash *traderPnL)
+{
+    for (size_t symbolId = first; symbolId < last; ++symbolId)
+    {
+        Column &column = columns_[symbolId];
+        size_t count = column.rows.size();
+        if (symbolId < prices.size() && !std::isnan(prices[symbolId]))
+        {
+            column.pnl = revalueColumn(column.quantity.data(), column.costBasis.data(), column.marketValue.data(),
+                                       count, toCash(prices[symbolId]));
+            column.price = prices[symbolId];
+            column.priced = true;
+            column.marked = true;
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            traderPnL[column.rows[i]] += column.marketValue[i] - column.costBasis[i];
+        }
+    }
+}
+
+void MarkToMarket::applyMarks()
+{
+    for (size_t symbolId = 0; symbolId < columns_.size(); ++symbolId)
+    {
+        Column &column = columns_[symbolId];
+        if (!column.marked)
+        {
+            continue;
+        }
+        column.marked = false;
+        for (std::uint32_t row : column.rows)
+        {
+            rows_[row].trader->updatePosition(static_cast<SymbolId>(symbolId), column.price);
+        }
+    }
+}
+
+Cash MarkToMarket::getUnrealizedPnL(int traderId) const
+{
+    std::uint32_t row = findRow(traderId);
+    return row == kNoRow ? 0 : traderPnL_[row];
+}
+
+Cash MarkToMarket::getTotalPnL() const
+{
+    Cash total = 0;
+    for (const Column &column : columns_)
+    {
+        total += column.pnl;
+    }
+    return total;
+}
@@ -0,0 +1,230 @@
+#include "../include/MarketDataFeed.hpp"
+#include "../include/ConcurrentQueue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Sequence fields live in shared memory and are accessed through atomic_ref;
+// readers map the file read-only, and loads do not write
+static std::uint64_t loadAcquire(const std::uint64_t &value)
+{
+    return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t &>(value)).load(std::memory_order_acquire);
+}
+
+static void storeRelease(std::uint64_t &value, std::uint64_t sequence)
+{
+    std::atomic_ref<std::uint64_t>(value).store(sequence, std::memory_order_release);
+}
+
+static std::int64_t feedClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+MarketDataPublisher::MarketDataPublisher(const std::string &path, size_t capacity)
+    : path_(path), mask_(roundUpToPowerOfTwo(std::max<size_t>(capacity, 2)) - 1)
+{
+    mappedSize_ = sizeof(FeedHeader) + (mask_ + 1) * sizeof(FeedMessage);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot create market data feed: " + path);
+    }
+    void *mapped = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(mappedSize_)) == 0)
+    {
+        mapped = ::mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map market data feed: " + path);
+    }
+
+    // A fresh file is all zeros: every slot reads as unpublished
+    header_ = static_cast<FeedHeader *>(mapped);
+    ring_ = reinterpret_cast<FeedMessage *>(header_ + 1);
+    std::memcpy(header_->magic, kFeedFileMagic, sizeof(kFeedFileMagic));
+    header_->messageSize = sizeof(FeedMessage);
+    header_->capacity = mask_ + 1;
+    storeRelease(header_->lastSequence, 0);
+}
+
+MarketDataPublisher::~MarketDataPublisher()
+{
+    ::munmap(header_, mappedSize_);
+}
+
+void MarketDataPublisher::publishInstrument(const Instrument &instrument)
+{
+    FeedMessage &message = claim(FeedMessageType::INSTRUMENT, instrument.symbolId);
+    std::strncpy(reinterpret_cast<char *>(message.fields), instrument.symbol.c_str(), 2 * sizeof(std::int64_t));
+    message.fields[2] = instrument.priceScale;
+    message.fields[3] = instrument.tickSize;
+    message.fields[4] = instrument.lotSize;
+    publish(message);
+}
+
+void MarketDataPublisher::publishTopOfBook(const OrderBook &orderBook)
+{
+    SymbolId symbolId = orderBook.getSymbolId();
+    if (symbolId >= tops_.size())
+    {
+        tops_.resize(symbolId + 1, TopOfBook{0, 0, 0, 0});
+    }
+
+    TopOfBook top = orderBook.getTopOfBook();
+    TopOfBook &last = tops_[symbolId];
+    if (top.bidPrice == last.bidPrice && top.bidQuantity == last.bidQuantity &&
+        top.askPrice == last.askPrice && top.askQuantity == last.askQuantity)
+    {
+        return;
+    }
+    last = top;
+
+    FeedMessage &message = claim(FeedMessageType::TOP_OF_BOOK, symbolId);
+    message.fields[0] = top.bidPrice;
+    message.fields[1] = top.bidQuantity;
+    message.fields[2] = top.askPrice;
+    message.fields[3] = top.askQuantity;
+    publish(message);
+}
+
+void MarketDataPublisher::onTrade(const Trade &trade)
+{
+    FeedMessage &message = claim(FeedMessageType::TRADE, trade.symbolId);
+    message.fields[0] = trade.price;
+    message.fields[1] = trade.quantity;
+    message.fields[2] = trade.buyOrderId;
+    message.fields[3] = trade.sellOrderId;
+    publish(message);
+}
+
+void MarketDataPublisher::onBookUpdate(const BookUpdateEvent &event)
+{
+    FeedMessage &message = claim(FeedMessageType::LEVEL_UPDATE, event.symbolId);
+    message.side = static_cast<std::uint8_t>(event.side);
+    message.action = static_cast<std::uint8_t>(event.action);
+    message.fields[0] = event.price;
+    message.fields[1] = event.quantity;
+    message.fields[2] = event.orderCount;
+    message.fields[3] = static_cast<std::int64_t>(event.sequence);
+    publish(message);
+}
+
+FeedMessage &MarketDataPublisher::claim(FeedMessageType type, SymbolId symbolId)
+{
+    FeedMessage &message = ring_[(sequence_ + 1) & mask_];
+
+    // Readers that copy the slot from here on see a torn message and retry
+    storeRelease(message.sequence, 0);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    message.timestamp = feedClock();
+    message.type = type;
+    message.side = 0;
+    message.action = 0;
+    message.reserved = 0;
+    message.symbolId = symbolId;
+    std::memset(message.fields, 0, sizeof(message.fields));
+    return message;
+}
+
+void MarketDataPublisher::publish(FeedMessage &message)
+{
+    ++sequence_;
+    storeRelease(message.sequence, sequence_);
+    storeRelease(header_->lastSequence, sequence_);
+}
+
+MarketDataReader::MarketDataReader(const std::string &path, bool fromOldest)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open market data feed: " + path);
+    }
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(FeedHeader))
+    {
+        mappedSize_ = static_cast<size_t>(info.st_size);
+        mapped = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Not a matchengine market data feed: " + path);
+    }
+
+    header_ = static_cast<const FeedHeader *>(mapped);
+    ring_ = reinterpret_cast<const FeedMessage *>(header_ + 1);
+    if (std::memcmp(header_->magic, kFeedFileMagic, sizeof(kFeedFileMagic)) != 0 ||
+        header_->messageSize != sizeof(FeedMessage) ||
+        mappedSize_ < sizeof(FeedHeader) + header_->capacity * sizeof(FeedMessage))
+    {
+        ::munmap(const_cast<FeedHeader *>(header_), mappedSize_);
+        throw std::runtime_error("Not a matchengine market data feed: " + path);
+    }
+    mask_ = header_->capacity - 1;
+
+    std::uint64_t last = getLastPublished();
+    if (!fromOldest)
+    {
+        next_ = last + 1;
+    }
+    else
+    {
+        next_ = last > mask_ ? last - mask_ : 1;
+    }
+}
+
+MarketDataReader::~MarketDataReader()
+{
+    ::munmap(const_cast<FeedHeader *>(header_), mappedSize_);
+}
+
+std::uint64_t MarketDataReader::getLastPublished() const
+{
+    return loadAcquire(header_->lastSequence);
+}
+
+bool MarketDataReader::poll(FeedMessage &message)
+{
+    for (;;)
+    {
+        const FeedMessage &slot = ring_[next_ & mask_];
+        if (loadAcquire(slot.sequence) == next_)
+        {
+            std::memcpy(&message, &slot, sizeof(FeedMessage));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (loadAcquire(slot.sequence) == next_)
+            {
+                message.sequence = next_++;
+                return true;
+            }
+        }
+
+        // The slot does not hold our message. Unless the publisher has got a
+        // whole ring ahead, it is still being written: try again later.
+        // Otherwise it was reused; skip to the oldest message still in the
+        // ring.
+        std::uint64_t last = getLastPublished();
+        if (last < next_ + mask_)
+        {
+            return false;
+        }
+        std::uint64_t oldest = std::max(last - mask_, next_ + 1);
+        missed_ += oldest - next_;
+        next_ = oldest;
+    }
+}
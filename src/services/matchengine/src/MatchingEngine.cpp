@@ -2,11 +2,20 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
-MatchingEngine::MatchingEngine() : nextOrderId_(1) {}
+MatchingEngine::MatchingEngine(size_t orderPoolCapacity)
+    : nextOrderId_(1), orderIdStride_(1), orderPool_(orderPoolCapacity), reservedCash_(orderPoolCapacity, 0),
+      filledNotional_(orderPoolCapacity, 0), orders_(orderPoolCapacity)
+{
+}
 
 void MatchingEngine::registerTrader(std::shared_ptr<Trader> trader)
 {
+    accounts_.add(trader.get());
     traders_[trader->getTraderId()] = trader;
 }
 
@@ -16,146 +25,941 @@ std::shared_ptr<Trader> MatchingEngine::getTrader(int traderId) const
     return (it != traders_.end()) ? it->second : nullptr;
 }
 
-int MatchingEngine::submitOrder(int traderId, const std::string &symbol, double quantity,
-                                double price, OrderSide side, OrderType type)
+Trader *MatchingEngine::findTrader(int traderId) const
+{
+    auto it = traders_.find(traderId);
+    return (it != traders_.end()) ? it->second.get() : nullptr;
+}
+
+void MatchingEngine::defineInstrument(const Instrument &instrument)
 {
-    // Validate trader exists
-    auto trader = getTrader(traderId);
-    if (!trader)
+    if (findOrderBook(instrument.symbolId))
     {
-        throw std::invalid_argument("Trader not found");
+        throw std::logic_error("Instrument is already trading");
+    }
+    std::int64_t maxShares;
+    if (instrument.maxLots <= 0 || instrument.maxTicks <= 0 ||
+        __builtin_mul_overflow(instrument.maxLots, instrument.lotSize, &maxShares))
+    {
+        throw std::invalid_argument("Instrument order limits are out of range");
+    }
+    if (instrument.symbolId >= orderBooks_.size())
+    {
+        orderBooks_.resize(instrument.symbolId + 1);
+    }
+    orderBooks_[instrument.symbolId] = std::make_shared<OrderBook>(instrument, bookConfig_);
+    orderBooks_[instrument.symbolId]->setExecutionListener(this);
+    if (spillWriter_)
+    {
+        startSpilling(*orderBooks_[instrument.symbolId]);
+    }
+    if (logger_)
+    {
+        logInstrument(instrument);
+    }
+    if (feed_)
+    {
+        feed_->publishInstrument(instrument);
+    }
+}
+
+void MatchingEngine::configureBars(std::chrono::nanoseconds barInterval, size_t barCount)
+{
+    if (barInterval.count() <= 0 || barCount == 0)
+    {
+        throw std::invalid_argument("Bar interval and bar count must be positive");
+    }
+    bookConfig_.barInterval = barInterval;
+    bookConfig_.barCount = barCount;
+}
+
+void MatchingEngine::configureTradeHistory(size_t capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("Trade history capacity must be positive");
+    }
+    bookConfig_.tradeHistoryCapacity = capacity;
+}
+
+void MatchingEngine::enableTradeSpill(const std::string &directory)
+{
+    if (spillWriter_)
+    {
+        throw std::logic_error("Trade spill is already enabled");
+    }
+    spillDirectory_ = directory;
+    spillWriter_ = std::make_unique<TradeSpillWriter>();
+    for (const auto &orderBook : orderBooks_)
+    {
+        if (orderBook)
+        {
+            startSpilling(*orderBook);
+        }
+    }
+}
+
+void MatchingEngine::flushTradeSpill()
+{
+    if (spillWriter_)
+    {
+        spillWriter_->flush();
+    }
+}
+
+void MatchingEngine::startSpilling(OrderBook &orderBook)
+{
+    TradeHistory &history = orderBook.getTradeHistory();
+    history.spillTo(spillDirectory_ + "/" + orderBook.getSymbol() + ".trades");
+    spillWriter_->add(history);
+}
+
+void MatchingEngine::enableLogging(const std::string &path, LogLevel level)
+{
+    if (logger_)
+    {
+        throw std::logic_error("Logging is already enabled");
+    }
+    logger_ = std::make_unique<BinaryLogger>(path, level);
+    executionLogger_ = std::make_unique<ExecutionLogger>(*logger_);
+    addExecutionListener(executionLogger_.get());
+    for (const auto &orderBook : orderBooks_)
+    {
+        if (orderBook)
+        {
+            logInstrument(orderBook->getInstrument());
+        }
     }
+}
 
-    // Pre-trade validation
-    if (side == OrderSide::BUY)
+void MatchingEngine::enableMarketDataFeed(const std::string &path, size_t capacity)
+{
+    if (feed_)
+    {
+        throw std::logic_error("Market data feed is already enabled");
+    }
+    feed_ = std::make_unique<MarketDataPublisher>(path, capacity);
+    addExecutionListener(feed_.get());
+    for (const auto &orderBook : orderBooks_)
     {
-        double requiredCash = quantity * price;
-        if (!trader->hasSufficientCash(requiredCash))
+        if (orderBook)
         {
-            throw std::runtime_error("Insufficient cash for buy order");
+            feed_->publishInstrument(orderBook->getInstrument());
+            feed_->publishTopOfBook(*orderBook);
         }
     }
+}
+
+size_t MatchingEngine::enableJournal(const std::string &path, const JournalConfig &config)
+{
+    if (journal_)
+    {
+        throw std::logic_error("Journal is already enabled");
+    }
+
+    // Records up to here are already in the state, from a snapshot
+    std::uint64_t restored = journalSequence_;
+    size_t replayed = 0;
+    if (std::filesystem::exists(path))
+    {
+        JournalReader reader(path);
+        JournalRecord record;
+        while (reader.next(record))
+        {
+            if (record.sequence > restored)
+            {
+                replay(record);
+                ++replayed;
+            }
+        }
+        // A journal that stops short of the snapshot would leave a gap in
+        // the sequence, so it is started over
+        std::filesystem::resize_file(path, reader.getLastSequence() >= restored ? reader.getValidSize() : 0);
+    }
+
+    journal_ = std::make_unique<Journal>(path, config, journalSequence_ + 1);
+    return replayed;
+}
+
+void MatchingEngine::replay(const JournalRecord &record)
+{
+    journalSequence_ = record.sequence;
+    bool matched;
+    if (record.type == JournalRecordType::CANCEL)
+    {
+        matched = cancelOrder(record.orderId);
+    }
     else
     {
-        if (!trader->hasSufficientShares(symbol, quantity))
+        OrderRequest request{record.traderId, record.symbolId, record.quantity, record.price,
+                             static_cast<OrderSide>(record.side), static_cast<OrderType>(record.orderType),
+                             record.stopPrice};
+        RiskAccount *account = accounts_.find(request.traderId);
+        OrderResult result = account ? placeOrder(account, getOrCreateOrderBook(request.symbolId), request)
+                                     : reject(request, RejectReason::UNKNOWN_TRADER);
+        matched = result.accepted && result.orderId == record.orderId;
+    }
+
+    // Only accepted inputs are journaled, so anything else means the engine
+    // was not set up as it was when the journal was written
+    if (!matched)
+    {
+        throw std::runtime_error("Journal replay diverged at record " + std::to_string(record.sequence));
+    }
+}
+
+std::uint64_t MatchingEngine::takeSnapshot(const std::string &path)
+{
+    SnapshotBuilder builder;
+    for (const auto &orderBook : orderBooks_)
+    {
+        if (!orderBook)
+        {
+            continue;
+        }
+        const Instrument &instrument = orderBook->getInstrument();
+        const TradeStats &stats = orderBook->getStats();
+        SnapshotBook book{};
+        book.priceScale = instrument.priceScale;
+        book.tickSize = instrument.tickSize;
+        book.lotSize = instrument.lotSize;
+        book.maxLots = instrument.maxLots;
+        book.maxTicks = instrument.maxTicks;
+        book.tradeCount = stats.getTradeCount();
+        book.volume = stats.getVolume();
+        book.notional = stats.getNotional();
+        book.open = stats.getOpen();
+        book.high = stats.getHigh();
+        book.low = stats.getLow();
+        book.last = stats.getLast();
+        builder.addBook(book, instrument.symbol);
+
+        snapshotOrders_.clear();
+        orderBook->collectOrders(snapshotOrders_);
+        for (const Order *order : snapshotOrders_)
+        {
+            SnapshotOrder entry{};
+            entry.orderId = order->getOrderId();
+            entry.traderId = order->getTraderId();
+            entry.quantity = order->getQuantity();
+            entry.filledQuantity = order->getFilledQuantity();
+            entry.price = order->getPrice();
+            entry.stopPrice = order->getStopPrice();
+            entry.side = static_cast<std::uint8_t>(order->getSide());
+            entry.type = static_cast<std::uint8_t>(order->getType());
+            entry.triggered = order->isTriggered();
+            builder.addOrder(entry);
+        }
+    }
+
+    for (const auto &[traderId, trader] : traders_)
+    {
+        builder.addTrader(SnapshotTrader{{}, traderId, trader->getCashUnits(), 0, 0}, trader->getName());
+        for (const Position &position : trader->getPositions().all())
+        {
+            if (position.quantity == 0 && position.realizedPnL == 0)
+            {
+                continue;
+            }
+            builder.addPosition(SnapshotPosition{{}, position.quantity, position.costBasis,
+                                                 position.realizedPnL, position.marketPrice},
+                                SymbolRegistry::instance().name(position.symbolId));
+        }
+    }
+
+    SnapshotHeader header{};
+    header.journalSequence = journalSequence_;
+    header.nextOrderId = nextOrderId_;
+    header.orderIdStride = orderIdStride_;
+    if (!snapshotWriter_)
+    {
+        snapshotWriter_ = std::make_unique<SnapshotWriter>();
+    }
+    snapshotWriter_->write(path, builder.finish(header));
+    return journalSequence_;
+}
+
+void MatchingEngine::enableSnapshots(const std::string &path, size_t everyInputs)
+{
+    if (everyInputs == 0)
+    {
+        throw std::invalid_argument("Snapshot interval must be positive");
+    }
+    snapshotPath_ = path;
+    snapshotInterval_ = everyInputs;
+    inputsSinceSnapshot_ = 0;
+}
+
+void MatchingEngine::flushSnapshots()
+{
+    if (snapshotWriter_)
+    {
+        snapshotWriter_->flush();
+    }
+}
+
+void MatchingEngine::countInput()
+{
+    if (snapshotInterval_ > 0 && ++inputsSinceSnapshot_ >= snapshotInterval_)
+    {
+        inputsSinceSnapshot_ = 0;
+        takeSnapshot(snapshotPath_);
+    }
+}
+
+std::uint64_t MatchingEngine::restoreSnapshot(const std::string &path)
+{
+    if (!orders_.empty() || journal_)
+    {
+        throw std::logic_error("Snapshots restore into an engine with no orders or journal");
+    }
+
+    SnapshotFile snapshot(path);
+    std::span<const SnapshotPosition> positions = snapshot.positions();
+    for (const SnapshotTrader &entry : snapshot.traders())
+    {
+        if (entry.firstPosition > positions.size() || entry.positionCount > positions.size() - entry.firstPosition)
+        {
+            throw std::runtime_error("Snapshot trader positions out of range");
+        }
+        std::vector<Position> traderPositions;
+        for (const SnapshotPosition &position : positions.subspan(entry.firstPosition, entry.positionCount))
+        {
+            SymbolId symbolId = SymbolRegistry::instance().intern(std::string(snapshot.name(position.symbol)));
+            Position &restored = traderPositions.emplace_back(symbolId, position.quantity);
+            restored.costBasis = position.costBasis;
+            restored.realizedPnL = position.realizedPnL;
+            restored.marketPrice = position.marketPrice;
+        }
+
+        int traderId = static_cast<int>(entry.traderId);
+        if (!findTrader(traderId))
+        {
+            registerTrader(std::make_shared<Trader>(traderId, std::string(snapshot.name(entry.name)), 0.0));
+        }
+        findTrader(traderId)->restore(entry.cash, traderPositions);
+    }
+
+    std::span<const SnapshotOrder> orders = snapshot.orders();
+    for (const SnapshotBook &book : snapshot.books())
+    {
+        if (book.firstOrder > orders.size() || book.orderCount > orders.size() - book.firstOrder)
+        {
+            throw std::runtime_error("Snapshot book orders out of range");
+        }
+        std::string symbol(snapshot.name(book.symbol));
+        SymbolId symbolId = SymbolRegistry::instance().intern(symbol);
+        if (!findOrderBook(symbolId))
+        {
+            Instrument instrument(symbol, static_cast<int>(book.priceScale), book.tickSize, book.lotSize);
+            instrument.maxLots = book.maxLots;
+            instrument.maxTicks = book.maxTicks;
+            defineInstrument(instrument);
+        }
+        OrderBook &orderBook = *orderBooks_[symbolId];
+        orderBook.getTradeStats().restoreTotals(book.tradeCount, book.volume, book.notional,
+                                                book.open, book.high, book.low, book.last);
+        orderBook.publishQuote();
+
+        for (const SnapshotOrder &entry : orders.subspan(book.firstOrder, book.orderCount))
+        {
+            OrderHandle handle = orderPool_.allocate(entry.orderId, entry.traderId, symbolId, entry.quantity,
+                                                     entry.price, static_cast<OrderSide>(entry.side),
+                                                     static_cast<OrderType>(entry.type), entry.stopPrice);
+            if (handle == kInvalidOrderHandle)
+            {
+                throw std::runtime_error("Order pool exhausted");
+            }
+            Order *order = orderPool_.get(handle);
+            orders_.insert(entry.orderId, handle);
+            order->restore(entry.filledQuantity, entry.triggered != 0);
+            filledNotional_[handle] = entry.filledQuantity * entry.price;
+            if (RiskAccount *account = accounts_.find(order->getTraderId()))
+            {
+                Price riskTicks = order->getType() == OrderType::STOP ? order->getStopPrice() : order->getPrice();
+                reserve(*account, handle, orderBook.getInstrument(),
+                        orderBook.getInstrument().notional(order->getRemainingQuantity(), riskTicks));
+            }
+            orderBook.restoreOrder(order);
+        }
+        if (feed_)
+        {
+            feed_->publishTopOfBook(orderBook);
+        }
+    }
+
+    const SnapshotHeader &header = snapshot.header();
+    nextOrderId_ = static_cast<int>(header.nextOrderId);
+    orderIdStride_ = static_cast<int>(header.orderIdStride);
+    journalSequence_ = header.journalSequence;
+    return journalSequence_;
+}
+
+void MatchingEngine::logInstrument(const Instrument &instrument)
+{
+    logger_->log<LogLevel::INFO>(LogEvent::INSTRUMENT, instrument.symbolId, 0,
+                                 instrument.priceScale, instrument.tickSize, instrument.lotSize);
+}
+
+void MatchingEngine::setOrderIdSequence(int firstOrderId, int stride)
+{
+    if (firstOrderId <= 0 || stride <= 0)
+    {
+        throw std::invalid_argument("Order id sequence must be positive");
+    }
+    nextOrderId_ = firstOrderId;
+    orderIdStride_ = stride;
+}
+
+void MatchingEngine::addExecutionListener(ExecutionListener *listener)
+{
+    listeners_.push_back(listener);
+}
+
+void MatchingEngine::removeExecutionListener(ExecutionListener *listener)
+{
+    listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+}
+
+const Instrument &MatchingEngine::getInstrument(SymbolId symbolId)
+{
+    return getOrCreateOrderBook(symbolId).getInstrument();
+}
+
+const Instrument &MatchingEngine::getInstrument(const std::string &symbol)
+{
+    return getInstrument(SymbolRegistry::instance().intern(symbol));
+}
+
+int MatchingEngine::submitOrder(int traderId, const std::string &symbol, double quantity,
+                                double price, OrderSide side, OrderType type, double stopPrice)
+{
+    return submitOrder(traderId, SymbolRegistry::instance().intern(symbol), quantity, price, side, type, stopPrice);
+}
+
+int MatchingEngine::submitOrder(int traderId, SymbolId symbolId, double quantity,
+                                double price, OrderSide side, OrderType type, double stopPrice)
+{
+    OrderResult result = submitOrder(OrderRequest{traderId, symbolId, quantity, price, side, type, stopPrice});
+    if (result.accepted)
+    {
+        return result.orderId;
+    }
+
+    switch (result.reason)
+    {
+    case RejectReason::UNKNOWN_TRADER:
+        throw std::invalid_argument("Trader not found");
+    case RejectReason::UNKNOWN_SYMBOL:
+        throw std::invalid_argument("Symbol not found");
+    case RejectReason::INVALID_QUANTITY:
+        throw std::invalid_argument("Quantity is not a whole number of lots or is too large");
+    case RejectReason::INVALID_PRICE:
+        throw std::invalid_argument("Price is not a multiple of the tick size or is too large");
+    case RejectReason::INSUFFICIENT_CASH:
+        throw std::runtime_error("Insufficient cash for buy order");
+    case RejectReason::INSUFFICIENT_SHARES:
+        throw std::runtime_error("Insufficient shares for sell order");
+    case RejectReason::POOL_EXHAUSTED:
+        throw std::runtime_error("Order pool exhausted");
+    case RejectReason::UNKNOWN_ORDER:
+        break;
+    }
+    throw std::logic_error("Unexpected reject reason");
+}
+
+OrderResult MatchingEngine::submitOrder(const OrderRequest &request)
+{
+    bool profiling = profiler_.isEnabled();
+    std::uint64_t start = profiling ? readCycles() : 0;
+    RiskAccount *account = accounts_.find(request.traderId);
+    OrderBook *orderBook = account ? findOrCreateOrderBook(request.symbolId) : nullptr;
+    if (profiling)
+    {
+        profiler_.lap(LatencyStage::BOOK_LOOKUP, start);
+    }
+
+    if (!account)
+    {
+        return reject(request, RejectReason::UNKNOWN_TRADER);
+    }
+    return orderBook ? placeOrder(account, *orderBook, request) : reject(request, RejectReason::UNKNOWN_SYMBOL);
+}
+
+size_t MatchingEngine::submitOrders(std::span<const OrderRequest> requests, std::span<OrderResult> results)
+{
+    if (results.size() < requests.size())
+    {
+        throw std::invalid_argument("Result buffer is smaller than the batch");
+    }
+
+    // Group by book. Keys are (symbol id, position), so sorting them keeps
+    // each book's requests in arrival order without a stable sort.
+    batchOrder_.resize(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        batchOrder_[i] = (static_cast<std::uint64_t>(requests[i].symbolId) << 32) | i;
+    }
+    std::sort(batchOrder_.begin(), batchOrder_.end());
+
+    size_t accepted = 0;
+    OrderBook *orderBook = nullptr;
+    RiskAccount *account = nullptr;
+    for (std::uint64_t key : batchOrder_)
+    {
+        size_t index = static_cast<std::uint32_t>(key);
+        const OrderRequest &request = requests[index];
+        if (!orderBook || orderBook->getSymbolId() != request.symbolId)
+        {
+            orderBook = findOrCreateOrderBook(request.symbolId);
+        }
+        if (!account || account->trader->getTraderId() != request.traderId)
         {
-            throw std::runtime_error("Insufficient shares for sell order");
+            account = accounts_.find(request.traderId);
         }
+
+        results[index] = !account     ? reject(request, RejectReason::UNKNOWN_TRADER)
+                         : !orderBook ? reject(request, RejectReason::UNKNOWN_SYMBOL)
+                                      : placeOrder(account, *orderBook, request);
+        accepted += results[index].accepted;
     }
+    return accepted;
+}
 
-    // Create order
-    int orderId = nextOrderId_++;
-    auto order = std::make_shared<Order>(orderId, traderId, symbol, quantity, price, side, type);
-    orders_[orderId] = order;
+OrderResult MatchingEngine::placeOrder(RiskAccount *account, OrderBook &orderBook, const OrderRequest &request)
+{
+    bool profiling = profiler_.isEnabled();
+    std::uint64_t start = profiling ? readCycles() : 0;
+    std::uint64_t mark = start;
+
+    // Convert to instrument units
+    const Instrument &instrument = orderBook.getInstrument();
+    if (!instrument.isQuantityInRange(request.quantity) || !instrument.isWholeLots(request.quantity) ||
+        request.quantity <= 0)
+    {
+        return reject(request, RejectReason::INVALID_QUANTITY);
+    }
+    if (!instrument.isPriceInRange(request.price) || !instrument.isPriceInRange(request.stopPrice) ||
+        !instrument.isOnTick(request.price) || !instrument.isOnTick(request.stopPrice))
+    {
+        return reject(request, RejectReason::INVALID_PRICE);
+    }
+    Quantity lots = instrument.toLots(request.quantity);
+    Price ticks = instrument.toTicks(request.price);
+    Price stopTicks = instrument.toTicks(request.stopPrice);
+
+    if (std::optional<RejectReason> reason = Order::validate(lots, ticks, request.type, stopTicks))
+    {
+        return reject(request, *reason);
+    }
+    bool hasLimit = request.type == OrderType::LIMIT || request.type == OrderType::STOP_LIMIT;
+    bool isStop = request.type == OrderType::STOP || request.type == OrderType::STOP_LIMIT;
+
+    // The order's value at its limit or stop must fit in Cash, and so then
+    // does every fill it takes part in. Buys without a limit are priced at
+    // the stop, or for market orders at the cost of sweeping the asks.
+    std::optional<Cash> value = 0;
+    if (hasLimit)
+    {
+        value = instrument.checkedNotional(lots, ticks);
+    }
+    else if (isStop)
+    {
+        value = instrument.checkedNotional(lots, stopTicks);
+    }
+    else if (request.side == OrderSide::BUY)
+    {
+        value = instrument.checkedNotional(1, orderBook.getSweepCost(OrderSide::BUY, lots));
+    }
+    if (!value)
+    {
+        return reject(request, RejectReason::INVALID_QUANTITY);
+    }
 
-    // Get or create order book for symbol
-    auto orderBook = getOrCreateOrderBook(symbol);
+    // Pre-trade validation against what open orders have not reserved
+    Cash cost = 0;
+    if (request.side == OrderSide::BUY)
+    {
+        cost = *value;
+        if (account->getAvailableCash() < cost)
+        {
+            return reject(request, RejectReason::INSUFFICIENT_CASH);
+        }
+    }
+    else
+    {
+        if (account->getAvailableShares(request.symbolId) < instrument.toShares(lots))
+        {
+            return reject(request, RejectReason::INSUFFICIENT_SHARES);
+        }
+    }
 
-    // Store trades before adding order
-    size_t tradesBefore = orderBook->getTrades().size();
+    if (profiling)
+    {
+        mark = profiler_.lap(LatencyStage::VALIDATE, mark);
+    }
 
-    // Add order to order book (this may execute trades)
-    orderBook->addOrder(order);
+    // Create order in a pooled slot
+    OrderHandle handle = orderPool_.allocate(nextOrderId_, request.traderId, request.symbolId,
+                                             lots, ticks, request.side, request.type, stopTicks);
+    if (handle == kInvalidOrderHandle)
+    {
+        return reject(request, RejectReason::POOL_EXHAUSTED);
+    }
+    int orderId = nextOrderId_;
+    nextOrderId_ += orderIdStride_;
+    Order *order = orderPool_.get(handle);
+    orders_.insert(orderId, handle);
+    reserve(*account, handle, instrument, cost);
+    if (journal_)
+    {
+        journalSequence_ = journal_->appendSubmit(request, orderId);
+    }
+    if (profiling)
+    {
+        mark = profiler_.lap(LatencyStage::CREATE, mark);
+    }
 
-    // Get new trades
-    const auto &allTrades = orderBook->getTrades();
-    std::vector<Trade> newTrades(allTrades.begin() + tradesBefore, allTrades.end());
+    // Add order to order book (this may execute trades). Filled resting
+    // orders give back their slots from the fill events; orders the book
+    // finishes with while executing are released once it returns.
+    orderBook.addOrder(order);
+    if (profiling)
+    {
+        mark = profiler_.lap(LatencyStage::MATCH, mark);
+    }
+    releaseFinishedOrders();
+    if (profiling)
+    {
+        mark = profiler_.lap(LatencyStage::RELEASE, mark);
+    }
+    if (feed_)
+    {
+        feed_->publishTopOfBook(orderBook);
+    }
+    countInput();
+    if (profiling)
+    {
+        profiler_.record(LatencyStage::TOTAL, profiler_.lap(LatencyStage::PUBLISH, mark) - start);
+    }
 
-    // Process trade notifications
-    processTradeNotifications(newTrades);
+    return OrderResult{orderId, true, RejectReason::UNKNOWN_TRADER};
+}
 
-    return orderId;
+OrderResult MatchingEngine::reject(const OrderRequest &request, RejectReason reason)
+{
+    OrderRejectedEvent event{request.traderId, request.symbolId, request.side, reason};
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onOrderRejected(event);
+    }
+    return OrderResult{0, false, reason};
 }
 
 bool MatchingEngine::cancelOrder(int orderId)
 {
-    auto orderIt = orders_.find(orderId);
-    if (orderIt == orders_.end())
+    OrderHandle handle = orders_.find(orderId);
+    if (handle == kInvalidOrderHandle)
     {
         return false;
     }
 
-    auto order = orderIt->second;
-    auto orderBook = getOrderBook(order->getSymbol());
+    Order *order = orderPool_.get(handle);
+    OrderBook *orderBook = findOrderBook(order->getSymbolId());
 
     if (orderBook)
     {
-        bool cancelled = orderBook->cancelOrder(orderId);
-        if (cancelled)
+        if (journal_)
         {
-            orders_.erase(orderIt);
+            journalSequence_ = journal_->appendCancel(orderId);
         }
+        bool cancelled = orderBook->cancelOrder(order);
+        releaseFinishedOrders();
+        if (feed_)
+        {
+            feed_->publishTopOfBook(*orderBook);
+        }
+        countInput();
         return cancelled;
     }
 
     return false;
 }
 
-std::shared_ptr<Order> MatchingEngine::getOrder(int orderId) const
+size_t MatchingEngine::cancelOrders(std::span<const int> orderIds, std::span<OrderResult> results)
+{
+    if (results.size() < orderIds.size())
+    {
+        throw std::invalid_argument("Result buffer is smaller than the batch");
+    }
+
+    size_t cancelled = 0;
+    for (size_t i = 0; i < orderIds.size(); ++i)
+    {
+        bool ok = cancelOrder(orderIds[i]);
+        results[i] = OrderResult{orderIds[i], ok, RejectReason::UNKNOWN_ORDER};
+        cancelled += ok;
+    }
+    return cancelled;
+}
+
+const Order *MatchingEngine::getOrder(int orderId) const
+{
+    OrderHandle handle = orders_.find(orderId);
+    return (handle != kInvalidOrderHandle) ? orderPool_.get(handle) : nullptr;
+}
+
+void MatchingEngine::reserve(RiskAccount &account, OrderHandle handle, const Instrument &instrument, Cash cash)
 {
-    auto it = orders_.find(orderId);
-    return (it != orders_.end()) ? it->second : nullptr;
+    const Order *order = orderPool_.get(handle);
+    if (order->isBuy())
+    {
+        reservedCash_[handle] = cash;
+        account.reservedCash += cash;
+    }
+    else
+    {
+        reservedCash_[handle] = 0;
+        account.reserveShares(order->getSymbolId(), instrument.toShares(order->getRemainingQuantity()));
+    }
 }
 
-std::shared_ptr<OrderBook> MatchingEngine::getOrderBook(const std::string &symbol)
+void MatchingEngine::settleFill(int orderId, const Instrument &instrument, Quantity lots, Price price)
 {
-    auto it = orderBooks_.find(symbol);
-    return (it != orderBooks_.end()) ? it->second : nullptr;
+    OrderHandle handle = orders_.find(orderId);
+    if (handle == kInvalidOrderHandle)
+    {
+        return;
+    }
+    const Order *order = orderPool_.get(handle);
+    filledNotional_[handle] += lots * price;
+    RiskAccount *account = accounts_.find(order->getTraderId());
+    if (!account)
+    {
+        return;
+    }
+
+    // A limit buy gives back what it reserved at its limit, which covers the
+    // fill; a market or stop buy gives back what the fill cost, as far as
+    // its reservation goes
+    if (order->isBuy())
+    {
+        Cash &held = reservedCash_[handle];
+        Cash released = order->isMarketable() ? std::min(held, instrument.notional(lots, price))
+                                              : instrument.notional(lots, order->getPrice());
+        held -= released;
+        account->reservedCash -= released;
+    }
+    else
+    {
+        account->releaseShares(order->getSymbolId(), instrument.toShares(lots));
+    }
+    account->trader->settle(instrument, lots, price, order->isBuy());
 }
 
-std::shared_ptr<OrderBook> MatchingEngine::getOrCreateOrderBook(const std::string &symbol)
+void MatchingEngine::releaseOrder(OrderHandle handle)
 {
-    auto it = orderBooks_.find(symbol);
-    if (it == orderBooks_.end())
+    const Order *order = orderPool_.get(handle);
+    const Instrument &instrument = findOrderBook(order->getSymbolId())->getInstrument();
+    Quantity filled = order->getFilledQuantity();
+    double averagePrice = filled > 0 ? static_cast<double>(filledNotional_[handle]) * instrument.toPrice(1) / filled : 0.0;
+    history_.add(OrderRecord{order->getOrderId(), order->getSymbolId(), order->getStatus(), order->getSide(),
+                             filled, averagePrice},
+                 orderIdStride_);
+
+    // Whatever a finished order still holds goes back to its trader
+    if (RiskAccount *account = accounts_.find(order->getTraderId()))
     {
-        auto orderBook = std::make_shared<OrderBook>(symbol);
-        orderBooks_[symbol] = orderBook;
-        return orderBook;
+        if (order->isBuy())
+        {
+            account->reservedCash -= reservedCash_[handle];
+        }
+        else if (order->getRemainingQuantity() > 0)
+        {
+            account->releaseShares(order->getSymbolId(), instrument.toShares(order->getRemainingQuantity()));
+        }
     }
-    return it->second;
+    reservedCash_[handle] = 0;
+    filledNotional_[handle] = 0;
+    orders_.erase(order->getOrderId());
+    orderPool_.release(handle);
+}
+
+void MatchingEngine::releaseFinishedOrders()
+{
+    for (int orderId : finishedOrders_)
+    {
+        releaseOrder(orders_.find(orderId));
+    }
+    finishedOrders_.clear();
+}
+
+std::shared_ptr<OrderBook> MatchingEngine::getOrderBook(SymbolId symbolId) const
+{
+    return (symbolId < orderBooks_.size()) ? orderBooks_[symbolId] : nullptr;
+}
+
+std::shared_ptr<OrderBook> MatchingEngine::getOrderBook(const std::string &symbol) const
+{
+    return getOrderBook(SymbolRegistry::instance().find(symbol));
+}
+
+OrderBook *MatchingEngine::findOrderBook(SymbolId symbolId) const
+{
+    return (symbolId < orderBooks_.size()) ? orderBooks_[symbolId].get() : nullptr;
+}
+
+OrderBook *MatchingEngine::findOrCreateOrderBook(SymbolId symbolId)
+{
+    OrderBook *orderBook = findOrderBook(symbolId);
+    if (!orderBook && symbolId < SymbolRegistry::instance().size())
+    {
+        orderBook = &getOrCreateOrderBook(symbolId);
+    }
+    return orderBook;
+}
+
+OrderBook &MatchingEngine::getOrCreateOrderBook(SymbolId symbolId)
+{
+    OrderBook *orderBook = findOrderBook(symbolId);
+    if (!orderBook)
+    {
+        defineInstrument(Instrument(SymbolRegistry::instance().name(symbolId)));
+        orderBook = orderBooks_[symbolId].get();
+    }
+    return *orderBook;
+}
+
+double MatchingEngine::getLastPrice(SymbolId symbolId) const
+{
+    const OrderBook *orderBook = findOrderBook(symbolId);
+    return orderBook ? orderBook->getLastTradePrice() : 0.0;
 }
 
 double MatchingEngine::getLastPrice(const std::string &symbol) const
 {
-    auto it = orderBooks_.find(symbol);
-    return (it != orderBooks_.end()) ? it->second->getLastTradePrice() : 0.0;
+    return getLastPrice(SymbolRegistry::instance().find(symbol));
+}
+
+double MatchingEngine::getBestBid(SymbolId symbolId) const
+{
+    const OrderBook *orderBook = findOrderBook(symbolId);
+    return orderBook ? orderBook->getBestBidPrice() : 0.0;
 }
 
 double MatchingEngine::getBestBid(const std::string &symbol) const
 {
-    auto it = orderBooks_.find(symbol);
-    return (it != orderBooks_.end()) ? it->second->getBestBidPrice() : 0.0;
+    return getBestBid(SymbolRegistry::instance().find(symbol));
+}
+
+double MatchingEngine::getBestAsk(SymbolId symbolId) const
+{
+    const OrderBook *orderBook = findOrderBook(symbolId);
+    return orderBook ? orderBook->getBestAskPrice() : 0.0;
 }
 
 double MatchingEngine::getBestAsk(const std::string &symbol) const
 {
-    auto it = orderBooks_.find(symbol);
-    return (it != orderBooks_.end()) ? it->second->getBestAskPrice() : 0.0;
+    return getBestAsk(SymbolRegistry::instance().find(symbol));
 }
 
-void MatchingEngine::processTradeNotifications(const std::vector<Trade> &trades)
+void MatchingEngine::onOrderAccepted(const OrderAcceptedEvent &event)
 {
-    for (const auto &trade : trades)
+    for (ExecutionListener *listener : listeners_)
     {
-        // Notify buyer
-        auto buyer = getTrader(trade.buyTraderId);
-        if (buyer)
-        {
-            buyer->onOrderFilled(trade.symbol, trade.quantity, trade.price, true);
-        }
+        listener->onOrderAccepted(event);
+    }
+}
 
-        // Notify seller
-        auto seller = getTrader(trade.sellTraderId);
-        if (seller)
-        {
-            seller->onOrderFilled(trade.symbol, trade.quantity, trade.price, false);
-        }
+void MatchingEngine::onOrderPartiallyFilled(const OrderFillEvent &event)
+{
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onOrderPartiallyFilled(event);
+    }
+}
 
-        std::cout << "TRADE: " << trade.symbol
-                  << " | Qty: " << trade.quantity
-                  << " | Price: $" << std::fixed << std::setprecision(2) << trade.price
-                  << " | Buyer: " << trade.buyTraderId
-                  << " | Seller: " << trade.sellTraderId << std::endl;
+void MatchingEngine::onOrderFilled(const OrderFillEvent &event)
+{
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onOrderFilled(event);
+    }
+
+    // The book is done with a filled resting order; an executing order is
+    // still in use until the book call returns
+    if (event.aggressor)
+    {
+        finishedOrders_.push_back(event.orderId);
+    }
+    else
+    {
+        releaseOrder(orders_.find(event.orderId));
+    }
+}
+
+void MatchingEngine::onOrderCancelled(const OrderCancelledEvent &event)
+{
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onOrderCancelled(event);
+    }
+    finishedOrders_.push_back(event.orderId);
+}
+
+void MatchingEngine::onTrade(const Trade &trade)
+{
+    bool profiling = profiler_.isEnabled();
+    std::uint64_t start = profiling ? readCycles() : 0;
+    const Instrument &instrument = findOrderBook(trade.symbolId)->getInstrument();
+
+    // Settle both sides before anyone else sees the trade
+    settleFill(trade.buyOrderId, instrument, trade.quantity, trade.price);
+    settleFill(trade.sellOrderId, instrument, trade.quantity, trade.price);
+
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onTrade(trade);
+    }
+    if (profiling)
+    {
+        profiler_.lap(LatencyStage::SETTLE, start);
+    }
+}
+
+bool MatchingEngine::onStopTriggered(const StopTriggeredEvent &event)
+{
+    // A stop buy was reserved at its stop price but runs as a market order;
+    // hold what sweeping the asks costs now, or cancel it
+    if (event.side != OrderSide::BUY || event.type != OrderType::STOP)
+    {
+        return true;
+    }
+    OrderHandle handle = orders_.find(event.orderId);
+    RiskAccount *account = accounts_.find(event.traderId);
+    if (handle == kInvalidOrderHandle || !account)
+    {
+        return true;
+    }
+
+    const OrderBook &orderBook = *findOrderBook(event.symbolId);
+    std::optional<Cash> cost =
+        orderBook.getInstrument().checkedNotional(1, orderBook.getSweepCost(OrderSide::BUY, event.quantity));
+    Cash &held = reservedCash_[handle];
+    if (!cost || *cost - held > account->getAvailableCash())
+    {
+        return false;
+    }
+    account->reservedCash += *cost - held;
+    held = *cost;
+    return true;
+}
+
+void MatchingEngine::onBookUpdate(const BookUpdateEvent &event)
+{
+    for (ExecutionListener *listener : listeners_)
+    {
+        listener->onBookUpdate(event);
     }
 }
 
@@ -173,8 +977,13 @@ void MatchingEngine::printMarketSummary() const
               << std::setw(10) << "Trades" << std::endl;
     std::cout << std::string(78, '-') << std::endl;
 
-    for (const auto &[symbol, orderBook] : orderBooks_)
+    for (const auto &orderBook : orderBooks_)
     {
+        if (!orderBook)
+        {
+            continue;
+        }
+
         double lastPrice = orderBook->getLastTradePrice();
         double bestBid = orderBook->getBestBidPrice();
         double bestAsk = orderBook->getBestAskPrice();
@@ -182,7 +991,7 @@ void MatchingEngine::printMarketSummary() const
         double volume = orderBook->getTotalVolume();
         size_t tradeCount = orderBook->getTradeCount();
 
-        std::cout << std::setw(10) << symbol
+        std::cout << std::setw(10) << orderBook->getSymbol()
                   << std::setw(12) << (lastPrice > 0 ? std::to_string(lastPrice) : "N/A")
                   << std::setw(12) << (bestBid > 0 ? std::to_string(bestBid) : "N/A")
                   << std::setw(12) << (bestAsk > 0 ? std::to_string(bestAsk) : "N/A")
@@ -198,10 +1007,19 @@ std::vector<Trade> MatchingEngine::getAllTrades() const
 {
     std::vector<Trade> allTrades;
 
-    for (const auto &[symbol, orderBook] : orderBooks_)
+    for (const auto &orderBook : orderBooks_)
     {
-        const auto &bookTrades = orderBook->getTrades();
-        allTrades.insert(allTrades.end(), bookTrades.begin(), bookTrades.end());
+        if (!orderBook)
+        {
+            continue;
+        }
+        const TradeHistory &bookTrades = orderBook->getTrades();
+        auto cursor = bookTrades.readFrom(bookTrades.getFirstAvailable());
+        Trade trade;
+        while (cursor.next(trade))
+        {
+            allTrades.push_back(trade);
+        }
     }
 
     return allTrades;
@@ -210,8 +1028,12 @@ std::vector<Trade> MatchingEngine::getAllTrades() const
 size_t MatchingEngine::getTotalTradeCount() const
 {
     size_t totalTrades = 0;
-    for (const auto &[symbol, orderBook] : orderBooks_)
+    for (const auto &orderBook : orderBooks_)
     {
+        if (!orderBook)
+        {
+            continue;
+        }
         totalTrades += orderBook->getTradeCount();
     }
     return totalTrades;
@@ -220,8 +1042,12 @@ size_t MatchingEngine::getTotalTradeCount() const
 double MatchingEngine::getTotalVolume() const
 {
     double totalVolume = 0.0;
-    for (const auto &[symbol, orderBook] : orderBooks_)
+    for (const auto &orderBook : orderBooks_)
     {
+        if (!orderBook)
+        {
+            continue;
+        }
         totalVolume += orderBook->getTotalVolume();
     }
     return totalVolume;
@@ -1,26 +1,40 @@
 #include "../include/Order.hpp"
 #include <stdexcept>
 
-Order::Order(int orderId, int traderId, const std::string &symbol,
-             double quantity, double price, OrderSide side, OrderType type)
-    : orderId_(orderId), traderId_(traderId), symbol_(symbol),
-      quantity_(quantity), price_(price), side_(side), type_(type),
-      status_(OrderStatus::PENDING), filledQuantity_(0.0),
+Order::Order(int orderId, int traderId, SymbolId symbolId,
+             Quantity quantity, Price price, OrderSide side, OrderType type, Price stopPrice)
+    : orderId_(orderId), traderId_(traderId), symbolId_(symbolId),
+      quantity_(quantity), price_(price), stopPrice_(stopPrice), side_(side), type_(type),
+      status_(OrderStatus::PENDING), filledQuantity_(0),
       timestamp_(std::chrono::steady_clock::now())
 {
-
-    if (quantity <= 0)
+    std::optional<RejectReason> reason = validate(quantity, price, type, stopPrice);
+    if (reason == RejectReason::INVALID_QUANTITY)
     {
         throw std::invalid_argument("Quantity must be positive");
     }
+    if (reason)
+    {
+        throw std::invalid_argument("Limit and stop prices must be positive");
+    }
+}
 
-    if (type == OrderType::LIMIT && price <= 0)
+std::optional<RejectReason> Order::validate(Quantity quantity, Price price, OrderType type, Price stopPrice)
+{
+    if (quantity <= 0)
     {
-        throw std::invalid_argument("Price must be positive for limit orders");
+        return RejectReason::INVALID_QUANTITY;
     }
+    bool hasLimit = type == OrderType::LIMIT || type == OrderType::STOP_LIMIT;
+    bool isStop = type == OrderType::STOP || type == OrderType::STOP_LIMIT;
+    if ((hasLimit && price <= 0) || (isStop && stopPrice <= 0))
+    {
+        return RejectReason::INVALID_PRICE;
+    }
+    return std::nullopt;
 }
 
-void Order::addFill(double quantity)
+void Order::addFill(Quantity quantity)
 {
     if (quantity <= 0)
     {
@@ -44,6 +58,17 @@ void Order::addFill(double quantity)
     }
 }
 
+void Order::restore(Quantity filledQuantity, bool triggered)
+{
+    if (filledQuantity < 0 || filledQuantity >= quantity_)
+    {
+        throw std::invalid_argument("Restored fill must leave the order open");
+    }
+    filledQuantity_ = filledQuantity;
+    status_ = filledQuantity > 0 ? OrderStatus::PARTIALLY_FILLED : OrderStatus::PENDING;
+    triggered_ = triggered;
+}
+
 bool Order::operator<(const Order &other) const
 {
     // For buy orders: higher price has higher priority
@@ -0,0 +1,32 @@
+#include "../include/OrderHistory.hpp"
+#include <stdexcept>
+
+OrderHistory::OrderHistory(size_t window)
+{
+    if (window == 0)
+    {
+        throw std::invalid_argument("Order history window must be positive");
+    }
+    records_.assign(window, OrderRecord{0, kInvalidSymbolId, OrderStatus::PENDING, OrderSide::BUY, 0, 0.0});
+}
+
+void OrderHistory::add(const OrderRecord &record, int stride)
+{
+    OrderRecord &kept = records_[slot(record.orderId, stride)];
+    if (kept.orderId < record.orderId)
+    {
+        kept = record;
+    }
+}
+
+const OrderRecord *OrderHistory::find(int orderId, int nextOrderId, int stride) const
+{
+    std::int64_t oldest = static_cast<std::int64_t>(nextOrderId) -
+                          static_cast<std::int64_t>(records_.size()) * stride;
+    if (orderId <= 0 || orderId <= oldest)
+    {
+        return nullptr;
+    }
+    const OrderRecord &record = records_[slot(orderId, stride)];
+    return record.orderId == orderId ? &record : nullptr;
+}
@@ -0,0 +1,58 @@
+#include "../include/OrderIndex.hpp"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+OrderIndex::OrderIndex(size_t maxOrders)
+{
+    size_t capacity = std::bit_ceil(std::max<size_t>(maxOrders * 2, 16));
+    entries_.assign(capacity, Entry{0, kInvalidOrderHandle});
+    mask_ = capacity - 1;
+    shift_ = 32 - std::countr_zero(capacity);
+}
+
+void OrderIndex::insert(int orderId, OrderHandle handle)
+{
+    if ((size_ + 1) * 2 > entries_.size())
+    {
+        throw std::length_error("Order index full");
+    }
+    size_t slot = home(orderId);
+    while (entries_[slot].handle != kInvalidOrderHandle)
+    {
+        slot = (slot + 1) & mask_;
+    }
+    entries_[slot] = Entry{orderId, handle};
+    ++size_;
+}
+
+void OrderIndex::erase(int orderId)
+{
+    size_t hole = home(orderId);
+    while (entries_[hole].orderId != orderId)
+    {
+        if (entries_[hole].handle == kInvalidOrderHandle)
+        {
+            return;
+        }
+        hole = (hole + 1) & mask_;
+    }
+    if (entries_[hole].handle == kInvalidOrderHandle)
+    {
+        return;
+    }
+
+    // Pull back each later entry of the run that may sit in the hole: one
+    // whose home slot is at or before it
+    for (size_t next = (hole + 1) & mask_; entries_[next].handle != kInvalidOrderHandle; next = (next + 1) & mask_)
+    {
+        size_t fromHome = (next - home(entries_[next].orderId)) & mask_;
+        if (fromHome >= ((next - hole) & mask_))
+        {
+            entries_[hole] = entries_[next];
+            hole = next;
+        }
+    }
+    entries_[hole].handle = kInvalidOrderHandle;
+    --size_;
+}
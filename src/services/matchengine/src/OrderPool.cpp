@@ -0,0 +1,23 @@
+#include "../include/OrderPool.hpp"
+
+OrderPool::OrderPool(size_t capacity)
+    : slots_(capacity), highWaterMark_(0), allocationFailures_(0)
+{
+    // Hand out low handles first
+    freeList_.reserve(capacity);
+    for (size_t i = capacity; i > 0; --i)
+    {
+        freeList_.push_back(static_cast<OrderHandle>(i - 1));
+    }
+}
+
+void OrderPool::release(OrderHandle handle)
+{
+    slots_[handle].reset();
+    freeList_.push_back(handle);
+}
+
+OrderPoolStats OrderPool::getStats() const
+{
+    return OrderPoolStats{capacity(), inUse(), highWaterMark_, allocationFailures_};
+}
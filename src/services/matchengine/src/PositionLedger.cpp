@@ -0,0 +1,105 @@
+#include "../include/PositionLedger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+// amount * part / whole, rounded; long double keeps the product exact
+static Cash prorate(Cash amount, std::int64_t part, std::int64_t whole)
+{
+    if (part == whole)
+    {
+        return amount;
+    }
+    return static_cast<Cash>(std::llround(static_cast<long double>(amount) * part / whole));
+}
+
+static void reprice(Position &position, double marketPrice)
+{
+    position.marketPrice = marketPrice;
+    position.marketValue = position.quantity * toCash(marketPrice);
+    position.unrealizedPnL = fromCash(position.marketValue - position.costBasis);
+    position.averagePrice = position.quantity != 0 ? fromCash(position.costBasis) / position.quantity : 0.0;
+}
+
+void PositionLedger::applyFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price)
+{
+    Position &position = open(symbolId);
+    remove(position);
+
+    Cash signedCost = shares > 0 ? cost : -cost;
+    if (position.quantity != 0 && (position.quantity > 0) != (shares > 0))
+    {
+        // Close out as much of the position as the fill covers
+        std::int64_t held = std::abs(position.quantity);
+        std::int64_t filled = std::abs(shares);
+        std::int64_t closed = std::min(filled, held);
+        Cash closedCost = prorate(signedCost, closed, filled);
+        Cash closedBasis = prorate(position.costBasis, closed, held);
+        position.realizedPnL -= closedCost + closedBasis;
+        position.costBasis -= closedBasis;
+        position.quantity += shares > 0 ? closed : -closed;
+        shares += shares > 0 ? -closed : closed;
+        signedCost -= closedCost;
+    }
+    position.quantity += shares;
+    position.costBasis += signedCost;
+    reprice(position, price);
+
+    add(position);
+}
+
+void PositionLedger::mark(SymbolId symbolId, double marketPrice)
+{
+    Position *position = slot(symbolId);
+    if (position)
+    {
+        remove(*position);
+        reprice(*position, marketPrice);
+        add(*position);
+    }
+}
+
+void PositionLedger::restore(const std::vector<Position> &positions)
+{
+    *this = PositionLedger();
+    for (const Position &restored : positions)
+    {
+        Position &position = open(restored.symbolId);
+        remove(position);
+        position = restored;
+        reprice(position, restored.marketPrice);
+        add(position);
+    }
+}
+
+Position &PositionLedger::open(SymbolId symbolId)
+{
+    if (symbolId >= slots_.size())
+    {
+        slots_.resize(static_cast<size_t>(symbolId) + 1, kNoSlot);
+    }
+    if (slots_[symbolId] == kNoSlot)
+    {
+        slots_[symbolId] = static_cast<std::uint32_t>(positions_.size());
+        positions_.emplace_back(symbolId);
+    }
+    return positions_[slots_[symbolId]];
+}
+
+void PositionLedger::remove(const Position &position)
+{
+    openCount_ -= position.quantity != 0;
+    costBasis_ -= position.costBasis;
+    marketValue_ -= position.marketValue;
+    grossExposure_ -= std::abs(position.marketValue);
+    realizedPnL_ -= position.realizedPnL;
+}
+
+void PositionLedger::add(const Position &position)
+{
+    openCount_ += position.quantity != 0;
+    costBasis_ += position.costBasis;
+    marketValue_ += position.marketValue;
+    grossExposure_ += std::abs(position.marketValue);
+    realizedPnL_ += position.realizedPnL;
+}
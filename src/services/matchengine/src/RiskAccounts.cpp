@@ -0,0 +1,16 @@
+#include "../include/RiskAccounts.hpp"
+#include <stdexcept>
+
+void RiskAccounts::add(Trader *trader)
+{
+    int traderId = trader->getTraderId();
+    if (traderId < 0 || traderId > kMaxTraderId)
+    {
+        throw std::invalid_argument("Trader id out of range");
+    }
+    if (static_cast<size_t>(traderId) >= accounts_.size())
+    {
+        accounts_.resize(static_cast<size_t>(traderId) + 1);
+    }
+    accounts_[static_cast<size_t>(traderId)].trader = trader;
+}
@@ -0,0 +1,170 @@
+#include "../include/ShardedMatchingEngine.hpp"
+#include <stdexcept>
+
+ShardedMatchingEngine::Shard::Shard(size_t orderPoolCapacity, size_t queueCapacity)
+    : engine(orderPoolCapacity), requests(queueCapacity), results(queueCapacity)
+{
+}
+
+ShardedMatchingEngine::ShardedMatchingEngine(size_t shardCount, size_t orderPoolCapacity,
+                                             size_t queueCapacity)
+    : running_(false), nextPollShard_(0)
+{
+    if (shardCount == 0)
+    {
+        throw std::invalid_argument("Shard count must be positive");
+    }
+
+    shards_.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        shards_.push_back(std::make_unique<Shard>(orderPoolCapacity, queueCapacity));
+        // Interleaved ids, so the shard of an order follows from its id
+        shards_.back()->engine.setOrderIdSequence(static_cast<int>(i + 1), static_cast<int>(shardCount));
+    }
+}
+
+ShardedMatchingEngine::~ShardedMatchingEngine()
+{
+    stop();
+}
+
+void ShardedMatchingEngine::registerTrader(int traderId, const std::string &name, double cashPerShard)
+{
+    if (isRunning())
+    {
+        throw std::logic_error("Cannot register traders while running");
+    }
+    for (auto &shard : shards_)
+    {
+        shard->engine.registerTrader(std::make_shared<Trader>(traderId, name, cashPerShard));
+    }
+}
+
+void ShardedMatchingEngine::defineInstrument(const Instrument &instrument)
+{
+    if (isRunning())
+    {
+        throw std::logic_error("Cannot define instruments while running");
+    }
+    shards_[getShardIndex(instrument.symbolId)]->engine.defineInstrument(instrument);
+}
+
+std::shared_ptr<Trader> ShardedMatchingEngine::getTrader(int traderId, SymbolId symbolId) const
+{
+    return shards_[getShardIndex(symbolId)]->engine.getTrader(traderId);
+}
+
+void ShardedMatchingEngine::start()
+{
+    if (isRunning())
+    {
+        return;
+    }
+    running_.store(true, std::memory_order_release);
+    for (auto &shard : shards_)
+    {
+        Shard *target = shard.get();
+        shard->thread = std::thread([this, target] { run(*target); });
+    }
+}
+
+void ShardedMatchingEngine::stop()
+{
+    if (!isRunning())
+    {
+        return;
+    }
+    running_.store(false, std::memory_order_release);
+    for (auto &shard : shards_)
+    {
+        shard->thread.join();
+    }
+}
+
+bool ShardedMatchingEngine::submitOrder(std::uint64_t tag, int traderId, SymbolId symbolId, double quantity,
+                                        double price, OrderSide side, OrderType type, double stopPrice)
+{
+    ShardRequest request{tag, ShardRequestType::SUBMIT, traderId, symbolId, quantity, price, side, type, stopPrice, 0};
+    return shards_[getShardIndex(symbolId)]->requests.tryPush(request);
+}
+
+bool ShardedMatchingEngine::cancelOrder(std::uint64_t tag, int orderId)
+{
+    ShardRequest request{tag, ShardRequestType::CANCEL, 0, kInvalidSymbolId, 0.0, 0.0,
+                         OrderSide::BUY, OrderType::LIMIT, 0.0, orderId};
+    size_t shard = orderId > 0 ? static_cast<size_t>(orderId - 1) % shards_.size() : 0;
+    return shards_[shard]->requests.tryPush(request);
+}
+
+size_t ShardedMatchingEngine::pollResults(ShardResult *results, size_t maxResults)
+{
+    // Round-robin over the shards so a busy one cannot starve the others
+    size_t count = 0;
+    size_t idle = 0;
+    while (count < maxResults && idle < shards_.size())
+    {
+        Shard &shard = *shards_[nextPollShard_];
+        nextPollShard_ = (nextPollShard_ + 1) % shards_.size();
+        if (shard.results.tryPop(results[count]))
+        {
+            ++count;
+            idle = 0;
+        }
+        else
+        {
+            ++idle;
+        }
+    }
+    return count;
+}
+
+void ShardedMatchingEngine::run(Shard &shard)
+{
+    ShardRequest request;
+    for (;;)
+    {
+        // Read the flag first: once stopped, an empty queue stays empty for
+        // everything pushed before stop()
+        bool running = isRunning();
+        if (!shard.requests.tryPop(request))
+        {
+            if (!running)
+            {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        ShardResult result = process(shard, request);
+        while (!shard.results.tryPush(result) && isRunning())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ShardResult ShardedMatchingEngine::process(Shard &shard, const ShardRequest &request)
+{
+    ShardResult result{request.tag, ShardResultStatus::ACCEPTED, RejectReason::UNKNOWN_TRADER, 0};
+
+    if (request.type == ShardRequestType::CANCEL)
+    {
+        result.orderId = request.orderId;
+        result.status = shard.engine.cancelOrder(request.orderId) ? ShardResultStatus::CANCELLED
+                                                                  : ShardResultStatus::CANCEL_REJECTED;
+        return result;
+    }
+
+    OrderResult submitted = shard.engine.submitOrder(
+        OrderRequest{request.traderId, request.symbolId, request.quantity, request.price, request.side,
+                     request.orderType, request.stopPrice});
+    result.orderId = submitted.orderId;
+    if (!submitted.accepted)
+    {
+        result.status = ShardResultStatus::REJECTED;
+        result.reason = submitted.reason;
+    }
+    return result;
+}
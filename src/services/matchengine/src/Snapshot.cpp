@@ -0,0 +1,258 @@
+#include "../include/Snapshot.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::uint64_t alignUp(std::uint64_t size)
+{
+    return (size + 7) & ~std::uint64_t(7);
+}
+
+// Grows the image by the records' bytes, padded to 8, and copies them in;
+// returns where they start
+template <typename T>
+static std::uint64_t appendSection(std::vector<char> &image, const std::vector<T> &section)
+{
+    std::span<const T> records(section);
+    std::uint64_t offset = image.size();
+    image.resize(alignUp(offset + records.size_bytes()));
+    if (!records.empty())
+    {
+        std::memcpy(image.data() + offset, records.data(), records.size_bytes());
+    }
+    return offset;
+}
+
+void SnapshotBuilder::addBook(const SnapshotBook &book, std::string_view symbol)
+{
+    books_.push_back(book);
+    books_.back().symbol = addName(symbol);
+    books_.back().firstOrder = orders_.size();
+    books_.back().orderCount = 0;
+}
+
+void SnapshotBuilder::addOrder(const SnapshotOrder &order)
+{
+    orders_.push_back(order);
+    ++books_.back().orderCount;
+}
+
+void SnapshotBuilder::addTrader(const SnapshotTrader &trader, std::string_view name)
+{
+    traders_.push_back(trader);
+    traders_.back().name = addName(name);
+    traders_.back().firstPosition = positions_.size();
+    traders_.back().positionCount = 0;
+}
+
+void SnapshotBuilder::addPosition(const SnapshotPosition &position, std::string_view symbol)
+{
+    positions_.push_back(position);
+    positions_.back().symbol = addName(symbol);
+    ++traders_.back().positionCount;
+}
+
+SnapshotName SnapshotBuilder::addName(std::string_view name)
+{
+    SnapshotName entry{names_.size(), name.size()};
+    names_.append(name);
+    return entry;
+}
+
+std::vector<char> SnapshotBuilder::finish(SnapshotHeader header)
+{
+    std::vector<char> image(alignUp(sizeof(SnapshotHeader)));
+    std::memcpy(header.magic, kSnapshotFileMagic, sizeof(kSnapshotFileMagic));
+    header.bookCount = books_.size();
+    header.orderCount = orders_.size();
+    header.traderCount = traders_.size();
+    header.positionCount = positions_.size();
+    header.bookOffset = appendSection(image, books_);
+    header.orderOffset = appendSection(image, orders_);
+    header.traderOffset = appendSection(image, traders_);
+    header.positionOffset = appendSection(image, positions_);
+    header.nameOffset = image.size();
+    header.nameSize = names_.size();
+    image.insert(image.end(), names_.begin(), names_.end());
+    image.resize(alignUp(image.size()));
+    header.fileSize = image.size();
+    std::memcpy(image.data(), &header, sizeof(header));
+    return image;
+}
+
+SnapshotFile::SnapshotFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Cannot open snapshot: " + path);
+    }
+    struct stat info;
+    void *mapped = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(SnapshotHeader))
+    {
+        size_ = static_cast<size_t>(info.st_size);
+        mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Not a matchengine snapshot: " + path);
+    }
+    data_ = static_cast<const char *>(mapped);
+    header_ = reinterpret_cast<const SnapshotHeader *>(data_);
+
+    auto fits = [this](std::uint64_t offset, std::uint64_t count, size_t recordSize)
+    {
+        return offset % 8 == 0 && offset <= size_ && count <= (size_ - offset) / recordSize;
+    };
+    bool valid = std::memcmp(header_->magic, kSnapshotFileMagic, sizeof(kSnapshotFileMagic)) == 0 &&
+                 header_->fileSize == size_ &&
+                 fits(header_->bookOffset, header_->bookCount, sizeof(SnapshotBook)) &&
+                 fits(header_->orderOffset, header_->orderCount, sizeof(SnapshotOrder)) &&
+                 fits(header_->traderOffset, header_->traderCount, sizeof(SnapshotTrader)) &&
+                 fits(header_->positionOffset, header_->positionCount, sizeof(SnapshotPosition)) &&
+                 fits(header_->nameOffset, header_->nameSize, 1);
+    if (!valid)
+    {
+        ::munmap(const_cast<char *>(data_), size_);
+        throw std::runtime_error("Not a matchengine snapshot: " + path);
+    }
+}
+
+SnapshotFile::~SnapshotFile()
+{
+    ::munmap(const_cast<char *>(data_), size_);
+}
+
+template <typename T>
+std::span<const T> SnapshotFile::section(std::uint64_t offset, std::uint64_t count) const
+{
+    return std::span<const T>(reinterpret_cast<const T *>(data_ + offset), count);
+}
+
+std::span<const SnapshotBook> SnapshotFile::books() const
+{
+    return section<SnapshotBook>(header_->bookOffset, header_->bookCount);
+}
+
+std::span<const SnapshotOrder> SnapshotFile::orders() const
+{
+    return section<SnapshotOrder>(header_->orderOffset, header_->orderCount);
+}
+
+std::span<const SnapshotTrader> SnapshotFile::traders() const
+{
+    return section<SnapshotTrader>(header_->traderOffset, header_->traderCount);
+}
+
+std::span<const SnapshotPosition> SnapshotFile::positions() const
+{
+    return section<SnapshotPosition>(header_->positionOffset, header_->positionCount);
+}
+
+std::string_view SnapshotFile::name(const SnapshotName &name) const
+{
+    if (name.offset > header_->nameSize || name.length > header_->nameSize - name.offset)
+    {
+        throw std::runtime_error("Snapshot name out of range");
+    }
+    return std::string_view(data_ + header_->nameOffset + name.offset, name.length);
+}
+
+SnapshotWriter::SnapshotWriter() : thread_(&SnapshotWriter::run, this) {}
+
+SnapshotWriter::~SnapshotWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+}
+
+void SnapshotWriter::write(const std::string &path, std::vector<char> image)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(Job{path, std::move(image)});
+        ++queued_;
+    }
+    wakeup_.notify_one();
+}
+
+void SnapshotWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::uint64_t target = queued_;
+    done_.wait(lock, [this, target]() { return written_ + failed_ >= target; });
+    if (failed_ > 0)
+    {
+        throw std::runtime_error("Cannot write snapshot");
+    }
+}
+
+std::uint64_t SnapshotWriter::getWrittenCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+static bool writeFile(const std::string &path, const std::vector<char> &image)
+{
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const char *data = image.data();
+    size_t remaining = image.size();
+    while (remaining > 0)
+    {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    bool ok = ::fdatasync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    return ok && ::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+void SnapshotWriter::run()
+{
+    std::vector<Job> jobs;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wakeup_.wait(lock, [this]() { return !jobs_.empty() || stopping_; });
+        if (jobs_.empty())
+        {
+            return;
+        }
+        jobs.swap(jobs_);
+        lock.unlock();
+
+        std::uint64_t written = 0;
+        for (const Job &job : jobs)
+        {
+            written += writeFile(job.path, job.image);
+        }
+        size_t count = jobs.size();
+        jobs.clear();
+
+        lock.lock();
+        written_ += written;
+        failed_ += count - written;
+        done_.notify_all();
+    }
+}
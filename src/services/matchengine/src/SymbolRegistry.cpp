@@ -0,0 +1,42 @@
+#include "../include/SymbolRegistry.hpp"
+#include <stdexcept>
+
+SymbolRegistry &SymbolRegistry::instance()
+{
+    static SymbolRegistry registry;
+    return registry;
+}
+
+SymbolId SymbolRegistry::intern(const std::string &symbol)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = ids_.try_emplace(symbol, static_cast<SymbolId>(names_.size()));
+    if (inserted)
+    {
+        names_.push_back(symbol);
+    }
+    return it->second;
+}
+
+SymbolId SymbolRegistry::find(const std::string &symbol) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(symbol);
+    return (it != ids_.end()) ? it->second : kInvalidSymbolId;
+}
+
+const std::string &SymbolRegistry::name(SymbolId id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= names_.size())
+    {
+        throw std::out_of_range("Unknown symbol id");
+    }
+    return names_[id];
+}
+
+size_t SymbolRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+}
@@ -0,0 +1,220 @@
+#include "../include/TradeHistory.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+TradeHistory::TradeHistory(size_t capacity)
+    : head_(0), spilled_(0), spillFailed_(false), stalls_(0), fileBase_(0)
+{
+    size_t rounded = 1;
+    while (rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+    ring_.resize(rounded);
+    mask_ = rounded - 1;
+}
+
+void TradeHistory::append(const Trade &trade)
+{
+    std::uint64_t head = head_.load(std::memory_order_relaxed);
+
+    // While spilling, the slot about to be reused must already be on disk,
+    // unless the writer has given up
+    if (isSpilling() && head - spilled_.load(std::memory_order_acquire) >= ring_.size() && !hasSpillFailed())
+    {
+        ++stalls_;
+        while (head - spilled_.load(std::memory_order_acquire) >= ring_.size() && !hasSpillFailed())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    ring_[head & mask_] = trade;
+    head_.store(head + 1, std::memory_order_release);
+}
+
+size_t TradeHistory::size() const
+{
+    return static_cast<size_t>(std::min<std::uint64_t>(getTotalCount(), ring_.size()));
+}
+
+std::uint64_t TradeHistory::getFirstInMemory() const
+{
+    return getTotalCount() - size();
+}
+
+std::uint64_t TradeHistory::getFirstAvailable() const
+{
+    // After a failed write the file only reaches back from the ring while
+    // nothing unwritten has been overwritten
+    std::uint64_t firstInMemory = getFirstInMemory();
+    if (!isSpilling() || spilled_.load(std::memory_order_acquire) < firstInMemory)
+    {
+        return firstInMemory;
+    }
+    return fileBase_;
+}
+
+const Trade &TradeHistory::at(std::uint64_t sequence) const
+{
+    if (sequence < getFirstInMemory() || sequence >= getTotalCount())
+    {
+        throw std::out_of_range("Trade is not in memory");
+    }
+    return ring_[sequence & mask_];
+}
+
+void TradeHistory::spillTo(const std::string &path)
+{
+    if (isSpilling())
+    {
+        throw std::logic_error("Trade history is already spilling");
+    }
+
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_)
+    {
+        throw std::runtime_error("Cannot open trade spill file: " + path);
+    }
+    fileBase_ = getFirstInMemory();
+    spilled_.store(fileBase_, std::memory_order_release);
+    path_ = path;
+}
+
+size_t TradeHistory::flushPending()
+{
+    std::uint64_t from = spilled_.load(std::memory_order_relaxed);
+    std::uint64_t to = head_.load(std::memory_order_acquire);
+    if (from == to || hasSpillFailed())
+    {
+        return 0;
+    }
+
+    // Copy out of the ring in at most two contiguous runs
+    for (std::uint64_t sequence = from; sequence < to;)
+    {
+        size_t index = static_cast<size_t>(sequence & mask_);
+        size_t run = static_cast<size_t>(std::min<std::uint64_t>(to - sequence, ring_.size() - index));
+        out_.write(reinterpret_cast<const char *>(&ring_[index]), run * sizeof(Trade));
+        sequence += run;
+    }
+    out_.flush();
+    if (!out_)
+    {
+        spillFailed_.store(true, std::memory_order_release);
+        return 0;
+    }
+
+    spilled_.store(to, std::memory_order_release);
+    return static_cast<size_t>(to - from);
+}
+
+TradeHistory::Cursor TradeHistory::readFrom(std::uint64_t sequence) const
+{
+    if (sequence < getFirstAvailable())
+    {
+        throw std::out_of_range("Trade is no longer retained");
+    }
+    return Cursor(*this, sequence);
+}
+
+TradeHistory::Cursor::Cursor(const TradeHistory &history, std::uint64_t from)
+    : history_(&history), next_(from) {}
+
+bool TradeHistory::Cursor::next(Trade &trade)
+{
+    if (next_ >= history_->getTotalCount())
+    {
+        return false;
+    }
+
+    if (next_ >= history_->getFirstInMemory())
+    {
+        trade = history_->ring_[next_ & history_->mask_];
+    }
+    else
+    {
+        // Everything that has left the ring is in the spill file, unless
+        // it was overwritten after a failed write
+        if (next_ >= history_->spilled_.load(std::memory_order_acquire))
+        {
+            throw std::out_of_range("Trade is no longer retained");
+        }
+        if (!file_.is_open())
+        {
+            file_.open(history_->path_, std::ios::binary);
+        }
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>((next_ - history_->fileBase_) * sizeof(Trade)));
+        file_.read(reinterpret_cast<char *>(&trade), sizeof(Trade));
+        if (!file_)
+        {
+            throw std::runtime_error("Failed reading trade spill file: " + history_->path_);
+        }
+    }
+
+    ++next_;
+    return true;
+}
+
+TradeSpillWriter::TradeSpillWriter(std::chrono::milliseconds idleInterval)
+    : idleInterval_(idleInterval), stopping_(false), thread_(&TradeSpillWriter::run, this) {}
+
+TradeSpillWriter::~TradeSpillWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+    for (TradeHistory *history : histories_)
+    {
+        history->flushPending();
+    }
+}
+
+void TradeSpillWriter::add(TradeHistory &history)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    histories_.push_back(&history);
+}
+
+void TradeSpillWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (TradeHistory *history : histories_)
+    {
+        history->flushPending();
+        if (history->hasSpillFailed())
+        {
+            throw std::runtime_error("Failed writing trade spill file: " + history->getSpillPath());
+        }
+    }
+}
+
+void TradeSpillWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        size_t written = 0;
+        for (TradeHistory *history : histories_)
+        {
+            written += history->flushPending();
+        }
+
+        // Sleep only when there was nothing to write; otherwise just give
+        // add() and flush() a chance at the lock
+        if (written == 0)
+        {
+            wakeup_.wait_for(lock, idleInterval_);
+        }
+        else
+        {
+            lock.unlock();
+            std::this_thread::yield();
+            lock.lock();
+        }
+    }
+}
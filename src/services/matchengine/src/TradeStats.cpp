@@ -0,0 +1,80 @@
+#include "../include/TradeStats.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+TradeStats::TradeStats(std::chrono::nanoseconds barInterval, size_t barCount)
+    : volume_(0), notional_(0), open_(0), high_(0), low_(0), last_(0), tradeCount_(0),
+      barInterval_(barInterval), bars_(barCount), newestBar_(0), barCount_(0)
+{
+    if (barInterval.count() <= 0 || barCount == 0)
+    {
+        throw std::invalid_argument("Bar interval and bar count must be positive");
+    }
+}
+
+void TradeStats::restoreTotals(size_t tradeCount, Quantity volume, std::int64_t notional,
+                               Price open, Price high, Price low, Price last)
+{
+    tradeCount_ = tradeCount;
+    volume_ = volume;
+    notional_ = notional;
+    open_ = open;
+    high_ = high;
+    low_ = low;
+    last_ = last;
+    barCount_ = 0;
+}
+
+void TradeStats::onTrade(Price price, Quantity quantity, std::chrono::steady_clock::time_point timestamp)
+{
+    // Session totals
+    if (tradeCount_ == 0)
+    {
+        open_ = high_ = low_ = price;
+    }
+    else
+    {
+        high_ = std::max(high_, price);
+        low_ = std::min(low_, price);
+    }
+    last_ = price;
+    volume_ += quantity;
+    notional_ += price * quantity;
+    ++tradeCount_;
+
+    // Bucket of this trade
+    auto sinceEpoch = timestamp.time_since_epoch();
+    auto bucketStart = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            sinceEpoch - sinceEpoch % barInterval_));
+
+    if (barCount_ > 0 && bars_[newestBar_].start == bucketStart)
+    {
+        OhlcvBar &bar = bars_[newestBar_];
+        bar.high = std::max(bar.high, price);
+        bar.low = std::min(bar.low, price);
+        bar.close = price;
+        bar.volume += quantity;
+        ++bar.tradeCount;
+        return;
+    }
+
+    // Open a new bar, overwriting the oldest once the ring is full
+    newestBar_ = (barCount_ == 0) ? 0 : (newestBar_ + 1) % bars_.size();
+    barCount_ = std::min(barCount_ + 1, bars_.size());
+    bars_[newestBar_] = OhlcvBar{bucketStart, price, price, price, price, quantity, 1};
+}
+
+double TradeStats::getVwap() const
+{
+    return volume_ > 0 ? static_cast<double>(notional_) / volume_ : 0.0;
+}
+
+const OhlcvBar &TradeStats::getBar(size_t barsAgo) const
+{
+    if (barsAgo >= barCount_)
+    {
+        throw std::out_of_range("Bar not available");
+    }
+    return bars_[(newestBar_ + bars_.size() - barsAgo) % bars_.size()];
+}
@@ -1,128 +1,82 @@
 #include "Trader.hpp"
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
 
 Trader::Trader(int traderId, const std::string &name, double initialCash)
-    : traderId_(traderId), name_(name), cash_(initialCash) {}
+    : traderId_(traderId), name_(name), cash_(toCash(initialCash)) {}
 
-double Trader::getPortfolioValue() const
+void Trader::restore(Cash cash, const std::vector<Position> &positions)
 {
-    double totalValue = cash_;
-
-    for (const auto &[symbol, position] : positions_)
-    {
-        totalValue += position.quantity * position.averagePrice;
-    }
-
-    return totalValue;
+    cash_ = cash;
+    positions_.restore(positions);
 }
 
 void Trader::addCash(double amount)
 {
-    if (amount < 0 && (-amount) > cash_)
+    Cash units = toCash(amount);
+    if (units < 0 && (-units) > cash_)
     {
         throw std::invalid_argument("Insufficient cash for withdrawal");
     }
-    cash_ += amount;
+    cash_ += units;
 }
 
-bool Trader::hasSufficientShares(const std::string &symbol, double quantity) const
+bool Trader::hasSufficientShares(SymbolId symbolId, std::int64_t shares) const
 {
-    auto it = positions_.find(symbol);
-    return (it != positions_.end() && it->second.quantity >= quantity);
+    const Position *position = positions_.find(symbolId);
+    return position && position->quantity >= shares;
 }
 
-void Trader::onOrderFilled(const std::string &symbol, double quantity, double price, bool isBuy)
+bool Trader::hasSufficientShares(const std::string &symbol, std::int64_t shares) const
 {
-    if (isBuy)
-    {
-        double cost = quantity * price;
-        if (cost > cash_)
-        {
-            throw std::runtime_error("Insufficient cash for purchase");
-        }
-        cash_ -= cost;
-        updatePositionOnTrade(symbol, quantity, price);
-    }
-    else
-    {
-        if (!hasSufficientShares(symbol, quantity))
-        {
-            throw std::runtime_error("Insufficient shares for sale");
-        }
-        cash_ += quantity * price;
-        updatePositionOnTrade(symbol, -quantity, price);
-    }
+    return hasSufficientShares(SymbolRegistry::instance().find(symbol), shares);
 }
 
-void Trader::updatePosition(const std::string &symbol, double marketPrice)
+bool Trader::onOrderFilled(const Instrument &instrument, Quantity lots, Price price, bool isBuy)
 {
-    auto it = positions_.find(symbol);
-    if (it != positions_.end())
-    {
-        Position &position = it->second;
-        position.unrealizedPnL = position.quantity * (marketPrice - position.averagePrice);
-    }
+    return applyFill(instrument.symbolId, instrument.toShares(lots), instrument.notional(lots, price),
+                     instrument.toPrice(price), isBuy);
+}
+
+bool Trader::onOrderFilled(const std::string &symbol, double quantity, double price, bool isBuy)
+{
+    return applyFill(SymbolRegistry::instance().intern(symbol), std::llround(quantity),
+                     toCash(quantity * price), price, isBuy);
 }
 
-void Trader::updatePositionOnTrade(const std::string &symbol, double quantity, double price)
+void Trader::settle(const Instrument &instrument, Quantity lots, Price price, bool isBuy)
 {
-    auto it = positions_.find(symbol);
+    bookFill(instrument.symbolId, instrument.toShares(lots), instrument.notional(lots, price),
+             instrument.toPrice(price), isBuy);
+}
 
-    if (it == positions_.end())
+bool Trader::applyFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price, bool isBuy)
+{
+    if (isBuy ? cost > cash_ : !hasSufficientShares(symbolId, shares))
     {
-        if (quantity > 0)
-        {
-            positions_[symbol] = Position(symbol, quantity, price);
-        }
+        return false;
     }
-    else
-    {
-        Position &position = it->second;
-
-        if ((position.quantity > 0 && quantity > 0) || (position.quantity < 0 && quantity < 0))
-        {
-            double totalCost = (position.quantity * position.averagePrice) + (quantity * price);
-            double totalQuantity = position.quantity + quantity;
-
-            if (totalQuantity != 0)
-            {
-                position.averagePrice = totalCost / totalQuantity;
-            }
-            position.quantity = totalQuantity;
-        }
-        else
-        {
-            double remainingQuantity = position.quantity + quantity;
+    bookFill(symbolId, shares, cost, price, isBuy);
+    return true;
+}
 
-            if (std::abs(remainingQuantity) < 1e-9)
-            {
-                positions_.erase(it);
-            }
-            else if ((position.quantity > 0 && remainingQuantity > 0) ||
-                     (position.quantity < 0 && remainingQuantity < 0))
-            {
-                position.quantity = remainingQuantity;
-            }
-            else
-            {
-                position.quantity = remainingQuantity;
-                position.averagePrice = price;
-            }
-        }
+void Trader::bookFill(SymbolId symbolId, std::int64_t shares, Cash cost, double price, bool isBuy)
+{
+    cash_ += isBuy ? -cost : cost;
+    positions_.applyFill(symbolId, isBuy ? shares : -shares, cost, price);
+}
 
-        if (it != positions_.end() && std::abs(it->second.quantity) < 1e-9)
-        {
-            positions_.erase(it);
-        }
-    }
+void Trader::updatePosition(const std::string &symbol, double marketPrice)
+{
+    updatePosition(SymbolRegistry::instance().find(symbol), marketPrice);
 }
 
 void Trader::printPortfolio() const
 {
     std::cout << "\n=== Portfolio for " << name_ << " (ID: " << traderId_ << ") ===" << std::endl;
     std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Cash: $" << cash_ << std::endl;
+    std::cout << "Cash: $" << getCash() << std::endl;
 
     if (!positions_.empty())
     {
@@ -134,10 +88,10 @@ void Trader::printPortfolio() const
                   << std::setw(15) << "Unrealized P&L" << std::endl;
         std::cout << std::string(67, '-') << std::endl;
 
-        for (const auto &[symbol, position] : positions_)
+        for (const Position &position : positions_)
         {
-            double marketValue = position.quantity * position.averagePrice;
-            std::cout << std::setw(10) << symbol
+            double marketValue = fromCash(position.marketValue);
+            std::cout << std::setw(10) << SymbolRegistry::instance().name(position.symbolId)
                       << std::setw(12) << position.quantity
                       << std::setw(15) << position.averagePrice
                       << std::setw(15) << marketValue
@@ -149,13 +103,3 @@ void Trader::printPortfolio() const
     std::cout << "================================\n"
               << std::endl;
 }
-
-double Trader::getTotalPnL() const
-{
-    double totalPnL = 0.0;
-    for (const auto &[symbol, position] : positions_)
-    {
-        totalPnL += position.unrealizedPnL;
-    }
-    return totalPnL;
-}
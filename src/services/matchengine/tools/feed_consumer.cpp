@@ -0,0 +1,163 @@
+#include "MarketDataFeed.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Follows a matchengine market data feed and prints every message:
+//   matchengine_feedconsumer <feed file> [--from-oldest] [--count N]
+// Stops after N messages if given. Latencies are publish-to-read times.
+
+namespace
+{
+    struct Scale
+    {
+        std::string symbol;
+        std::int64_t priceScale = 2;
+        std::int64_t tickSize = 1;
+        std::int64_t lotSize = 1;
+    };
+
+    std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    double toPrice(const Scale &scale, std::int64_t ticks)
+    {
+        double factor = 1.0;
+        for (std::int64_t i = 0; i < scale.priceScale; ++i)
+        {
+            factor *= 10.0;
+        }
+        return static_cast<double>(ticks * scale.tickSize) / factor;
+    }
+
+    const char *actionName(std::uint8_t action)
+    {
+        switch (static_cast<LevelAction>(action))
+        {
+        case LevelAction::ADD:
+            return "ADD";
+        case LevelAction::UPDATE:
+            return "UPDATE";
+        case LevelAction::DELETE:
+            return "DELETE";
+        }
+        return "?";
+    }
+
+    void print(const FeedMessage &message, std::unordered_map<SymbolId, Scale> &scales)
+    {
+        Scale &scale = scales[message.symbolId];
+        if (scale.symbol.empty())
+        {
+            scale.symbol = "#" + std::to_string(message.symbolId);
+        }
+
+        std::cout << message.sequence << ' ';
+        switch (message.type)
+        {
+        case FeedMessageType::INSTRUMENT:
+        {
+            char name[2 * sizeof(std::int64_t) + 1] = {};
+            std::memcpy(name, message.fields, 2 * sizeof(std::int64_t));
+            scale = Scale{name, message.fields[2], message.fields[3], message.fields[4]};
+            std::cout << "INSTRUMENT " << scale.symbol << " scale=" << scale.priceScale
+                      << " tick=" << scale.tickSize << " lot=" << scale.lotSize;
+            break;
+        }
+        case FeedMessageType::TRADE:
+            std::cout << "TRADE " << scale.symbol << ' ' << message.fields[1] * scale.lotSize << " @ "
+                      << toPrice(scale, message.fields[0]) << " buy=" << message.fields[2]
+                      << " sell=" << message.fields[3];
+            break;
+        case FeedMessageType::TOP_OF_BOOK:
+            std::cout << "TOP " << scale.symbol << ' ' << message.fields[1] * scale.lotSize << " @ "
+                      << toPrice(scale, message.fields[0]) << " / " << message.fields[3] * scale.lotSize
+                      << " @ " << toPrice(scale, message.fields[2]);
+            break;
+        case FeedMessageType::LEVEL_UPDATE:
+            std::cout << "LEVEL " << scale.symbol << ' '
+                      << (static_cast<OrderSide>(message.side) == OrderSide::BUY ? "BID " : "ASK ")
+                      << actionName(message.action) << ' ' << toPrice(scale, message.fields[0]) << " x "
+                      << message.fields[1] * scale.lotSize << " (" << message.fields[2] << " orders)";
+            break;
+        }
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <feed file> [--from-oldest] [--count N]" << std::endl;
+        return 2;
+    }
+
+    bool fromOldest = false;
+    std::uint64_t limit = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--from-oldest")
+        {
+            fromOldest = true;
+        }
+        else if (arg == "--count" && i + 1 < argc)
+        {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else
+        {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    try
+    {
+        MarketDataReader reader(argv[1], fromOldest);
+        std::unordered_map<SymbolId, Scale> scales;
+        std::cout << std::fixed << std::setprecision(4);
+
+        std::uint64_t received = 0;
+        std::uint64_t missed = 0;
+        std::int64_t totalLatency = 0;
+        FeedMessage message;
+        while (limit == 0 || received < limit)
+        {
+            if (!reader.poll(message))
+            {
+                // A latency-sensitive consumer would spin here instead
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                continue;
+            }
+            totalLatency += now() - message.timestamp;
+            ++received;
+
+            if (reader.getMissedCount() != missed)
+            {
+                std::cout << "GAP " << reader.getMissedCount() - missed << " messages\n";
+                missed = reader.getMissedCount();
+            }
+            print(message, scales);
+        }
+
+        std::cout << received << " messages, " << missed << " missed, mean latency "
+                  << (received ? totalLatency / static_cast<std::int64_t>(received) : 0) << " ns" << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
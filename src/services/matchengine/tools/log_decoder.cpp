@@ -0,0 +1,33 @@
+#include "BinaryLogger.hpp"
+#include <fstream>
+#include <iostream>
+
+// Prints a matchengine binary log as text:
+//   matchengine_logdecode <log file>
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <log file>" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in)
+    {
+        std::cerr << "cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        LogDecoder decoder;
+        decoder.decode(in, std::cout);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
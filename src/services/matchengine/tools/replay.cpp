@@ -0,0 +1,506 @@
+#include "MatchingEngine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Drives a capture of submits and cancels through a fresh engine and
+// reports throughput, per-message latency and a hash of the final books,
+// balances and trade list:
+//   matchengine_replay <capture> [--paced] [--runs N] [--expect HASH]
+//                      [--cash X] [--shares N]
+//   matchengine_replay --generate <count> <capture.csv>
+//
+// A capture is either a journal written by MatchingEngine::enableJournal or
+// CSV with one message per line ('#' starts a comment):
+//   <time ns>,SUBMIT,<order id>,<trader id>,<symbol>,<BUY|SELL>,<type>,<quantity>,<price>,<stop price>
+//   <time ns>,CANCEL,<order id>
+// where type is LIMIT, MARKET, STOP or STOP_LIMIT and cancels name the order
+// id of an earlier submit. Every trader in the capture is registered with
+// the given cash and shares of every symbol. --paced holds each message back
+// until its recorded time (journals carry none and always run flat out).
+// The hash only depends on the capture, so it must not change between runs
+// or builds; --expect fails the run if it does.
+
+namespace
+{
+    struct Message
+    {
+        std::int64_t time; // ns from the start of the capture
+        bool cancel;
+        int captureId; // the order id the capture gave the order
+        OrderRequest request;
+    };
+
+    struct Capture
+    {
+        std::vector<Message> messages;
+        std::vector<int> traderIds;
+        std::vector<SymbolId> symbols; // in order of first appearance
+    };
+
+    struct RunResult
+    {
+        double seconds;
+        size_t accepted;
+        size_t rejected;
+        size_t trades;
+        std::vector<std::int64_t> latencies; // ns per message
+        std::uint64_t hash;
+    };
+
+    constexpr std::uint64_t kHashSeed = 14695981039346656037ull;
+
+    void mix(std::uint64_t &hash, std::int64_t value)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            hash = (hash ^ ((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xff)) * 1099511628211ull;
+        }
+    }
+
+    void mix(std::uint64_t &hash, const std::string &text)
+    {
+        for (char c : text)
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        mix(hash, static_cast<std::int64_t>(text.size()));
+    }
+
+    // Hashes trades as they happen; timestamps are left out
+    class TradeHasher : public ExecutionListener
+    {
+    public:
+        void onTrade(const Trade &trade) override
+        {
+            mix(hash_, trade.buyOrderId);
+            mix(hash_, trade.sellOrderId);
+            mix(hash_, trade.buyTraderId);
+            mix(hash_, trade.sellTraderId);
+            mix(hash_, SymbolRegistry::instance().name(trade.symbolId));
+            mix(hash_, trade.quantity);
+            mix(hash_, trade.price);
+            ++count_;
+        }
+
+        std::uint64_t getHash() const { return hash_; }
+        size_t getCount() const { return count_; }
+
+    private:
+        std::uint64_t hash_ = kHashSeed;
+        size_t count_ = 0;
+    };
+
+    OrderType parseType(const std::string &text)
+    {
+        if (text == "LIMIT")
+        {
+            return OrderType::LIMIT;
+        }
+        if (text == "MARKET")
+        {
+            return OrderType::MARKET;
+        }
+        if (text == "STOP")
+        {
+            return OrderType::STOP;
+        }
+        if (text == "STOP_LIMIT")
+        {
+            return OrderType::STOP_LIMIT;
+        }
+        throw std::runtime_error("unknown order type " + text);
+    }
+
+    const char *typeName(OrderType type)
+    {
+        switch (type)
+        {
+        case OrderType::LIMIT:
+            return "LIMIT";
+        case OrderType::MARKET:
+            return "MARKET";
+        case OrderType::STOP:
+            return "STOP";
+        case OrderType::STOP_LIMIT:
+            return "STOP_LIMIT";
+        }
+        return "?";
+    }
+
+    void readCsv(const std::string &path, Capture &capture)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            throw std::runtime_error("cannot open capture");
+        }
+
+        std::string line;
+        size_t lineNumber = 0;
+        std::vector<std::string> fields;
+        while (std::getline(in, line))
+        {
+            ++lineNumber;
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            fields.clear();
+            std::stringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, ','))
+            {
+                fields.push_back(field);
+            }
+
+            Message message{};
+            bool ok = fields.size() >= 3;
+            if (ok && fields[1] == "CANCEL")
+            {
+                message.cancel = true;
+            }
+            else if (ok && fields[1] == "SUBMIT" && fields.size() == 10)
+            {
+                message.request.traderId = std::stoi(fields[3]);
+                message.request.symbolId = SymbolRegistry::instance().intern(fields[4]);
+                message.request.side = fields[5] == "BUY" ? OrderSide::BUY : OrderSide::SELL;
+                message.request.type = parseType(fields[6]);
+                message.request.quantity = std::stod(fields[7]);
+                message.request.price = std::stod(fields[8]);
+                message.request.stopPrice = std::stod(fields[9]);
+            }
+            else
+            {
+                throw std::runtime_error("bad message on line " + std::to_string(lineNumber));
+            }
+            message.time = std::stoll(fields[0]);
+            message.captureId = std::stoi(fields[2]);
+            capture.messages.push_back(message);
+        }
+    }
+
+    void readJournal(const std::string &path, Capture &capture)
+    {
+        JournalReader reader(path);
+        JournalRecord record;
+        while (reader.next(record))
+        {
+            Message message{};
+            message.cancel = record.type == JournalRecordType::CANCEL;
+            message.captureId = record.orderId;
+            message.request = OrderRequest{record.traderId, record.symbolId, record.quantity, record.price,
+                                           static_cast<OrderSide>(record.side),
+                                           static_cast<OrderType>(record.orderType), record.stopPrice};
+            capture.messages.push_back(message);
+        }
+    }
+
+    Capture readCapture(const std::string &path)
+    {
+        char magic[sizeof(kJournalFileMagic)] = {};
+        std::ifstream(path, std::ios::binary).read(magic, sizeof(magic));
+
+        Capture capture;
+        if (std::memcmp(magic, kJournalFileMagic, sizeof(magic)) == 0)
+        {
+            readJournal(path, capture);
+        }
+        else
+        {
+            readCsv(path, capture);
+        }
+
+        for (const Message &message : capture.messages)
+        {
+            if (message.cancel)
+            {
+                continue;
+            }
+            const OrderRequest &request = message.request;
+            if (std::find(capture.traderIds.begin(), capture.traderIds.end(), request.traderId) ==
+                capture.traderIds.end())
+            {
+                capture.traderIds.push_back(request.traderId);
+            }
+            if (std::find(capture.symbols.begin(), capture.symbols.end(), request.symbolId) ==
+                capture.symbols.end())
+            {
+                capture.symbols.push_back(request.symbolId);
+            }
+        }
+        return capture;
+    }
+
+    // Books, balances and positions after the run
+    std::uint64_t hashState(const MatchingEngine &engine, const Capture &capture, std::uint64_t hash)
+    {
+        std::vector<DepthLevel> levels;
+        for (SymbolId symbol : capture.symbols)
+        {
+            auto orderBook = engine.getOrderBook(symbol);
+            mix(hash, SymbolRegistry::instance().name(symbol));
+            levels.resize(orderBook->getBidLevelCount() + orderBook->getAskLevelCount());
+            size_t bids = orderBook->getBidLevels(levels);
+            orderBook->getAskLevels(std::span<DepthLevel>(levels).subspan(bids));
+            mix(hash, static_cast<std::int64_t>(bids));
+            for (const DepthLevel &level : levels)
+            {
+                mix(hash, level.price);
+                mix(hash, level.quantity);
+                mix(hash, static_cast<std::int64_t>(level.orderCount));
+            }
+            mix(hash, static_cast<std::int64_t>(orderBook->getPendingStopCount()));
+        }
+        for (int traderId : capture.traderIds)
+        {
+            auto trader = engine.getTrader(traderId);
+            mix(hash, traderId);
+            mix(hash, trader->getCashUnits());
+            for (const Position &position : trader->getPositions())
+            {
+                mix(hash, SymbolRegistry::instance().name(position.symbolId));
+                mix(hash, position.quantity);
+            }
+        }
+        return hash;
+    }
+
+    RunResult run(const Capture &capture, bool paced, double cash, double shares)
+    {
+        MatchingEngine engine(capture.messages.size() + 1);
+        for (int traderId : capture.traderIds)
+        {
+            auto trader = std::make_shared<Trader>(traderId, "T" + std::to_string(traderId), cash);
+            for (SymbolId symbol : capture.symbols)
+            {
+                trader->onOrderFilled(SymbolRegistry::instance().name(symbol), shares, 0.0, true);
+            }
+            engine.registerTrader(trader);
+        }
+        for (SymbolId symbol : capture.symbols)
+        {
+            engine.getInstrument(symbol); // create books outside the timed loop
+        }
+        TradeHasher trades;
+        engine.addExecutionListener(&trades);
+
+        RunResult result{};
+        result.latencies.reserve(capture.messages.size());
+        std::unordered_map<int, int> engineIds; // capture order id -> engine order id
+        engineIds.reserve(capture.messages.size());
+        std::int64_t firstTime = capture.messages.empty() ? 0 : capture.messages.front().time;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const Message &message : capture.messages)
+        {
+            if (paced)
+            {
+                auto due = start + std::chrono::nanoseconds(message.time - firstTime);
+                while (std::chrono::steady_clock::now() < due)
+                {
+                }
+            }
+
+            auto sent = std::chrono::steady_clock::now();
+            bool accepted;
+            if (message.cancel)
+            {
+                auto it = engineIds.find(message.captureId);
+                accepted = it != engineIds.end() && engine.cancelOrder(it->second);
+            }
+            else
+            {
+                OrderResult orderResult;
+                engine.submitOrders(std::span<const OrderRequest>(&message.request, 1),
+                                    std::span<OrderResult>(&orderResult, 1));
+                accepted = orderResult.accepted;
+                if (accepted)
+                {
+                    engineIds[message.captureId] = orderResult.orderId;
+                }
+            }
+            result.latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::steady_clock::now() - sent)
+                                           .count());
+            ++(accepted ? result.accepted : result.rejected);
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        engine.removeExecutionListener(&trades);
+        result.trades = trades.getCount();
+        result.hash = hashState(engine, capture, trades.getHash());
+        return result;
+    }
+
+    void report(RunResult &result)
+    {
+        std::sort(result.latencies.begin(), result.latencies.end());
+        auto percentile = [&result](double p)
+        {
+            if (result.latencies.empty())
+            {
+                return std::int64_t(0);
+            }
+            size_t index = static_cast<size_t>(p * static_cast<double>(result.latencies.size() - 1));
+            return result.latencies[index];
+        };
+        double messages = static_cast<double>(result.latencies.size());
+
+        std::cout << std::fixed << std::setprecision(0)
+                  << messages << " messages (" << result.accepted << " accepted, " << result.rejected
+                  << " rejected), " << result.trades << " trades in " << std::setprecision(3)
+                  << result.seconds << " s\n"
+                  << std::setprecision(0) << "  " << messages / result.seconds << " orders/s, "
+                  << static_cast<double>(result.trades) / result.seconds << " trades/s\n"
+                  << "  latency ns: p50 " << percentile(0.5) << ", p90 " << percentile(0.9)
+                  << ", p99 " << percentile(0.99) << ", p99.9 " << percentile(0.999)
+                  << ", max " << (result.latencies.empty() ? 0 : result.latencies.back()) << '\n'
+                  << "  hash " << std::hex << std::setw(16) << std::setfill('0') << result.hash
+                  << std::dec << std::setfill(' ') << std::endl;
+    }
+
+    // A random walk around 100.00 on eight symbols: mostly limits near the
+    // mid, some market orders and cancels of earlier orders
+    void generate(const std::string &path, size_t count)
+    {
+        std::ofstream out(path);
+        if (!out)
+        {
+            throw std::runtime_error("cannot create capture");
+        }
+        out << "# time_ns,SUBMIT,order_id,trader_id,symbol,side,type,quantity,price,stop_price\n"
+            << "# time_ns,CANCEL,order_id\n"
+            << std::fixed << std::setprecision(2);
+
+        std::mt19937_64 rng(42);
+        std::vector<int> mids(8, 10000);
+        std::int64_t time = 0;
+        int nextId = 1;
+        for (size_t i = 0; i < count; ++i)
+        {
+            time += 200 + static_cast<std::int64_t>(rng() % 1600);
+            int roll = static_cast<int>(rng() % 100);
+            if (roll < 25 && nextId > 1)
+            {
+                int recent = std::min(nextId - 1, 1000);
+                out << time << ",CANCEL," << nextId - 1 - static_cast<int>(rng() % recent) << '\n';
+                continue;
+            }
+
+            size_t symbol = rng() % mids.size();
+            mids[symbol] = std::max(100, mids[symbol] + static_cast<int>(rng() % 5) - 2);
+            bool buy = rng() % 2;
+            OrderType type = roll < 30 ? OrderType::MARKET : OrderType::LIMIT;
+            int offset = static_cast<int>(rng() % 10);
+            double price = type == OrderType::MARKET ? 0.0 : (mids[symbol] + (buy ? -offset : offset)) / 100.0;
+            out << time << ",SUBMIT," << nextId++ << ',' << 1 + rng() % 50 << ",SYM" << symbol << ','
+                << (buy ? "BUY" : "SELL") << ',' << typeName(type) << ',' << (1 + rng() % 10) * 10 << ','
+                << price << ",0\n";
+        }
+    }
+
+    void usage(const char *program)
+    {
+        std::cerr << "usage: " << program << " <capture> [--paced] [--runs N] [--expect HASH]"
+                  << " [--cash X] [--shares N]\n"
+                  << "       " << program << " --generate <count> <capture.csv>" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    try
+    {
+        if (std::string(argv[1]) == "--generate")
+        {
+            if (argc != 4)
+            {
+                usage(argv[0]);
+                return 2;
+            }
+            generate(argv[3], std::strtoull(argv[2], nullptr, 10));
+            return 0;
+        }
+
+        bool paced = false;
+        int runs = 1;
+        std::string expected;
+        double cash = 1e12;
+        double shares = 1e9;
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--paced")
+            {
+                paced = true;
+            }
+            else if (arg == "--runs" && i + 1 < argc)
+            {
+                runs = std::max(1, std::atoi(argv[++i]));
+            }
+            else if (arg == "--expect" && i + 1 < argc)
+            {
+                expected = argv[++i];
+            }
+            else if (arg == "--cash" && i + 1 < argc)
+            {
+                cash = std::strtod(argv[++i], nullptr);
+            }
+            else if (arg == "--shares" && i + 1 < argc)
+            {
+                shares = std::strtod(argv[++i], nullptr);
+            }
+            else
+            {
+                std::cerr << "unknown argument " << arg << std::endl;
+                return 2;
+            }
+        }
+
+        Capture capture = readCapture(argv[1]);
+        std::uint64_t firstHash = 0;
+        for (int i = 0; i < runs; ++i)
+        {
+            RunResult result = run(capture, paced, cash, shares);
+            std::cout << "run " << i + 1 << ": ";
+            report(result);
+
+            if (i == 0)
+            {
+                firstHash = result.hash;
+            }
+            else if (result.hash != firstHash)
+            {
+                std::cerr << "hash differs from the first run" << std::endl;
+                return 1;
+            }
+        }
+        if (!expected.empty() && std::strtoull(expected.c_str(), nullptr, 16) != firstHash)
+        {
+            std::cerr << "hash does not match " << expected << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "MatchingEngine.hpp"
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+// A path in the temp directory with nothing at it yet
+inline std::string freshTempPath(const std::string &name)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+// Two books traded by three traders, for tests that rebuild an engine and
+// compare it with the one they started from. Each test file uses its own
+// symbols so their books do not share state.
+struct EngineTestMarket
+{
+    const char *first;
+    const char *second;
+
+    // The same traders and seed shares every time the engine starts
+    std::unique_ptr<MatchingEngine> startEngine() const
+    {
+        auto engine = std::make_unique<MatchingEngine>();
+        for (int traderId = 1; traderId <= 3; ++traderId)
+        {
+            engine->registerTrader(std::make_shared<Trader>(traderId, "T" + std::to_string(traderId), 1e7));
+            engine->getTrader(traderId)->onOrderFilled(first, 100000, 1.0, true);
+            engine->getTrader(traderId)->onOrderFilled(second, 100000, 1.0, true);
+        }
+        return engine;
+    }
+
+    // Everything a restart has to reproduce, flattened for comparison
+    std::vector<std::int64_t> describe(const MatchingEngine &engine) const
+    {
+        std::vector<std::int64_t> state;
+        for (const char *symbol : {first, second})
+        {
+            auto orderBook = engine.getOrderBook(symbol);
+            std::vector<DepthLevel> levels(orderBook->getBidLevelCount() + orderBook->getAskLevelCount());
+            size_t bids = orderBook->getBidLevels(levels);
+            size_t asks = orderBook->getAskLevels(std::span<DepthLevel>(levels).subspan(bids));
+            state.push_back(static_cast<std::int64_t>(bids));
+            state.push_back(static_cast<std::int64_t>(asks));
+            for (const DepthLevel &level : levels)
+            {
+                state.insert(state.end(), {level.price, level.quantity, static_cast<std::int64_t>(level.orderCount)});
+            }
+            const TradeStats &stats = orderBook->getStats();
+            state.insert(state.end(), {static_cast<std::int64_t>(stats.getTradeCount()), stats.getVolume(),
+                                       stats.getNotional(), stats.getHigh(), stats.getLow(), stats.getLast()});
+            state.push_back(static_cast<std::int64_t>(orderBook->getPendingStopCount()));
+        }
+        for (int traderId = 1; traderId <= 3; ++traderId)
+        {
+            auto trader = engine.getTrader(traderId);
+            const PositionLedger &ledger = trader->getPositions();
+            state.insert(state.end(), {trader->getCashUnits(), ledger.getCostBasis(), ledger.getNetExposure(),
+                                       ledger.getGrossExposure(), ledger.getRealizedPnL()});
+            for (const Position &position : ledger)
+            {
+                state.push_back(position.quantity);
+            }
+        }
+        state.push_back(static_cast<std::int64_t>(engine.getOrderPoolStats().inUse));
+        return state;
+    }
+
+    // Random limit, market, stop and cancel traffic; rejects are ignored.
+    // Stops are submitted as stopType, STOP_LIMIT ones limited at the stop.
+    void trade(MatchingEngine &engine, std::mt19937 &rng, int inputs, OrderType stopType) const
+    {
+        std::vector<int> orderIds;
+        for (int i = 0; i < inputs; ++i)
+        {
+            const char *symbol = rng() % 2 ? first : second;
+            int traderId = 1 + static_cast<int>(rng() % 3);
+            OrderSide side = rng() % 2 ? OrderSide::BUY : OrderSide::SELL;
+            double price = 9.5 + 0.1 * static_cast<int>(rng() % 10);
+            double stopLimit = stopType == OrderType::STOP_LIMIT ? price : 0.0;
+            try
+            {
+                switch (rng() % 10)
+                {
+                case 0:
+                    orderIds.push_back(engine.submitOrder(traderId, symbol, 5, 0.0, side, OrderType::MARKET));
+                    break;
+                case 1:
+                    orderIds.push_back(engine.submitOrder(traderId, symbol, 5, stopLimit, side, stopType, price));
+                    break;
+                case 2:
+                case 3:
+                    if (!orderIds.empty())
+                    {
+                        engine.cancelOrder(orderIds[rng() % orderIds.size()]);
+                    }
+                    break;
+                default:
+                    orderIds.push_back(engine.submitOrder(traderId, symbol, 1 + rng() % 20, price, side));
+                    break;
+                }
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+    }
+};
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include <limits>
+#include <memory>
+#include <vector>
+
+class BatchEntryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        engine.registerTrader(std::make_shared<Trader>(1, "Alice", 10000.0));
+        engine.registerTrader(std::make_shared<Trader>(2, "Bob", 10000.0));
+        engine.getTrader(2)->onOrderFilled("BATCH_X", 100, 1.0, true);
+        engine.getTrader(2)->onOrderFilled("BATCH_Y", 100, 1.0, true);
+    }
+
+    MatchingEngine engine;
+    SymbolId x = SymbolRegistry::instance().intern("BATCH_X");
+    SymbolId y = SymbolRegistry::instance().intern("BATCH_Y");
+};
+
+TEST_F(BatchEntryTest, ResultsLineUpWithRequests)
+{
+    // Interleaved books; within each book the sell must rest before the buy
+    std::vector<OrderRequest> requests = {
+        {2, y, 50, 10.0, OrderSide::SELL},
+        {2, x, 40, 20.0, OrderSide::SELL},
+        {99, x, 10, 20.0, OrderSide::BUY},
+        {1, y, 50, 10.0, OrderSide::BUY},
+        {1, x, 10, 20.005, OrderSide::BUY},
+        {1, x, 40, 20.0, OrderSide::BUY},
+    };
+    std::vector<OrderResult> results(requests.size());
+
+    EXPECT_EQ(engine.submitOrders(requests, results), 4);
+
+    EXPECT_TRUE(results[0].accepted);
+    EXPECT_TRUE(results[1].accepted);
+    EXPECT_FALSE(results[2].accepted);
+    EXPECT_EQ(results[2].reason, RejectReason::UNKNOWN_TRADER);
+    EXPECT_TRUE(results[3].accepted);
+    EXPECT_FALSE(results[4].accepted);
+    EXPECT_EQ(results[4].reason, RejectReason::INVALID_PRICE);
+    EXPECT_TRUE(results[5].accepted);
+
+    EXPECT_EQ(engine.getOrderBook(x)->getTradeCount(), 1);
+    EXPECT_EQ(engine.getOrderBook(y)->getTradeCount(), 1);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+    EXPECT_DOUBLE_EQ(engine.getTrader(1)->getCash(), 10000.0 - 800.0 - 500.0);
+}
+
+TEST_F(BatchEntryTest, CancelBatch)
+{
+    std::vector<OrderRequest> requests = {
+        {1, x, 10, 5.0, OrderSide::BUY},
+        {1, x, 10, 6.0, OrderSide::BUY},
+    };
+    std::vector<OrderResult> results(2);
+    ASSERT_EQ(engine.submitOrders(requests, results), 2);
+
+    std::vector<int> ids = {results[1].orderId, 12345, results[0].orderId};
+    std::vector<OrderResult> cancels(ids.size());
+    EXPECT_EQ(engine.cancelOrders(ids, cancels), 2);
+    EXPECT_TRUE(cancels[0].accepted);
+    EXPECT_FALSE(cancels[1].accepted);
+    EXPECT_EQ(cancels[1].reason, RejectReason::UNKNOWN_ORDER);
+    EXPECT_TRUE(cancels[2].accepted);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+}
+
+TEST_F(BatchEntryTest, ShortResultBufferThrows)
+{
+    std::vector<OrderRequest> requests(2, OrderRequest{1, x, 10, 5.0, OrderSide::BUY});
+    std::vector<OrderResult> results(1);
+    EXPECT_THROW(engine.submitOrders(requests, results), std::invalid_argument);
+}
+
+TEST_F(BatchEntryTest, SingleEntryReportsRejectsWithoutThrowing)
+{
+    auto submit = [this](const OrderRequest &request)
+    {
+        OrderResult result{};
+        EXPECT_NO_THROW(result = engine.submitOrder(request));
+        return result;
+    };
+
+    EXPECT_EQ(submit({99, x, 10, 5.0, OrderSide::BUY}).reason, RejectReason::UNKNOWN_TRADER);
+    EXPECT_EQ(submit({1, kInvalidSymbolId, 10, 5.0, OrderSide::BUY}).reason, RejectReason::UNKNOWN_SYMBOL);
+    EXPECT_EQ(submit({1, x, 0, 5.0, OrderSide::BUY}).reason, RejectReason::INVALID_QUANTITY);
+    EXPECT_EQ(submit({1, x, 2.5, 5.0, OrderSide::BUY}).reason, RejectReason::INVALID_QUANTITY);
+    EXPECT_EQ(submit({1, x, 10, 0.0, OrderSide::BUY}).reason, RejectReason::INVALID_PRICE);
+    EXPECT_EQ(submit({1, x, 10, 0.0, OrderSide::BUY, OrderType::STOP}).reason, RejectReason::INVALID_PRICE);
+    EXPECT_EQ(submit({1, x, 10000, 5.0, OrderSide::BUY}).reason, RejectReason::INSUFFICIENT_CASH);
+    EXPECT_EQ(submit({1, x, 10, 5.0, OrderSide::SELL}).reason, RejectReason::INSUFFICIENT_SHARES);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+
+    OrderResult accepted = submit({1, x, 10, 5.0, OrderSide::BUY});
+    EXPECT_TRUE(accepted.accepted);
+    EXPECT_NE(engine.getOrder(accepted.orderId), nullptr);
+
+    // The throwing form still throws
+    EXPECT_THROW(engine.submitOrder(1, kInvalidSymbolId, 10, 5.0, OrderSide::BUY), std::invalid_argument);
+}
+
+TEST_F(BatchEntryTest, OversizedOrdersGetRejectCodes)
+{
+    Instrument instrument("BATCH_BIG", 4, 1, 1000);
+    instrument.maxLots = 1'000'000'000;
+    engine.defineInstrument(instrument);
+    SymbolId big = instrument.symbolId;
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    double inf = std::numeric_limits<double>::infinity();
+
+    // Limits on each field, then the notional of fields that are each in
+    // range: 10^12 shares at 1000.0000 does not fit in Cash
+    std::vector<OrderRequest> requests = {
+        {1, big, 1e12 + 1000, 1.0, OrderSide::BUY},
+        {1, big, inf, 1.0, OrderSide::BUY},
+        {1, big, nan, 1.0, OrderSide::SELL, OrderType::MARKET},
+        {1, big, 1000, 1e300, OrderSide::BUY},
+        {1, big, 1000, nan, OrderSide::BUY},
+        {1, big, 1000, 0.0, OrderSide::BUY, OrderType::STOP, -inf},
+        {1, big, 1e12, 1000.0, OrderSide::BUY},
+        {2, big, 1e12, 1000.0, OrderSide::SELL},
+        {1, big, 1e12, 0.0, OrderSide::BUY, OrderType::STOP_LIMIT, 1000.0},
+        {1, big, 1e9, 1000.0, OrderSide::BUY},
+    };
+    std::vector<OrderResult> results(requests.size());
+    ASSERT_NO_THROW(engine.submitOrders(requests, results));
+
+    std::vector<RejectReason> expected = {
+        RejectReason::INVALID_QUANTITY, RejectReason::INVALID_QUANTITY, RejectReason::INVALID_QUANTITY,
+        RejectReason::INVALID_PRICE, RejectReason::INVALID_PRICE, RejectReason::INVALID_PRICE,
+        RejectReason::INVALID_QUANTITY, RejectReason::INVALID_QUANTITY, RejectReason::INVALID_PRICE,
+        RejectReason::INSUFFICIENT_CASH,
+    };
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        EXPECT_FALSE(results[i].accepted) << i;
+        EXPECT_EQ(results[i].reason, expected[i]) << i;
+
+        OrderResult single{};
+        ASSERT_NO_THROW(single = engine.submitOrder(requests[i])) << i;
+        EXPECT_EQ(single.reason, expected[i]) << i;
+    }
+    EXPECT_EQ(engine.getRiskAccount(1)->reservedCash, 0);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+}
+
+TEST(OrderValidationTest, ValidateMatchesTheConstructor)
+{
+    EXPECT_EQ(Order::validate(10, 100, OrderType::LIMIT, 0), std::nullopt);
+    EXPECT_EQ(Order::validate(10, 0, OrderType::MARKET, 0), std::nullopt);
+    EXPECT_EQ(Order::validate(10, 0, OrderType::STOP, 90), std::nullopt);
+    EXPECT_EQ(Order::validate(0, 100, OrderType::LIMIT, 0), RejectReason::INVALID_QUANTITY);
+    EXPECT_EQ(Order::validate(10, 0, OrderType::LIMIT, 0), RejectReason::INVALID_PRICE);
+    EXPECT_EQ(Order::validate(10, 100, OrderType::STOP_LIMIT, 0), RejectReason::INVALID_PRICE);
+    EXPECT_THROW(Order(1, 1, 0, 10, 0, OrderSide::BUY), std::invalid_argument);
+}
+
+TEST(OrderValidationTest, TraderRefusesFillsItCannotSettle)
+{
+    Trader trader(1, "Trader", 100.0);
+    EXPECT_FALSE(trader.onOrderFilled("BATCH_X", 20, 10.0, true));
+    EXPECT_FALSE(trader.onOrderFilled("BATCH_X", 1, 10.0, false));
+    EXPECT_DOUBLE_EQ(trader.getCash(), 100.0);
+
+    EXPECT_TRUE(trader.onOrderFilled("BATCH_X", 10, 10.0, true));
+    EXPECT_FALSE(trader.onOrderFilled("BATCH_X", 11, 10.0, false));
+    EXPECT_TRUE(trader.onOrderFilled("BATCH_X", 10, 10.0, false));
+    EXPECT_DOUBLE_EQ(trader.getCash(), 100.0);
+}
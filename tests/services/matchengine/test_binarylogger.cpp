@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "BinaryLogger.hpp"
+#include "MatchingEngine.hpp"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+static std::string logPath(const std::string &name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::string decodeFile(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream text;
+    LogDecoder decoder;
+    decoder.decode(in, text);
+    return text.str();
+}
+
+TEST(BinaryLoggerTest, EngineTradesDecodeToText)
+{
+    std::string path = logPath("matchengine_engine.log");
+    {
+        MatchingEngine engine;
+        engine.defineInstrument(Instrument("LOGD", 2, 5, 10));
+        engine.enableLogging(path);
+        engine.registerTrader(std::make_shared<Trader>(1, "Alice", 100000.0));
+        engine.registerTrader(std::make_shared<Trader>(2, "Bob", 100000.0));
+        engine.getTrader(2)->onOrderFilled("LOGD", 100, 1.0, true);
+
+        engine.submitOrder(2, "LOGD", 100, 12.35, OrderSide::SELL);
+        engine.submitOrder(1, "LOGD", 100, 12.35, OrderSide::BUY);
+        EXPECT_THROW(engine.submitOrder(1, "LOGD", 5, 12.35, OrderSide::BUY), std::invalid_argument);
+
+        engine.getLogger()->flush();
+        EXPECT_EQ(engine.getLogger()->getWrittenCount(), 3); // instrument, trade, reject
+        EXPECT_EQ(engine.getLogger()->getDroppedCount(), 0);
+    }
+
+    std::string text = decodeFile(path);
+    EXPECT_NE(text.find("INFO INSTRUMENT LOGD | Scale: 2 | Tick: 5 | Lot: 10"), std::string::npos) << text;
+    EXPECT_NE(text.find("INFO TRADE LOGD | Qty: 100 | Price: $12.35 | Buyer: 1 | Seller: 2"), std::string::npos) << text;
+    EXPECT_NE(text.find("WARN REJECTED LOGD | Trader: 1 | BUY"), std::string::npos) << text;
+    EXPECT_NE(text.find("STATS | Logged: 3 | Dropped: 0"), std::string::npos) << text;
+
+    // Lifecycle events are DEBUG and were filtered at runtime
+    EXPECT_EQ(text.find("ACCEPTED"), std::string::npos);
+}
+
+TEST(BinaryLoggerTest, RuntimeLevelFilters)
+{
+    std::string path = logPath("matchengine_levels.log");
+    {
+        BinaryLogger logger(path, LogLevel::WARN);
+        logger.log<LogLevel::INFO>(LogEvent::TRADE, kInvalidSymbolId);
+        logger.log<LogLevel::ERROR>(LogEvent::ORDER_REJECTED, kInvalidSymbolId);
+        EXPECT_EQ(logger.getLoggedCount(), 1);
+
+        logger.setLevel(LogLevel::DEBUG);
+        logger.log<LogLevel::DEBUG>(LogEvent::ORDER_ACCEPTED, kInvalidSymbolId);
+        EXPECT_EQ(logger.getLoggedCount(), 2);
+    }
+    EXPECT_NE(decodeFile(path).find("STATS | Logged: 2 | Dropped: 0"), std::string::npos);
+}
+
+TEST(BinaryLoggerTest, FullRingDropsAndCounts)
+{
+    std::string path = logPath("matchengine_drops.log");
+    {
+        // The writer drains at most once while the ring is being flooded
+        BinaryLogger logger(path, LogLevel::DEBUG, 4, std::chrono::milliseconds(200));
+        for (int i = 0; i < 100; ++i)
+        {
+            logger.log<LogLevel::INFO>(LogEvent::TRADE, kInvalidSymbolId, 0, i);
+        }
+        EXPECT_GT(logger.getDroppedCount(), 0);
+        EXPECT_EQ(logger.getLoggedCount() + logger.getDroppedCount(), 100);
+    }
+}
+
+TEST(BinaryLoggerTest, DecoderRejectsOtherFiles)
+{
+    std::istringstream in("not a log file at all");
+    std::ostringstream out;
+    LogDecoder decoder;
+    EXPECT_THROW(decoder.decode(in, out), std::runtime_error);
+}
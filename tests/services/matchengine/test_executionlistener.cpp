@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "ExecutionListener.hpp"
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Records every event as a short line so tests can compare whole sequences
+class RecordingListener : public ExecutionListener
+{
+public:
+    std::vector<std::string> events;
+
+    void onOrderAccepted(const OrderAcceptedEvent &event) override
+    {
+        events.push_back("accepted " + std::to_string(event.orderId));
+    }
+    void onOrderRejected(const OrderRejectedEvent &event) override
+    {
+        events.push_back("rejected " + std::to_string(static_cast<int>(event.reason)));
+    }
+    void onOrderPartiallyFilled(const OrderFillEvent &event) override
+    {
+        events.push_back("partial " + describe(event));
+    }
+    void onOrderFilled(const OrderFillEvent &event) override
+    {
+        events.push_back("filled " + describe(event));
+    }
+    void onOrderCancelled(const OrderCancelledEvent &event) override
+    {
+        events.push_back("cancelled " + std::to_string(event.orderId) + " " +
+                         std::to_string(event.cancelledQuantity));
+    }
+    void onTrade(const Trade &trade) override
+    {
+        events.push_back("trade " + std::to_string(trade.buyOrderId) + "/" +
+                         std::to_string(trade.sellOrderId) + " " + std::to_string(trade.quantity) +
+                         "@" + std::to_string(trade.price));
+    }
+
+private:
+    static std::string describe(const OrderFillEvent &event)
+    {
+        return std::to_string(event.orderId) + " " + std::to_string(event.fillQuantity) + "@" +
+               std::to_string(event.fillPrice) + " left " + std::to_string(event.remainingQuantity) +
+               (event.aggressor ? " aggressor" : "");
+    }
+};
+
+// Bound at compile time: only trades and stop triggers are handled, and
+// every triggered stop is refused
+struct TradeCountingListener : StaticExecutionListener
+{
+    std::vector<std::string> events;
+
+    void onTrade(const Trade &trade)
+    {
+        events.push_back("trade " + std::to_string(trade.quantity) + "@" + std::to_string(trade.price));
+    }
+    bool onStopTriggered(const StopTriggeredEvent &event)
+    {
+        events.push_back("stop " + std::to_string(event.orderId));
+        return false;
+    }
+};
+
+static const SymbolId kEvt = SymbolRegistry::instance().intern("EVT");
+
+TEST(ExecutionListenerTest, BookReportsTradeThenRestingThenIncomingFill)
+{
+    OrderBook book(Instrument("EVT"));
+    RecordingListener listener;
+    book.setExecutionListener(&listener);
+
+    Order sell1(1, 10, kEvt, 30, 10000, OrderSide::SELL);
+    Order sell2(2, 11, kEvt, 50, 10100, OrderSide::SELL);
+    Order buy(3, 12, kEvt, 60, 10100, OrderSide::BUY);
+    book.addOrder(&sell1);
+    book.addOrder(&sell2);
+    book.addOrder(&buy);
+    EXPECT_TRUE(book.cancelOrder(&sell2));
+
+    std::vector<std::string> expected = {
+        "accepted 1",
+        "accepted 2",
+        "accepted 3",
+        "trade 3/1 30@10000",
+        "filled 1 30@10000 left 0",
+        "partial 3 30@10000 left 30 aggressor",
+        "trade 3/2 30@10100",
+        "partial 2 30@10100 left 20",
+        "filled 3 30@10100 left 0 aggressor",
+        "cancelled 2 20",
+    };
+    EXPECT_EQ(listener.events, expected);
+}
+
+TEST(ExecutionListenerTest, StaticListenerIsCalledDirectly)
+{
+    BasicOrderBook<TradeCountingListener> book(Instrument("EVT"));
+    TradeCountingListener listener;
+    book.setExecutionListener(&listener);
+
+    Order sell1(1, 10, kEvt, 30, 10000, OrderSide::SELL);
+    Order sell2(2, 11, kEvt, 50, 10100, OrderSide::SELL);
+    Order stop(3, 12, kEvt, 20, 0, OrderSide::BUY, OrderType::STOP, 10000);
+    Order buy(4, 13, kEvt, 30, 10000, OrderSide::BUY);
+    book.addOrder(&sell1);
+    book.addOrder(&sell2);
+    book.addOrder(&stop);
+    book.addOrder(&buy);
+
+    // The refused stop was cancelled rather than run against sell2
+    std::vector<std::string> expected = {"trade 30@10000", "stop 3"};
+    EXPECT_EQ(listener.events, expected);
+    EXPECT_FALSE(book.hasOrder(&stop));
+    EXPECT_EQ(book.getPendingStopCount(), 0);
+    EXPECT_TRUE(book.hasOrder(&sell2));
+}
+
+TEST(ExecutionListenerTest, EngineForwardsEventsAndRejects)
+{
+    MatchingEngine engine;
+    RecordingListener listener;
+    engine.addExecutionListener(&listener);
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 1000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 1000.0));
+    engine.getTrader(2)->onOrderFilled("EVT", 10, 1.0, true);
+
+    EXPECT_THROW(engine.submitOrder(99, kEvt, 10, 1.0, OrderSide::BUY), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(1, kEvt, 10000, 1.0, OrderSide::BUY), std::runtime_error);
+
+    int sellId = engine.submitOrder(2, kEvt, 10, 1.0, OrderSide::SELL);
+    int buyId = engine.submitOrder(1, kEvt, 10, 1.0, OrderSide::BUY);
+
+    std::vector<std::string> expected = {
+        "rejected " + std::to_string(static_cast<int>(RejectReason::UNKNOWN_TRADER)),
+        "rejected " + std::to_string(static_cast<int>(RejectReason::INSUFFICIENT_CASH)),
+        "accepted " + std::to_string(sellId),
+        "accepted " + std::to_string(buyId),
+        "trade " + std::to_string(buyId) + "/" + std::to_string(sellId) + " 10@100",
+        "filled " + std::to_string(sellId) + " 10@100 left 0",
+        "filled " + std::to_string(buyId) + " 10@100 left 0 aggressor",
+    };
+    EXPECT_EQ(listener.events, expected);
+
+    // Traders were settled and both slots went back to the pool
+    EXPECT_DOUBLE_EQ(engine.getTrader(1)->getCash(), 990.0);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+
+    engine.removeExecutionListener(&listener);
+    engine.submitOrder(1, kEvt, 1, 0.5, OrderSide::BUY);
+    EXPECT_EQ(listener.events.size(), expected.size());
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "EngineTestMarket.hpp"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const EngineTestMarket kMarket{"JRNL_A", "JRNL_B"};
+
+TEST(JournalTest, ReplayRebuildsIdenticalState)
+{
+    std::string path = freshTempPath("matchengine_replay.journal");
+    std::vector<std::int64_t> before;
+    size_t records = 0;
+    {
+        auto engine = kMarket.startEngine();
+        EXPECT_EQ(engine->enableJournal(path, JournalConfig{16, std::chrono::microseconds(100), true}), 0);
+
+        // Rejects are not journaled and must not matter to replay
+        std::mt19937 rng(11);
+        kMarket.trade(*engine, rng, 3000, OrderType::STOP);
+        engine->submitOrder(1, "JRNL_A", 1, 9.99, OrderSide::BUY); // rejected: off tick
+
+        engine->getJournal()->commit();
+        EXPECT_EQ(engine->getJournal()->getDurableSequence(), engine->getJournal()->getLastSequence());
+        EXPECT_GT(engine->getJournal()->getGroupCount(), 1);
+        records = engine->getJournal()->getLastSequence();
+        before = kMarket.describe(*engine);
+    }
+
+    auto restarted = kMarket.startEngine();
+    size_t replayed = restarted->enableJournal(path);
+    EXPECT_GT(replayed, 1000);
+    EXPECT_EQ(restarted->getJournal()->getLastSequence(), records);
+    EXPECT_EQ(kMarket.describe(*restarted), before);
+
+    // Ids carry on where the journal left off
+    int next = restarted->submitOrder(2, "JRNL_B", 1, 5.0, OrderSide::BUY);
+    restarted->getJournal()->commit();
+    restarted.reset();
+
+    auto again = kMarket.startEngine();
+    EXPECT_EQ(again->enableJournal(path), replayed + 1);
+    ASSERT_NE(again->getOrder(next), nullptr);
+    std::filesystem::remove(path);
+}
+
+TEST(JournalTest, TornTailIsCutOffAndAppendsContinue)
+{
+    std::string path = freshTempPath("matchengine_torn.journal");
+    {
+        auto engine = kMarket.startEngine();
+        engine->enableJournal(path);
+        engine->submitOrder(1, "JRNL_A", 10, 10.0, OrderSide::BUY);
+        engine->submitOrder(2, "JRNL_A", 10, 11.0, OrderSide::SELL);
+    }
+    auto goodSize = std::filesystem::file_size(path);
+    {
+        // A crash halfway through the next record
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out << std::string(sizeof(JournalRecord) / 2, '\x7f');
+    }
+
+    JournalReader reader(path);
+    JournalRecord record;
+    int count = 0;
+    while (reader.next(record))
+    {
+        ++count;
+    }
+    EXPECT_EQ(count, 2);
+    EXPECT_EQ(reader.getLastSequence(), 3); // the symbol record plus two orders
+    EXPECT_EQ(reader.getValidSize(), goodSize);
+
+    {
+        auto engine = kMarket.startEngine();
+        EXPECT_EQ(engine->enableJournal(path), 2);
+        EXPECT_EQ(std::filesystem::file_size(path), goodSize);
+        engine->submitOrder(3, "JRNL_A", 5, 10.0, OrderSide::SELL);
+    }
+    auto engine = kMarket.startEngine();
+    EXPECT_EQ(engine->enableJournal(path), 3);
+    EXPECT_EQ(engine->getOrderBook("JRNL_A")->getTradeCount(), 1);
+    std::filesystem::remove(path);
+}
+
+TEST(JournalTest, GroupsCommitOnSizeDelayOrRequest)
+{
+    std::string path = freshTempPath("matchengine_groups.journal");
+    SymbolId symbol = SymbolRegistry::instance().intern("JRNL_A");
+    {
+        Journal journal(path, JournalConfig{4, std::chrono::seconds(10), false});
+        for (int i = 1; i <= 8; ++i)
+        {
+            journal.appendCancel(i);
+        }
+        // A full group goes out without being asked
+        while (journal.getDurableSequence() < 4)
+        {
+            std::this_thread::yield();
+        }
+        journal.appendSubmit(OrderRequest{1, symbol, 1, 1.0, OrderSide::BUY}, 9);
+        journal.commit();
+        EXPECT_EQ(journal.getDurableSequence(), 10);
+    }
+    {
+        Journal journal(path, JournalConfig{1000, std::chrono::microseconds(100), false}, 11);
+        journal.appendCancel(10);
+        while (journal.getDurableSequence() < 11)
+        {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(journal.getGroupCount(), 1);
+    }
+
+    JournalReader reader(path);
+    JournalRecord record;
+    int count = 0;
+    while (reader.next(record))
+    {
+        ++count;
+    }
+    EXPECT_EQ(count, 10);
+    EXPECT_EQ(reader.getLastSequence(), 11);
+    std::filesystem::remove(path);
+}
+
+TEST(JournalTest, FullRingWaitsForTheWriterAndKeepsEveryRecord)
+{
+    std::string path = freshTempPath("matchengine_small_ring.journal");
+    SymbolId symbol = SymbolRegistry::instance().intern("JRNL_RING");
+    {
+        JournalConfig config;
+        config.groupSize = 8;
+        config.sync = false;
+        config.capacity = 4;
+        Journal journal(path, config);
+        for (int i = 1; i <= 1000; ++i)
+        {
+            journal.appendSubmit(OrderRequest{1, symbol, 1, 1.0, OrderSide::BUY}, i);
+        }
+        journal.commit();
+        EXPECT_EQ(journal.getDurableSequence(), 1001); // and one SYMBOL record
+        EXPECT_GT(journal.getStallCount(), 0);
+    }
+
+    JournalReader reader(path);
+    JournalRecord record;
+    int expected = 1;
+    while (reader.next(record))
+    {
+        EXPECT_EQ(record.orderId, expected++);
+        EXPECT_EQ(record.symbolId, symbol);
+    }
+    EXPECT_EQ(expected, 1001);
+    std::filesystem::remove(path);
+}
+
+TEST(JournalTest, ReplayIntoDifferentSetupFails)
+{
+    std::string path = freshTempPath("matchengine_diverge.journal");
+    {
+        auto engine = kMarket.startEngine();
+        engine->enableJournal(path);
+        engine->submitOrder(3, "JRNL_B", 10, 10.0, OrderSide::BUY);
+    }
+    MatchingEngine bare;
+    EXPECT_THROW(bare.enableJournal(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <random>
+#include <sstream>
+
+TEST(LatencyHistogramTest, BucketsBoundValuesWithinThreePercent)
+{
+    std::mt19937_64 rng(3);
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::uint64_t value = rng() >> (rng() % 64);
+        size_t bucket = LatencyHistogram::bucketIndex(value);
+        ASSERT_LT(bucket, LatencyHistogram::kBucketCount);
+        std::uint64_t limit = LatencyHistogram::bucketLimit(bucket);
+        ASSERT_GE(limit, value);
+        ASSERT_LE(static_cast<double>(limit - value), 0.032 * static_cast<double>(value));
+        if (bucket > 0)
+        {
+            ASSERT_LT(LatencyHistogram::bucketLimit(bucket - 1), value);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketIndex(~std::uint64_t(0)), LatencyHistogram::kBucketCount - 1);
+}
+
+class LatencyProfilerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        if (!kLatencyProfilingCompiled)
+        {
+            GTEST_SKIP() << "built with MATCHENGINE_LATENCY_PROFILING=0";
+        }
+        engine.registerTrader(std::make_shared<Trader>(1, "Buyer", 1e6));
+        engine.registerTrader(std::make_shared<Trader>(2, "Seller", 1e6));
+        engine.getTrader(2)->onOrderFilled("PROF", 1000, 1.0, true);
+    }
+
+    void trade(int pairs)
+    {
+        for (int i = 0; i < pairs; ++i)
+        {
+            engine.submitOrder(2, "PROF", 1, 10.0, OrderSide::SELL);
+            engine.submitOrder(1, "PROF", 1, 10.0, OrderSide::BUY);
+        }
+    }
+
+    static const LatencySummary &stage(const std::vector<LatencySummary> &summaries, LatencyStage stage)
+    {
+        return summaries[static_cast<size_t>(stage)];
+    }
+
+    MatchingEngine engine;
+};
+
+TEST_F(LatencyProfilerTest, RecordsEveryStageOnlyWhileEnabled)
+{
+    trade(10);
+    EXPECT_EQ(stage(engine.getLatencyProfiler().snapshot(), LatencyStage::TOTAL).count, 0);
+
+    engine.enableLatencyProfiling(true);
+    trade(50);
+    EXPECT_THROW(engine.submitOrder(1, "PROF", 1, 10.001, OrderSide::BUY), std::invalid_argument);
+    std::vector<LatencySummary> summaries = engine.getLatencyProfiler().snapshot();
+    for (LatencyStage s : {LatencyStage::BOOK_LOOKUP, LatencyStage::VALIDATE, LatencyStage::CREATE,
+                           LatencyStage::MATCH, LatencyStage::RELEASE, LatencyStage::PUBLISH,
+                           LatencyStage::TOTAL})
+    {
+        EXPECT_EQ(stage(summaries, s).count, s == LatencyStage::BOOK_LOOKUP ? 101 : 100)
+            << LatencyProfiler::stageName(s);
+    }
+    EXPECT_EQ(stage(summaries, LatencyStage::SETTLE).count, 50);
+
+    const LatencySummary &total = stage(summaries, LatencyStage::TOTAL);
+    EXPECT_GT(total.p50, 0.0);
+    EXPECT_LE(total.p50, total.p99);
+    EXPECT_LE(total.p99, total.p999);
+    EXPECT_LE(total.p999, total.max);
+    EXPECT_GE(total.max, stage(summaries, LatencyStage::MATCH).p50);
+
+    engine.enableLatencyProfiling(false);
+    trade(10);
+    EXPECT_EQ(stage(engine.getLatencyProfiler().snapshot(), LatencyStage::TOTAL).count, 100);
+}
+
+TEST_F(LatencyProfilerTest, ResetStartsANewWindow)
+{
+    engine.enableLatencyProfiling(true);
+    trade(20);
+    std::vector<LatencySummary> before = engine.getLatencyProfiler().snapshot(true);
+    EXPECT_EQ(stage(before, LatencyStage::TOTAL).count, 40);
+    EXPECT_EQ(stage(engine.getLatencyProfiler().snapshot(), LatencyStage::TOTAL).count, 0);
+
+    trade(5);
+    EXPECT_EQ(stage(engine.getLatencyProfiler().snapshot(), LatencyStage::TOTAL).count, 10);
+
+    std::ostringstream out;
+    engine.getLatencyProfiler().print(out);
+    EXPECT_NE(out.str().find("MATCH"), std::string::npos);
+    EXPECT_EQ(out.str().find("BOOK_LOOKUP"), out.str().rfind("BOOK_LOOKUP"));
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static std::string feedPath(const std::string &name)
+{
+    std::filesystem::path directory = std::filesystem::exists("/dev/shm") ? std::filesystem::path("/dev/shm")
+                                                                           : std::filesystem::temp_directory_path();
+    return (directory / (name + "." + std::to_string(::getpid()))).string();
+}
+
+static std::vector<FeedMessage> drain(MarketDataReader &reader)
+{
+    std::vector<FeedMessage> messages;
+    FeedMessage message;
+    while (reader.poll(message))
+    {
+        messages.push_back(message);
+    }
+    return messages;
+}
+
+TEST(MarketDataFeedTest, EnginePublishesInstrumentLevelsTopAndTrades)
+{
+    std::string path = feedPath("matchengine_feed_engine");
+    MatchingEngine engine;
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 10000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 10000.0));
+    engine.getTrader(2)->onOrderFilled("FEED_A", 100, 1.0, true);
+    engine.defineInstrument(Instrument("FEED_A"));
+    engine.enableMarketDataFeed(path, 64);
+
+    MarketDataReader reader(path, true);
+    engine.submitOrder(2, "FEED_A", 30, 10.0, OrderSide::SELL);
+    engine.submitOrder(1, "FEED_A", 10, 10.0, OrderSide::BUY);
+
+    std::vector<FeedMessage> messages = drain(reader);
+    std::vector<FeedMessageType> expected = {
+        FeedMessageType::INSTRUMENT,   FeedMessageType::LEVEL_UPDATE, FeedMessageType::TOP_OF_BOOK,
+        FeedMessageType::TRADE,        FeedMessageType::LEVEL_UPDATE, FeedMessageType::TOP_OF_BOOK};
+    ASSERT_EQ(messages.size(), expected.size());
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        EXPECT_EQ(messages[i].sequence, i + 1);
+        EXPECT_EQ(messages[i].type, expected[i]) << "message " << i;
+    }
+    EXPECT_EQ(std::string(reinterpret_cast<const char *>(messages[0].fields)), "FEED_A");
+
+    const FeedMessage &added = messages[1];
+    EXPECT_EQ(static_cast<OrderSide>(added.side), OrderSide::SELL);
+    EXPECT_EQ(static_cast<LevelAction>(added.action), LevelAction::ADD);
+    EXPECT_EQ(added.fields[0], 1000);
+    EXPECT_EQ(added.fields[1], 30);
+
+    const FeedMessage &trade = messages[3];
+    EXPECT_EQ(trade.fields[0], 1000);
+    EXPECT_EQ(trade.fields[1], 10);
+
+    const FeedMessage &top = messages[5];
+    EXPECT_EQ(top.fields[0], 0);
+    EXPECT_EQ(top.fields[2], 1000);
+    EXPECT_EQ(top.fields[3], 20);
+    EXPECT_EQ(reader.getMissedCount(), 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST(MarketDataFeedTest, LappedReaderSkipsAheadAndCountsTheGap)
+{
+    std::string path = feedPath("matchengine_feed_lap");
+    MarketDataPublisher publisher(path, 8);
+    MarketDataReader reader(path);
+
+    for (int i = 1; i <= 20; ++i)
+    {
+        publisher.onTrade(Trade(i, i, 1, 2, 0, i, 100));
+    }
+
+    std::vector<FeedMessage> messages = drain(reader);
+    ASSERT_EQ(messages.size(), 8);
+    EXPECT_EQ(messages.front().sequence, 13);
+    EXPECT_EQ(messages.front().fields[1], 13);
+    EXPECT_EQ(messages.back().sequence, 20);
+    EXPECT_EQ(reader.getMissedCount(), 12);
+    EXPECT_EQ(reader.getNextSequence(), 21);
+
+    // A reader joining now starts after the last message
+    MarketDataReader late(path);
+    FeedMessage message;
+    EXPECT_FALSE(late.poll(message));
+
+    std::filesystem::remove(path);
+}
+
+TEST(MarketDataFeedTest, ConcurrentReaderNeverSeesTornMessages)
+{
+    constexpr int kMessages = 200000;
+    std::string path = feedPath("matchengine_feed_torn");
+    MarketDataPublisher publisher(path, 1024);
+    MarketDataReader reader(path);
+
+    std::thread producer([&publisher]()
+    {
+        for (int i = 1; i <= kMessages; ++i)
+        {
+            // Quantity and both order ids always agree within one message
+            publisher.onTrade(Trade(i, i, 1, 2, 0, i, 100));
+        }
+    });
+
+    std::uint64_t received = 0;
+    std::uint64_t lastSequence = 0;
+    FeedMessage message;
+    while (lastSequence < kMessages)
+    {
+        if (!reader.poll(message))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_GT(message.sequence, lastSequence);
+        ASSERT_EQ(message.fields[1], static_cast<std::int64_t>(message.sequence));
+        ASSERT_EQ(message.fields[2], message.fields[1]);
+        ASSERT_EQ(message.fields[3], message.fields[1]);
+        lastSequence = message.sequence;
+        ++received;
+    }
+    producer.join();
+
+    EXPECT_EQ(received + reader.getMissedCount(), static_cast<std::uint64_t>(kMessages));
+    std::filesystem::remove(path);
+}
+
+TEST(MarketDataFeedTest, ReaderThatKeepsUpMissesNothing)
+{
+    constexpr int kMessages = 500000;
+    constexpr std::uint64_t kCapacity = 64;
+    std::string path = feedPath("matchengine_feed_keepup");
+    MarketDataPublisher publisher(path, kCapacity);
+    MarketDataReader reader(path);
+    std::atomic<std::uint64_t> consumed{0};
+
+    // The publisher stays within half a ring of the reader, so no slot is
+    // reused before it has been read; the reader still races every write
+    std::thread producer([&]()
+    {
+        for (int i = 1; i <= kMessages; ++i)
+        {
+            while (static_cast<std::uint64_t>(i) - consumed.load(std::memory_order_acquire) > kCapacity / 2)
+            {
+                std::this_thread::yield();
+            }
+            publisher.onTrade(Trade(i, i, 1, 2, 0, i, 100));
+        }
+    });
+
+    std::uint64_t expected = 1;
+    FeedMessage message;
+    while (expected <= kMessages)
+    {
+        if (!reader.poll(message))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(message.sequence, expected);
+        ASSERT_EQ(message.fields[1], static_cast<std::int64_t>(expected));
+        consumed.store(expected++, std::memory_order_release);
+    }
+    producer.join();
+
+    EXPECT_EQ(reader.getMissedCount(), 0);
+    std::filesystem::remove(path);
+}
+
+TEST(MarketDataFeedTest, SlotStillBeingWrittenIsNotAGap)
+{
+    std::string path = feedPath("matchengine_feed_inflight");
+    MarketDataPublisher publisher(path, 8);
+    MarketDataReader reader(path);
+    for (int i = 1; i <= 3; ++i)
+    {
+        publisher.onTrade(Trade(i, i, 1, 2, 0, i, 100));
+    }
+
+    // What a reader sees when it checks the slot just before the publisher
+    // completes it and the header only afterwards
+    int fd = ::open(path.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+    size_t size = sizeof(FeedHeader) + 8 * sizeof(FeedMessage);
+    void *mapped = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    ASSERT_NE(mapped, MAP_FAILED);
+    FeedMessage *ring = reinterpret_cast<FeedMessage *>(static_cast<FeedHeader *>(mapped) + 1);
+    ring[1].sequence = 0;
+
+    FeedMessage message;
+    EXPECT_FALSE(reader.poll(message));
+    EXPECT_EQ(reader.getMissedCount(), 0);
+    EXPECT_EQ(reader.getNextSequence(), 1);
+
+    ring[1].sequence = 1;
+    std::vector<FeedMessage> messages = drain(reader);
+    ASSERT_EQ(messages.size(), 3);
+    EXPECT_EQ(messages.front().fields[1], 1);
+    EXPECT_EQ(reader.getMissedCount(), 0);
+
+    ::munmap(mapped, size);
+    std::filesystem::remove(path);
+}
+
+TEST(MarketDataFeedTest, ReaderRejectsOtherFiles)
+{
+    std::string path = feedPath("matchengine_feed_bogus");
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << std::string(4096, 'x');
+    }
+    EXPECT_THROW(MarketDataReader reader(path), std::runtime_error);
+    std::filesystem::remove(path);
+    EXPECT_THROW(MarketDataReader reader(path), std::runtime_error);
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "MarkToMarket.hpp"
+#include "MatchingEngine.hpp"
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+
+// Random long and short holdings for traders over symbols MTM_0.. MTM_n
+class MarkToMarketTest : public ::testing::Test
+{
+protected:
+    void build(int traderCount, int symbolCount, int holdings)
+    {
+        std::mt19937 rng(7);
+        for (int s = 0; s < symbolCount; ++s)
+        {
+            symbols.push_back(SymbolRegistry::instance().intern("MTM_" + std::to_string(s)));
+        }
+        for (int t = 0; t < traderCount; ++t)
+        {
+            traders.emplace_back(t, "MTM", 1e9);
+            for (int h = 0; h < holdings; ++h)
+            {
+                std::string symbol = "MTM_" + std::to_string(rng() % symbolCount);
+                double price = 10.0 + static_cast<double>(rng() % 1000) / 100.0;
+                traders.back().onOrderFilled(symbol, static_cast<double>(1 + rng() % 500), price, true);
+            }
+        }
+    }
+
+    std::vector<SymbolId> symbols;
+    std::vector<Trader> traders;
+};
+
+TEST_F(MarkToMarketTest, MatchesTraderMarks)
+{
+    build(20, 9, 6);
+    MarkToMarket batch(1);
+    for (Trader &trader : traders)
+    {
+        batch.addTrader(trader);
+    }
+    EXPECT_EQ(batch.getTraderCount(), 20);
+
+    std::vector<double> prices(SymbolRegistry::instance().size(), std::nan(""));
+    for (size_t s = 0; s < symbols.size(); ++s)
+    {
+        prices[symbols[s]] = 12.5 + static_cast<double>(s);
+    }
+    batch.revalue(prices);
+    batch.revalue(symbols[3], 9.75);
+    prices[symbols[3]] = 9.75;
+
+    // Marking each ledger by itself gives the same Cash amounts
+    std::vector<Trader> marked = traders;
+    Cash total = 0;
+    for (Trader &trader : marked)
+    {
+        for (SymbolId symbolId : symbols)
+        {
+            trader.updatePosition(symbolId, prices[symbolId]);
+        }
+        EXPECT_EQ(batch.getUnrealizedPnL(trader.getTraderId()), trader.getPositions().getUnrealizedPnL());
+        total += trader.getPositions().getUnrealizedPnL();
+    }
+    EXPECT_EQ(batch.getTotalPnL(), total);
+
+    // And applyMarks writes those marks back
+    batch.applyMarks();
+    for (size_t i = 0; i < traders.size(); ++i)
+    {
+        EXPECT_EQ(traders[i].getPositions().getUnrealizedPnL(), marked[i].getPositions().getUnrealizedPnL());
+        EXPECT_EQ(traders[i].getPositions().getNetExposure(), marked[i].getPositions().getNetExposure());
+    }
+}
+
+TEST_F(MarkToMarketTest, UnpricedColumnsKeepTheirMarks)
+{
+    build(5, 3, 10);
+    MarkToMarket batch(1);
+    for (Trader &trader : traders)
+    {
+        batch.addTrader(trader);
+    }
+    Cash before = batch.getSymbolPnL(symbols[1]);
+
+    std::vector<double> prices(SymbolRegistry::instance().size(), std::nan(""));
+    prices[symbols[0]] = 30.0;
+    batch.revalue(prices);
+    EXPECT_EQ(batch.getSymbolPnL(symbols[1]), before);
+    EXPECT_NE(batch.getSymbolPnL(symbols[0]), 0);
+}
+
+TEST_F(MarkToMarketTest, AddingATraderAgainReplacesItsRow)
+{
+    build(4, 3, 10);
+    MarkToMarket batch(1);
+    for (Trader &trader : traders)
+    {
+        batch.addTrader(trader);
+    }
+    size_t positions = batch.getPositionCount();
+    Cash total = batch.getTotalPnL();
+
+    batch.addTrader(traders[2]);
+    EXPECT_EQ(batch.getTraderCount(), 4);
+    EXPECT_EQ(batch.getPositionCount(), positions);
+    EXPECT_EQ(batch.getTotalPnL(), total);
+
+    // After a sale, only the changed position is re-read
+    SymbolId symbolId = traders[2].getPositions().begin()->symbolId;
+    std::int64_t held = traders[2].getShares(symbolId);
+    traders[2].onOrderFilled(SymbolRegistry::instance().name(symbolId), static_cast<double>(held), 50.0, false);
+    batch.updatePosition(traders[2].getTraderId(), symbolId);
+    EXPECT_EQ(batch.getPositionCount(), positions - 1);
+    EXPECT_EQ(batch.getUnrealizedPnL(traders[2].getTraderId()), traders[2].getPositions().getUnrealizedPnL());
+
+    batch.removeTrader(traders[2].getTraderId());
+    EXPECT_EQ(batch.getTraderCount(), 3);
+    EXPECT_EQ(batch.getUnrealizedPnL(traders[2].getTraderId()), 0);
+    Cash rest = 0;
+    for (int i : {0, 1, 3})
+    {
+        rest += traders[i].getPositions().getUnrealizedPnL();
+    }
+    EXPECT_EQ(batch.getTotalPnL(), rest);
+}
+
+TEST(MarkToMarketEngineTest, FillsKeepRowsCurrent)
+{
+    MatchingEngine engine;
+    MarkToMarket batch(1);
+    engine.addExecutionListener(&batch);
+    engine.registerTrader(std::make_shared<Trader>(1, "Buyer", 100000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Seller", 1000.0));
+    engine.getTrader(2)->onOrderFilled("MTM_FILL", 100, 10.0, true);
+    batch.addTrader(*engine.getTrader(1));
+    batch.addTrader(*engine.getTrader(2));
+    batch.revalue(engine.getSymbolId("MTM_FILL"), 12.0);
+
+    engine.submitOrder(2, "MTM_FILL", 100, 11.0, OrderSide::SELL);
+    engine.submitOrder(1, "MTM_FILL", 60, 11.0, OrderSide::BUY);
+    engine.submitOrder(1, "MTM_FILL", 40, 11.0, OrderSide::BUY);
+
+    // The seller went flat and the buyer's new holding is marked at 12.00
+    EXPECT_EQ(batch.getPositionCount(), 1);
+    EXPECT_EQ(batch.getUnrealizedPnL(2), 0);
+    EXPECT_EQ(batch.getUnrealizedPnL(1), toCash(100 * 1.0));
+
+    batch.applyMarks();
+    EXPECT_EQ(engine.getTrader(1)->getPositions().getUnrealizedPnL(), toCash(100 * 1.0));
+    engine.removeExecutionListener(&batch);
+}
+
+TEST_F(MarkToMarketTest, ThreadsAgreeWithOneThread)
+{
+    build(300, 400, 200);
+    MarkToMarket serial(1);
+    MarkToMarket parallel(4, 1000);
+    for (Trader &trader : traders)
+    {
+        serial.addTrader(trader);
+        parallel.addTrader(trader);
+    }
+    ASSERT_GE(parallel.getPositionCount(), 1000);
+
+    std::vector<double> prices(SymbolRegistry::instance().size(), std::nan(""));
+    for (int round = 0; round < 3; ++round)
+    {
+        for (size_t s = 0; s < symbols.size(); ++s)
+        {
+            prices[symbols[s]] = 15.0 + static_cast<double>((s + round) % 7);
+        }
+        serial.revalue(prices);
+        parallel.revalue(prices);
+
+        for (const Trader &trader : traders)
+        {
+            ASSERT_EQ(parallel.getUnrealizedPnL(trader.getTraderId()), serial.getUnrealizedPnL(trader.getTraderId()));
+        }
+        EXPECT_EQ(parallel.getTotalPnL(), serial.getTotalPnL());
+    }
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include "MatchingEngine.hpp"
 #include "Trader.hpp"
 #include "Order.hpp"
@@ -30,6 +31,23 @@ int main()
         return 1;
     }
 
+    // Prices must sit on the instrument tick grid
+    engine.defineInstrument(Instrument("TICK", 2, 5, 1)); // $0.05 ticks
+    bool rejected = false;
+    try
+    {
+        engine.submitOrder(1, "TICK", 1, 10.02, OrderSide::BUY);
+    }
+    catch (const std::invalid_argument &)
+    {
+        rejected = true;
+    }
+    if (!rejected)
+    {
+        std::cerr << "Expected off-tick price to be rejected" << std::endl;
+        return 1;
+    }
+
     std::cout << "matchengine test passed (trades=" << totalTrades << ")" << std::endl;
     return 0;
 }
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include "OrderBook.hpp"
+#include <atomic>
+#include <map>
 #include <memory>
+#include <random>
+#include <thread>
+#include <vector>
 
 class OrderBookTest : public ::testing::Test
 {
@@ -12,14 +17,17 @@ protected:
 
     std::unique_ptr<OrderBook> orderBook;
 
+    Price ticks(double price) const { return orderBook->getInstrument().toTicks(price); }
+    Quantity lots(double quantity) const { return orderBook->getInstrument().toLots(quantity); }
+
     std::shared_ptr<Order> createBuyOrder(int id, double quantity, double price)
     {
-        return std::make_shared<Order>(id, 100 + id, "AAPL", quantity, price, OrderSide::BUY);
+        return std::make_shared<Order>(id, 100 + id, orderBook->getSymbolId(), lots(quantity), ticks(price), OrderSide::BUY);
     }
 
     std::shared_ptr<Order> createSellOrder(int id, double quantity, double price)
     {
-        return std::make_shared<Order>(id, 200 + id, "AAPL", quantity, price, OrderSide::SELL);
+        return std::make_shared<Order>(id, 200 + id, orderBook->getSymbolId(), lots(quantity), ticks(price), OrderSide::SELL);
     }
 };
 
@@ -37,7 +45,7 @@ TEST_F(OrderBookTest, Constructor)
 TEST_F(OrderBookTest, AddSingleBuyOrder)
 {
     auto order = createBuyOrder(1, 100.0, 150.0);
-    orderBook->addOrder(order);
+    orderBook->addOrder(order.get());
 
     EXPECT_EQ(orderBook->getBestBidPrice(), 150.0);
     EXPECT_EQ(orderBook->getBestAskPrice(), 0.0);
@@ -49,7 +57,7 @@ TEST_F(OrderBookTest, AddSingleBuyOrder)
 TEST_F(OrderBookTest, AddSingleSellOrder)
 {
     auto order = createSellOrder(1, 100.0, 160.0);
-    orderBook->addOrder(order);
+    orderBook->addOrder(order.get());
 
     EXPECT_EQ(orderBook->getBestBidPrice(), 0.0);
     EXPECT_EQ(orderBook->getBestAskPrice(), 160.0);
@@ -64,9 +72,9 @@ TEST_F(OrderBookTest, AddMultipleBuyOrders)
     auto order2 = createBuyOrder(2, 50.0, 155.0); // Higher price
     auto order3 = createBuyOrder(3, 75.0, 145.0); // Lower price
 
-    orderBook->addOrder(order1);
-    orderBook->addOrder(order2);
-    orderBook->addOrder(order3);
+    orderBook->addOrder(order1.get());
+    orderBook->addOrder(order2.get());
+    orderBook->addOrder(order3.get());
 
     // DEBUG: print order book after adding buy orders
     std::cout << "DEBUG: After AddMultipleBuyOrders" << std::endl;
@@ -82,9 +90,9 @@ TEST_F(OrderBookTest, AddMultipleSellOrders)
     auto order2 = createSellOrder(2, 50.0, 155.0); // Lower price
     auto order3 = createSellOrder(3, 75.0, 165.0); // Higher price
 
-    orderBook->addOrder(order1);
-    orderBook->addOrder(order2);
-    orderBook->addOrder(order3);
+    orderBook->addOrder(order1.get());
+    orderBook->addOrder(order2.get());
+    orderBook->addOrder(order3.get());
 
     // DEBUG: print order book after adding sell orders
     std::cout << "DEBUG: After AddMultipleSellOrders" << std::endl;
@@ -98,14 +106,14 @@ TEST_F(OrderBookTest, SimpleMatchBuyAgainstSell)
 {
     // Add a sell order first
     auto sellOrder = createSellOrder(1, 100.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     EXPECT_TRUE(orderBook->getTrades().empty());
     EXPECT_EQ(orderBook->getAskDepth(), 1);
 
     // Add a buy order that matches
     auto buyOrder = createBuyOrder(2, 50.0, 150.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     // Should create a trade
     const auto &trades = orderBook->getTrades();
@@ -114,8 +122,8 @@ TEST_F(OrderBookTest, SimpleMatchBuyAgainstSell)
     const Trade &trade = trades[0];
     EXPECT_EQ(trade.buyOrderId, 2);
     EXPECT_EQ(trade.sellOrderId, 1);
-    EXPECT_EQ(trade.quantity, 50.0);
-    EXPECT_EQ(trade.price, 150.0); // Sell order price (price improvement for buyer)
+    EXPECT_EQ(trade.quantity, lots(50.0));
+    EXPECT_EQ(trade.price, ticks(150.0)); // Sell order price (price improvement for buyer)
 
     // Check order states
     EXPECT_EQ(buyOrder->getStatus(), OrderStatus::FILLED);
@@ -131,14 +139,14 @@ TEST_F(OrderBookTest, SimpleMatchSellAgainstBuy)
 {
     // Add a buy order first
     auto buyOrder = createBuyOrder(1, 100.0, 150.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     EXPECT_TRUE(orderBook->getTrades().empty());
     EXPECT_EQ(orderBook->getBidDepth(), 1);
 
     // Add a sell order that matches
     auto sellOrder = createSellOrder(2, 75.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     // Should create a trade
     const auto &trades = orderBook->getTrades();
@@ -147,8 +155,8 @@ TEST_F(OrderBookTest, SimpleMatchSellAgainstBuy)
     const Trade &trade = trades[0];
     EXPECT_EQ(trade.buyOrderId, 1);
     EXPECT_EQ(trade.sellOrderId, 2);
-    EXPECT_EQ(trade.quantity, 75.0);
-    EXPECT_EQ(trade.price, 150.0); // Buy order price (price improvement for seller)
+    EXPECT_EQ(trade.quantity, lots(75.0));
+    EXPECT_EQ(trade.price, ticks(150.0)); // Buy order price (price improvement for seller)
 
     // Check order states
     EXPECT_EQ(sellOrder->getStatus(), OrderStatus::FILLED);
@@ -160,41 +168,41 @@ TEST_F(OrderBookTest, PriceImprovementForBuyer)
 {
     // Sell order at $150
     auto sellOrder = createSellOrder(1, 100.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     // Buy order willing to pay $155
     auto buyOrder = createBuyOrder(2, 50.0, 155.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     const auto &trades = orderBook->getTrades();
     EXPECT_EQ(trades.size(), 1);
-    EXPECT_EQ(trades[0].price, 150.0); // Buyer gets price improvement
+    EXPECT_EQ(trades[0].price, ticks(150.0)); // Buyer gets price improvement
 }
 
 TEST_F(OrderBookTest, PriceImprovementForSeller)
 {
     // Buy order at $155
     auto buyOrder = createBuyOrder(1, 100.0, 155.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     // Sell order willing to accept $150
     auto sellOrder = createSellOrder(2, 50.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     const auto &trades = orderBook->getTrades();
     EXPECT_EQ(trades.size(), 1);
-    EXPECT_EQ(trades[0].price, 155.0); // Seller gets price improvement
+    EXPECT_EQ(trades[0].price, ticks(155.0)); // Seller gets price improvement
 }
 
 TEST_F(OrderBookTest, NoMatchDueToPrice)
 {
     // Buy order at $140
     auto buyOrder = createBuyOrder(1, 100.0, 140.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     // Sell order at $150 - no match
     auto sellOrder = createSellOrder(2, 50.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     EXPECT_TRUE(orderBook->getTrades().empty());
     EXPECT_EQ(orderBook->getBidDepth(), 1);
@@ -206,15 +214,15 @@ TEST_F(OrderBookTest, CompleteMatch)
 {
     // Sell order
     auto sellOrder = createSellOrder(1, 100.0, 150.0);
-    orderBook->addOrder(sellOrder);
+    orderBook->addOrder(sellOrder.get());
 
     // Buy order for exact same quantity
     auto buyOrder = createBuyOrder(2, 100.0, 150.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     const auto &trades = orderBook->getTrades();
     EXPECT_EQ(trades.size(), 1);
-    EXPECT_EQ(trades[0].quantity, 100.0);
+    EXPECT_EQ(trades[0].quantity, lots(100.0));
 
     EXPECT_EQ(buyOrder->getStatus(), OrderStatus::FILLED);
     EXPECT_EQ(sellOrder->getStatus(), OrderStatus::FILLED);
@@ -231,13 +239,13 @@ TEST_F(OrderBookTest, MultipleMatches)
     auto sell2 = createSellOrder(2, 40.0, 151.0);
     auto sell3 = createSellOrder(3, 50.0, 152.0);
 
-    orderBook->addOrder(sell1);
-    orderBook->addOrder(sell2);
-    orderBook->addOrder(sell3);
+    orderBook->addOrder(sell1.get());
+    orderBook->addOrder(sell2.get());
+    orderBook->addOrder(sell3.get());
 
     // Add large buy order that should match multiple sells
     auto buyOrder = createBuyOrder(4, 100.0, 155.0);
-    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(buyOrder.get());
 
     const auto &trades = orderBook->getTrades();
     // DEBUG: print order book and trades after matching
@@ -253,13 +261,13 @@ TEST_F(OrderBookTest, MultipleMatches)
     EXPECT_EQ(trades.size(), 3); // Should match all three sell orders
 
     // Check trade details
-    EXPECT_EQ(trades[0].price, 150.0);
-    EXPECT_EQ(trades[0].quantity, 30.0);
+    EXPECT_EQ(trades[0].price, ticks(150.0));
+    EXPECT_EQ(trades[0].quantity, lots(30.0));
 
-    EXPECT_EQ(trades[1].price, 151.0);
-    EXPECT_EQ(trades[1].quantity, 40.0);
-    EXPECT_EQ(trades[2].price, 152.0);
-    EXPECT_EQ(trades[2].quantity, 30.0); // Only part of the buy order
+    EXPECT_EQ(trades[1].price, ticks(151.0));
+    EXPECT_EQ(trades[1].quantity, lots(40.0));
+    EXPECT_EQ(trades[2].price, ticks(152.0));
+    EXPECT_EQ(trades[2].quantity, lots(30.0)); // Only part of the buy order
 
     EXPECT_EQ(buyOrder->getStatus(), OrderStatus::FILLED);
     EXPECT_EQ(buyOrder->getRemainingQuantity(), 0.0);
@@ -268,37 +276,465 @@ TEST_F(OrderBookTest, MultipleMatches)
 TEST_F(OrderBookTest, CancelOrder)
 {
     auto order = createBuyOrder(1, 100.0, 150.0);
-    orderBook->addOrder(order);
+    orderBook->addOrder(order.get());
 
     EXPECT_EQ(orderBook->getBidDepth(), 1);
 
-    bool cancelled = orderBook->cancelOrder(1);
+    bool cancelled = orderBook->cancelOrder(order.get());
     EXPECT_TRUE(cancelled);
     EXPECT_EQ(order->getStatus(), OrderStatus::CANCELLED);
 
     // Order book should clean up cancelled orders
     EXPECT_EQ(orderBook->getBidDepth(), 0);
 
-    // Try to cancel non-existent order
-    bool cancelledAgain = orderBook->cancelOrder(999);
+    // Try to cancel an order that is no longer in the book
+    bool cancelledAgain = orderBook->cancelOrder(order.get());
     EXPECT_FALSE(cancelledAgain);
 }
 
-TEST_F(OrderBookTest, GetOrderById)
+TEST_F(OrderBookTest, HasOrder)
 {
     auto order = createBuyOrder(1, 100.0, 150.0);
-    orderBook->addOrder(order);
-
-    auto retrieved = orderBook->getOrder(1);
-    EXPECT_EQ(retrieved, order);
+    orderBook->addOrder(order.get());
+    EXPECT_TRUE(orderBook->hasOrder(order.get()));
 
-    auto notFound = orderBook->getOrder(999);
-    EXPECT_EQ(notFound, nullptr);
+    auto notAdded = createBuyOrder(999, 100.0, 150.0);
+    EXPECT_FALSE(orderBook->hasOrder(notAdded.get()));
+    EXPECT_FALSE(orderBook->hasOrder(nullptr));
 }
 
 TEST_F(OrderBookTest, WrongSymbol)
 {
-    auto order = std::make_shared<Order>(1, 100, "GOOGL", 100.0, 150.0, OrderSide::BUY);
+    auto order = std::make_shared<Order>(1, 100, SymbolRegistry::instance().intern("GOOGL"), lots(100.0), ticks(150.0), OrderSide::BUY);
+
+    EXPECT_THROW(orderBook->addOrder(order.get()), std::invalid_argument);
+}
+
+TEST_F(OrderBookTest, TimePriorityWithinPriceLevel)
+{
+    auto sell1 = createSellOrder(1, 10.0, 150.0);
+    auto sell2 = createSellOrder(2, 10.0, 150.0);
+    auto sell3 = createSellOrder(3, 10.0, 150.0);
+
+    orderBook->addOrder(sell1.get());
+    orderBook->addOrder(sell2.get());
+    orderBook->addOrder(sell3.get());
+
+    auto buyOrder = createBuyOrder(4, 15.0, 150.0);
+    orderBook->addOrder(buyOrder.get());
+
+    const auto &trades = orderBook->getTrades();
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].sellOrderId, 1);
+    EXPECT_EQ(trades[0].quantity, lots(10.0));
+    EXPECT_EQ(trades[1].sellOrderId, 2);
+    EXPECT_EQ(trades[1].quantity, lots(5.0));
+
+    EXPECT_EQ(sell1->getStatus(), OrderStatus::FILLED);
+    EXPECT_EQ(sell2->getRemainingQuantity(), 5.0);
+    EXPECT_EQ(orderBook->getAskDepth(), 2);
+}
+
+TEST_F(OrderBookTest, CancelFromMiddleOfPriceLevel)
+{
+    auto sell1 = createSellOrder(1, 10.0, 150.0);
+    auto sell2 = createSellOrder(2, 10.0, 150.0);
+    auto sell3 = createSellOrder(3, 10.0, 150.0);
+
+    orderBook->addOrder(sell1.get());
+    orderBook->addOrder(sell2.get());
+    orderBook->addOrder(sell3.get());
+
+    EXPECT_TRUE(orderBook->cancelOrder(sell2.get()));
+    EXPECT_EQ(orderBook->getAskDepth(), 2);
+    EXPECT_FALSE(orderBook->hasOrder(sell2.get()));
+
+    auto buyOrder = createBuyOrder(4, 20.0, 150.0);
+    orderBook->addOrder(buyOrder.get());
+
+    const auto &trades = orderBook->getTrades();
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].sellOrderId, 1);
+    EXPECT_EQ(trades[1].sellOrderId, 3);
+    EXPECT_EQ(sell2->getStatus(), OrderStatus::CANCELLED);
+    EXPECT_EQ(sell2->getFilledQuantity(), 0.0);
+    EXPECT_EQ(orderBook->getAskDepth(), 0);
+    EXPECT_EQ(orderBook->getBestAskPrice(), 0.0);
+}
+
+TEST_F(OrderBookTest, CancelLastOrderAtBestLevel)
+{
+    auto order1 = createBuyOrder(1, 10.0, 150.0);
+    auto order2 = createBuyOrder(2, 10.0, 151.0);
+    orderBook->addOrder(order1.get());
+    orderBook->addOrder(order2.get());
+
+    EXPECT_EQ(orderBook->getBestBidPrice(), 151.0);
+    EXPECT_TRUE(orderBook->cancelOrder(order2.get()));
+    EXPECT_EQ(orderBook->getBestBidPrice(), 150.0);
+    EXPECT_FALSE(orderBook->cancelOrder(order2.get()));
+}
+
+TEST_F(OrderBookTest, CancelByOrderOnlyTakesRestingOrders)
+{
+    auto resting = createBuyOrder(1, 10.0, 150.0);
+    auto filled = createBuyOrder(2, 5.0, 151.0);
+    auto seller = createSellOrder(3, 5.0, 151.0);
+    orderBook->addOrder(resting.get());
+    orderBook->addOrder(filled.get());
+    orderBook->addOrder(seller.get());
+
+    // Neither a filled order nor one the book never saw is waiting in a level
+    auto stranger = createBuyOrder(4, 10.0, 150.0);
+    EXPECT_FALSE(orderBook->cancelOrder(filled.get()));
+    EXPECT_FALSE(orderBook->cancelOrder(stranger.get()));
+    EXPECT_EQ(orderBook->getBidDepth(), 1);
+
+    EXPECT_TRUE(orderBook->cancelOrder(resting.get()));
+    EXPECT_EQ(resting->getStatus(), OrderStatus::CANCELLED);
+    EXPECT_EQ(orderBook->getBidDepth(), 0);
+    EXPECT_EQ(orderBook->getBidLevelCount(), 0);
+    EXPECT_FALSE(orderBook->cancelOrder(resting.get()));
+}
+
+TEST(InstrumentTest, TickAndLotConversions)
+{
+    Instrument instrument("ES", 2, 25, 10); // $0.25 ticks, 10-share lots
+
+    EXPECT_EQ(instrument.toTicks(4500.25), 18001);
+    EXPECT_EQ(instrument.toPrice(18001), 4500.25);
+    EXPECT_TRUE(instrument.isOnTick(4500.50));
+    EXPECT_FALSE(instrument.isOnTick(4500.10));
+
+    EXPECT_EQ(instrument.toLots(30.0), 3);
+    EXPECT_EQ(instrument.toQuantity(3), 30.0);
+    EXPECT_TRUE(instrument.isWholeLots(30.0));
+    EXPECT_FALSE(instrument.isWholeLots(35.0));
+
+    // 3 lots x 10 shares x $4500.25
+    EXPECT_EQ(instrument.notional(3, 18001), toCash(135007.5));
+}
+
+TEST(InstrumentTest, RepeatedPartialFillsCompleteExactly)
+{
+    Instrument instrument("XYZ", 2, 1, 1);
+    OrderBook book(instrument);
+
+    auto sell = std::make_shared<Order>(1, 1, instrument.symbolId, instrument.toLots(1.0) * 10, instrument.toTicks(0.1), OrderSide::SELL);
+    book.addOrder(sell.get());
+
+    std::vector<std::shared_ptr<Order>> buys;
+    for (int i = 0; i < 10; ++i)
+    {
+        buys.push_back(std::make_shared<Order>(2 + i, 2, instrument.symbolId, 1, instrument.toTicks(0.1), OrderSide::BUY));
+        book.addOrder(buys.back().get());
+    }
+
+    EXPECT_EQ(sell->getStatus(), OrderStatus::FILLED);
+    EXPECT_EQ(sell->getRemainingQuantity(), 0);
+    EXPECT_EQ(book.getAskDepth(), 0);
+    EXPECT_EQ(book.getTradeCount(), 10);
+    EXPECT_EQ(book.getTotalVolume(), 10.0);
+}
+
+TEST_F(OrderBookTest, TopOfBookTracksAggregateQuantity)
+{
+    auto bid1 = createBuyOrder(1, 10.0, 150.0);
+    auto bid2 = createBuyOrder(2, 20.0, 150.0);
+    auto bid3 = createBuyOrder(3, 5.0, 149.0);
+    auto ask1 = createSellOrder(4, 7.0, 151.0);
+    orderBook->addOrder(bid1.get());
+    orderBook->addOrder(bid2.get());
+    orderBook->addOrder(bid3.get());
+    orderBook->addOrder(ask1.get());
+
+    TopOfBook top = orderBook->getTopOfBook();
+    EXPECT_EQ(top.bidPrice, ticks(150.0));
+    EXPECT_EQ(top.bidQuantity, lots(30.0));
+    EXPECT_EQ(top.askPrice, ticks(151.0));
+    EXPECT_EQ(top.askQuantity, lots(7.0));
+
+    // Partial fill reduces the level quantity
+    auto sell = createSellOrder(5, 12.0, 150.0);
+    orderBook->addOrder(sell.get());
+    EXPECT_EQ(orderBook->getBestBidPrice(), 150.0);
+    EXPECT_EQ(orderBook->getBestBidQuantity(), 18.0);
+
+    // Cancelling the rest of the level moves the best bid down
+    EXPECT_TRUE(orderBook->cancelOrder(bid2.get()));
+    top = orderBook->getTopOfBook();
+    EXPECT_EQ(top.bidPrice, ticks(149.0));
+    EXPECT_EQ(top.bidQuantity, lots(5.0));
+
+    // Taking out the only ask empties that side
+    auto buy = createBuyOrder(6, 7.0, 151.0);
+    orderBook->addOrder(buy.get());
+    top = orderBook->getTopOfBook();
+    EXPECT_EQ(top.askPrice, 0);
+    EXPECT_EQ(top.askQuantity, 0);
+    EXPECT_EQ(orderBook->getSpread(), 0.0);
+}
+
+TEST_F(OrderBookTest, TradeStatisticsFollowEveryFill)
+{
+    auto sell1 = createSellOrder(1, 30.0, 150.0);
+    auto sell2 = createSellOrder(2, 40.0, 151.0);
+    auto sell3 = createSellOrder(3, 50.0, 149.0);
+    orderBook->addOrder(sell1.get());
+    orderBook->addOrder(sell2.get());
+
+    auto buy1 = createBuyOrder(4, 70.0, 151.0);
+    orderBook->addOrder(buy1.get());
+    orderBook->addOrder(sell3.get());
+    auto buy2 = createBuyOrder(5, 10.0, 149.0);
+    orderBook->addOrder(buy2.get());
+
+    const TradeStats &stats = orderBook->getStats();
+    EXPECT_EQ(stats.getTradeCount(), 3);
+    EXPECT_EQ(stats.getVolume(), lots(80.0));
+    EXPECT_EQ(stats.getOpen(), ticks(150.0));
+    EXPECT_EQ(stats.getHigh(), ticks(151.0));
+    EXPECT_EQ(stats.getLow(), ticks(149.0));
+    EXPECT_EQ(stats.getLast(), ticks(149.0));
+
+    // (30 x 150 + 40 x 151 + 10 x 149) / 80
+    EXPECT_DOUBLE_EQ(orderBook->getVwap(), 150.375);
+    EXPECT_EQ(orderBook->getTotalVolume(), 80.0);
+    EXPECT_EQ(orderBook->getLastTradePrice(), 149.0);
+}
+
+TEST_F(OrderBookTest, DepthLevelsAggregateFromBestOutwards)
+{
+    std::vector<std::shared_ptr<Order>> orders = {
+        createBuyOrder(1, 10.0, 149.0), createBuyOrder(2, 5.0, 150.0), createBuyOrder(3, 7.0, 149.0),
+        createBuyOrder(4, 1.0, 148.0), createSellOrder(5, 4.0, 151.0), createSellOrder(6, 6.0, 151.0)};
+    for (auto &order : orders)
+    {
+        orderBook->addOrder(order.get());
+    }
+
+    DepthLevel levels[2];
+    ASSERT_EQ(orderBook->getBidLevels(levels), 2);
+    EXPECT_EQ(levels[0].price, ticks(150.0));
+    EXPECT_EQ(levels[0].quantity, lots(5.0));
+    EXPECT_EQ(levels[0].orderCount, 1);
+    EXPECT_EQ(levels[1].price, ticks(149.0));
+    EXPECT_EQ(levels[1].quantity, lots(17.0));
+    EXPECT_EQ(levels[1].orderCount, 2);
+    EXPECT_EQ(orderBook->getBidLevelCount(), 3);
+
+    ASSERT_EQ(orderBook->getAskLevels(levels), 1);
+    EXPECT_EQ(levels[0].price, ticks(151.0));
+    EXPECT_EQ(levels[0].quantity, lots(10.0));
+    EXPECT_EQ(levels[0].orderCount, 2);
+    EXPECT_EQ(orderBook->getAskLevels(std::span<DepthLevel>()), 0);
+}
+
+// Keeps its own copy of the book from level updates alone
+class DepthMirror : public ExecutionListener
+{
+public:
+    std::map<Price, DepthLevel> bids;
+    std::map<Price, DepthLevel> asks;
+    std::uint64_t lastSequence = 0;
+    bool gap = false;
+
+    void onBookUpdate(const BookUpdateEvent &event) override
+    {
+        gap |= event.sequence != lastSequence + 1;
+        lastSequence = event.sequence;
+        auto &levels = event.side == OrderSide::BUY ? bids : asks;
+        if (event.action == LevelAction::DELETE)
+        {
+            gap |= levels.erase(event.price) != 1;
+        }
+        else
+        {
+            gap |= (event.action == LevelAction::ADD) == levels.count(event.price);
+            levels[event.price] = DepthLevel{event.price, event.quantity, event.orderCount};
+        }
+    }
+};
+
+TEST_F(OrderBookTest, LevelUpdatesRebuildTheBook)
+{
+    DepthMirror mirror;
+    orderBook->setExecutionListener(&mirror);
+
+    std::mt19937 rng(7);
+    std::vector<std::shared_ptr<Order>> orders;
+    for (int id = 1; id <= 2000; ++id)
+    {
+        double price = 95.0 + static_cast<int>(rng() % 11);
+        double quantity = 1.0 + static_cast<int>(rng() % 20);
+        orders.push_back(rng() % 2 ? createBuyOrder(id, quantity, price) : createSellOrder(id, quantity, price));
+        orderBook->addOrder(orders.back().get());
+        if (rng() % 3 == 0)
+        {
+            orderBook->cancelOrder(orders[rng() % orders.size()].get());
+        }
+    }
+
+    EXPECT_FALSE(mirror.gap);
+    EXPECT_EQ(mirror.lastSequence, orderBook->getBookSequence());
 
-    EXPECT_THROW(orderBook->addOrder(order), std::invalid_argument);
+    std::vector<DepthLevel> levels(orderBook->getBidLevelCount());
+    ASSERT_EQ(orderBook->getBidLevels(levels), mirror.bids.size());
+    auto bid = mirror.bids.rbegin();
+    for (const DepthLevel &level : levels)
+    {
+        EXPECT_EQ(level.price, bid->second.price);
+        EXPECT_EQ(level.quantity, bid->second.quantity);
+        EXPECT_EQ(level.orderCount, bid->second.orderCount);
+        ++bid;
+    }
+
+    levels.resize(orderBook->getAskLevelCount());
+    ASSERT_EQ(orderBook->getAskLevels(levels), mirror.asks.size());
+    auto ask = mirror.asks.begin();
+    for (const DepthLevel &level : levels)
+    {
+        EXPECT_EQ(level.price, ask->second.price);
+        EXPECT_EQ(level.quantity, ask->second.quantity);
+        EXPECT_EQ(level.orderCount, ask->second.orderCount);
+        ++ask;
+    }
+}
+
+TEST_F(OrderBookTest, QuoteIsPublishedAfterEachChange)
+{
+    BookQuote quote = orderBook->getQuote();
+    EXPECT_EQ(quote.bidPrice, 0);
+    EXPECT_EQ(quote.askPrice, 0);
+    EXPECT_EQ(quote.sequence, 0);
+
+    auto bid = createBuyOrder(1, 100.0, 150.0);
+    auto ask = createSellOrder(2, 80.0, 151.0);
+    auto taker = createBuyOrder(3, 30.0, 151.0);
+    orderBook->addOrder(bid.get());
+    orderBook->addOrder(ask.get());
+    orderBook->addOrder(taker.get());
+
+    quote = orderBook->getQuote();
+    EXPECT_EQ(quote.bidPrice, ticks(150.0));
+    EXPECT_EQ(quote.bidQuantity, lots(100.0));
+    EXPECT_EQ(quote.askPrice, ticks(151.0));
+    EXPECT_EQ(quote.askQuantity, lots(50.0));
+    EXPECT_EQ(quote.lastPrice, ticks(151.0));
+    EXPECT_EQ(quote.sequence, orderBook->getBookSequence());
+
+    orderBook->cancelOrder(bid.get());
+    ASSERT_TRUE(orderBook->tryGetQuote(quote));
+    EXPECT_EQ(quote.bidPrice, 0);
+    EXPECT_EQ(quote.bidQuantity, 0);
+    EXPECT_EQ(quote.sequence, orderBook->getBookSequence());
+}
+
+TEST_F(OrderBookTest, QuoteReadsRunAlongsideMatching)
+{
+    // The matcher keeps a one tick spread and crosses it now and then; a
+    // reader must never see a crossed or half-written quote
+    std::atomic<bool> done{false};
+    std::atomic<size_t> bad{0};
+    std::thread reader([&]()
+    {
+        std::uint64_t lastSequence = 0;
+        while (!done.load(std::memory_order_acquire))
+        {
+            BookQuote quote = orderBook->getQuote();
+            bool crossed = quote.bidPrice != 0 && quote.askPrice != 0 && quote.bidPrice >= quote.askPrice;
+            if (crossed || quote.sequence < lastSequence)
+            {
+                ++bad;
+            }
+            lastSequence = quote.sequence;
+        }
+    });
+
+    std::vector<std::shared_ptr<Order>> orders;
+    for (int i = 0; i < 20000; ++i)
+    {
+        double mid = 100.0 + (i % 50) * 0.01;
+        orders.push_back(createBuyOrder(3 * i + 1, 10.0, mid));
+        orderBook->addOrder(orders.back().get());
+        orders.push_back(createSellOrder(3 * i + 2, 10.0, mid + 0.01));
+        orderBook->addOrder(orders.back().get());
+        orders.push_back(createSellOrder(3 * i + 3, 10.0, mid));
+        orderBook->addOrder(orders.back().get());
+        orderBook->cancelOrder(orders[orders.size() - 2].get());
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(bad.load(), 0);
+}
+
+TEST(SeqlockTest, CopiesAreNeverTorn)
+{
+    struct Words
+    {
+        std::uint64_t value[6];
+    };
+    Seqlock<Words> seqlock;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> torn{0};
+    std::thread reader([&]()
+    {
+        while (!done.load(std::memory_order_acquire))
+        {
+            Words words = seqlock.load();
+            for (std::uint64_t value : words.value)
+            {
+                torn += value != words.value[0];
+            }
+        }
+    });
+
+    for (std::uint64_t i = 1; i <= 200000; ++i)
+    {
+        seqlock.store(Words{{i, i, i, i, i, i}});
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(seqlock.getVersion(), 200000);
+    EXPECT_EQ(seqlock.load().value[5], 200000);
+}
+
+TEST(TradeStatsTest, BarsRollOverFixedRing)
+{
+    using namespace std::chrono;
+    TradeStats stats(seconds(1), 3);
+    steady_clock::time_point t0(seconds(100));
+
+    stats.onTrade(100, 5, t0);
+    stats.onTrade(103, 1, t0 + milliseconds(500));
+    stats.onTrade(99, 2, t0 + milliseconds(900));
+    ASSERT_EQ(stats.getBarCount(), 1);
+
+    const OhlcvBar &first = stats.getBar(0);
+    EXPECT_EQ(first.start, t0);
+    EXPECT_EQ(first.open, 100);
+    EXPECT_EQ(first.high, 103);
+    EXPECT_EQ(first.low, 99);
+    EXPECT_EQ(first.close, 99);
+    EXPECT_EQ(first.volume, 8);
+    EXPECT_EQ(first.tradeCount, 3);
+
+    // Quiet seconds produce no bars; the ring keeps the newest three
+    stats.onTrade(101, 1, t0 + seconds(1));
+    stats.onTrade(102, 1, t0 + seconds(5));
+    stats.onTrade(104, 1, t0 + seconds(6) + milliseconds(10));
+    ASSERT_EQ(stats.getBarCount(), 3);
+    EXPECT_EQ(stats.getBar(0).start, t0 + seconds(6));
+    EXPECT_EQ(stats.getBar(0).close, 104);
+    EXPECT_EQ(stats.getBar(1).start, t0 + seconds(5));
+    EXPECT_EQ(stats.getBar(2).start, t0 + seconds(1));
+    EXPECT_THROW(stats.getBar(3), std::out_of_range);
+
+    // Session totals are unaffected by bar eviction
+    EXPECT_EQ(stats.getTradeCount(), 6);
+    EXPECT_EQ(stats.getVolume(), 11);
+    EXPECT_EQ(stats.getOpen(), 100);
+    EXPECT_EQ(stats.getHigh(), 104);
+    EXPECT_EQ(stats.getLow(), 99);
 }
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "OrderIndex.hpp"
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+TEST(OrderIndexTest, AgreesWithAMap)
+{
+    OrderIndex index(512);
+    std::unordered_map<int, OrderHandle> expected;
+    std::mt19937 rng(3);
+
+    // Strided ids with random lifetimes, as from a shared id sequence
+    int nextId = 5;
+    for (int step = 0; step < 50000; ++step)
+    {
+        if (expected.size() < 512 && (expected.empty() || rng() % 3 != 0))
+        {
+            index.insert(nextId, static_cast<OrderHandle>(step));
+            expected[nextId] = static_cast<OrderHandle>(step);
+            nextId += 4;
+        }
+        else
+        {
+            auto it = expected.begin();
+            std::advance(it, rng() % expected.size());
+            index.erase(it->first);
+            expected.erase(it);
+        }
+        int probe = 5 + 4 * static_cast<int>(rng() % static_cast<unsigned>((nextId - 5) / 4 + 1));
+        auto it = expected.find(probe);
+        ASSERT_EQ(index.find(probe), it == expected.end() ? kInvalidOrderHandle : it->second);
+    }
+    EXPECT_EQ(index.size(), expected.size());
+    for (const auto &[orderId, handle] : expected)
+    {
+        EXPECT_EQ(index.find(orderId), handle);
+    }
+
+    index.erase(-1);
+    EXPECT_EQ(index.size(), expected.size());
+}
+
+class OrderHistoryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        engine.registerTrader(std::make_shared<Trader>(1, "Buyer", 100000.0));
+        engine.registerTrader(std::make_shared<Trader>(2, "Seller", 0.0));
+        engine.getTrader(2)->onOrderFilled("HIST", 1000, 0.0, true);
+    }
+
+    MatchingEngine engine{64};
+};
+
+TEST_F(OrderHistoryTest, FinishedOrdersLeaveARecord)
+{
+    int ask1 = engine.submitOrder(2, "HIST", 10, 10.00, OrderSide::SELL);
+    int ask2 = engine.submitOrder(2, "HIST", 30, 10.50, OrderSide::SELL);
+    int buy = engine.submitOrder(1, "HIST", 20, 11.00, OrderSide::BUY);
+
+    EXPECT_EQ(engine.getOrder(buy), nullptr);
+    const OrderRecord *record = engine.getOrderRecord(buy);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->status, OrderStatus::FILLED);
+    EXPECT_EQ(record->side, OrderSide::BUY);
+    EXPECT_EQ(record->filledQuantity, 20);
+    EXPECT_DOUBLE_EQ(record->averagePrice, 10.25);
+
+    ASSERT_NE(engine.getOrderRecord(ask1), nullptr);
+    EXPECT_EQ(engine.getOrderRecord(ask1)->status, OrderStatus::FILLED);
+
+    // Still resting, so live rather than recorded
+    EXPECT_EQ(engine.getOrderRecord(ask2), nullptr);
+    ASSERT_TRUE(engine.cancelOrder(ask2));
+    record = engine.getOrderRecord(ask2);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->status, OrderStatus::CANCELLED);
+    EXPECT_EQ(record->filledQuantity, 10);
+    EXPECT_DOUBLE_EQ(record->averagePrice, 10.50);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+}
+
+TEST_F(OrderHistoryTest, RecordsAgeOutOfTheWindow)
+{
+    engine.configureOrderHistory(8);
+    engine.setOrderIdSequence(3, 2);
+
+    int resting = engine.submitOrder(1, "HIST", 1, 1.00, OrderSide::BUY);
+    int first = engine.submitOrder(1, "HIST", 1, 2.00, OrderSide::BUY);
+    engine.cancelOrder(first);
+    ASSERT_NE(engine.getOrderRecord(first), nullptr);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        engine.cancelOrder(engine.submitOrder(1, "HIST", 1, 2.00, OrderSide::BUY));
+    }
+    ASSERT_NE(engine.getOrderRecord(first), nullptr);
+
+    int last = engine.submitOrder(1, "HIST", 1, 2.00, OrderSide::BUY);
+    EXPECT_EQ(engine.getOrderRecord(first), nullptr);
+    engine.cancelOrder(last);
+    EXPECT_EQ(engine.getOrderRecord(first), nullptr);
+    EXPECT_NE(engine.getOrderRecord(last), nullptr);
+
+    // An order that outlives the window is not recorded over newer ones
+    engine.cancelOrder(resting);
+    EXPECT_EQ(engine.getOrderRecord(resting), nullptr);
+    EXPECT_NE(engine.getOrderRecord(last), nullptr);
+    EXPECT_EQ(engine.getOrderRecord(0), nullptr);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "OrderPool.hpp"
+#include "MatchingEngine.hpp"
+#include <memory>
+
+static const SymbolId kAapl = SymbolRegistry::instance().intern("AAPL");
+
+TEST(OrderPoolTest, AllocateAndRelease)
+{
+    OrderPool pool(4);
+    EXPECT_EQ(pool.capacity(), 4);
+    EXPECT_EQ(pool.inUse(), 0);
+
+    OrderHandle handle = pool.allocate(1, 10, kAapl, 100, 15000, OrderSide::BUY);
+    ASSERT_NE(handle, kInvalidOrderHandle);
+    EXPECT_EQ(pool.inUse(), 1);
+    EXPECT_EQ(pool.get(handle)->getOrderId(), 1);
+    EXPECT_EQ(pool.get(handle)->getPrice(), 15000);
+
+    pool.release(handle);
+    EXPECT_EQ(pool.inUse(), 0);
+}
+
+TEST(OrderPoolTest, ReusesReleasedSlots)
+{
+    OrderPool pool(2);
+
+    OrderHandle first = pool.allocate(1, 10, kAapl, 100, 15000, OrderSide::BUY);
+    const Order *slot = pool.get(first);
+    pool.release(first);
+
+    OrderHandle second = pool.allocate(2, 10, kAapl, 50, 15100, OrderSide::SELL);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(pool.get(second), slot);
+    EXPECT_EQ(pool.get(second)->getOrderId(), 2);
+}
+
+TEST(OrderPoolTest, ExhaustionIsCounted)
+{
+    OrderPool pool(2);
+
+    pool.allocate(1, 10, kAapl, 100, 15000, OrderSide::BUY);
+    OrderHandle second = pool.allocate(2, 10, kAapl, 100, 15000, OrderSide::BUY);
+    EXPECT_EQ(pool.allocate(3, 10, kAapl, 100, 15000, OrderSide::BUY), kInvalidOrderHandle);
+
+    pool.release(second);
+    pool.allocate(4, 10, kAapl, 100, 15000, OrderSide::BUY);
+
+    OrderPoolStats stats = pool.getStats();
+    EXPECT_EQ(stats.capacity, 2);
+    EXPECT_EQ(stats.inUse, 2);
+    EXPECT_EQ(stats.highWaterMark, 2);
+    EXPECT_EQ(stats.allocationFailures, 1);
+}
+
+TEST(OrderPoolTest, FailedConstructionKeepsSlotFree)
+{
+    OrderPool pool(1);
+
+    EXPECT_THROW(pool.allocate(1, 10, kAapl, 0, 15000, OrderSide::BUY), std::invalid_argument);
+    EXPECT_EQ(pool.inUse(), 0);
+    EXPECT_NE(pool.allocate(2, 10, kAapl, 100, 15000, OrderSide::BUY), kInvalidOrderHandle);
+}
+
+TEST(OrderPoolTest, EngineReturnsSlotsOnFillAndCancel)
+{
+    MatchingEngine engine(8);
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 100000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 100000.0));
+    engine.getTrader(2)->onOrderFilled("SYM", 100, 10.0, true);
+
+    int sellId = engine.submitOrder(2, "SYM", 100, 10.0, OrderSide::SELL);
+    int restingBuyId = engine.submitOrder(1, "SYM", 10, 9.0, OrderSide::BUY);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 2);
+
+    // Partially fills the resting sell; the incoming buy is done immediately
+    engine.submitOrder(1, "SYM", 40, 10.0, OrderSide::BUY);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 2);
+    ASSERT_NE(engine.getOrder(sellId), nullptr);
+    EXPECT_EQ(engine.getOrder(sellId)->getRemainingQuantity(), 60);
+
+    // Fills the rest of the sell
+    engine.submitOrder(1, "SYM", 60, 10.0, OrderSide::BUY);
+    EXPECT_EQ(engine.getOrder(sellId), nullptr);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 1);
+
+    EXPECT_TRUE(engine.cancelOrder(restingBuyId));
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 0);
+    EXPECT_EQ(engine.getOrderPoolStats().highWaterMark, 3);
+}
+
+TEST(OrderPoolTest, EngineRejectsWhenPoolExhausted)
+{
+    MatchingEngine engine(1);
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 100000.0));
+
+    engine.submitOrder(1, "SYM", 10, 9.0, OrderSide::BUY);
+    EXPECT_THROW(engine.submitOrder(1, "SYM", 10, 9.0, OrderSide::BUY), std::runtime_error);
+    EXPECT_EQ(engine.getOrderPoolStats().allocationFailures, 1);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "PositionLedger.hpp"
+#include "Trader.hpp"
+
+class PositionLedgerTest : public ::testing::Test
+{
+protected:
+    SymbolId abc = SymbolRegistry::instance().intern("LEDGER_ABC");
+    SymbolId xyz = SymbolRegistry::instance().intern("LEDGER_XYZ");
+    PositionLedger ledger;
+};
+
+TEST_F(PositionLedgerTest, AddsAtAverageCost)
+{
+    ledger.applyFill(abc, 10, toCash(1000.0), 100.0);
+    ledger.applyFill(abc, 30, toCash(3600.0), 120.0);
+
+    const Position *position = ledger.find(abc);
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->quantity, 40);
+    EXPECT_DOUBLE_EQ(position->averagePrice, 115.0);
+    EXPECT_EQ(ledger.getCostBasis(), toCash(4600.0));
+    // Marked at the last fill
+    EXPECT_EQ(ledger.getNetExposure(), toCash(4800.0));
+    EXPECT_EQ(ledger.getUnrealizedPnL(), toCash(200.0));
+    EXPECT_EQ(ledger.getRealizedPnL(), 0);
+}
+
+TEST_F(PositionLedgerTest, ClosingRealizesAgainstAverageCost)
+{
+    ledger.applyFill(abc, 40, toCash(4600.0), 115.0);
+    ledger.applyFill(abc, -10, toCash(1250.0), 125.0);
+
+    EXPECT_EQ(ledger.getShares(abc), 30);
+    EXPECT_EQ(ledger.getRealizedPnL(), toCash(100.0));
+    EXPECT_EQ(ledger.getCostBasis(), toCash(3450.0));
+    EXPECT_DOUBLE_EQ(ledger.find(abc)->averagePrice, 115.0);
+
+    ledger.applyFill(abc, -30, toCash(3300.0), 110.0);
+    EXPECT_EQ(ledger.find(abc), nullptr);
+    EXPECT_TRUE(ledger.empty());
+    EXPECT_EQ(ledger.getRealizedPnL(), toCash(100.0 - 150.0));
+    EXPECT_EQ(ledger.getCostBasis(), 0);
+    EXPECT_EQ(ledger.getGrossExposure(), 0);
+}
+
+TEST_F(PositionLedgerTest, FillsThroughZeroOpenTheOtherSide)
+{
+    ledger.applyFill(abc, 10, toCash(1000.0), 100.0);
+    ledger.applyFill(abc, -25, toCash(2750.0), 110.0);
+
+    EXPECT_EQ(ledger.getShares(abc), -15);
+    EXPECT_EQ(ledger.getRealizedPnL(), toCash(100.0));
+    EXPECT_EQ(ledger.getCostBasis(), toCash(-1650.0));
+    EXPECT_DOUBLE_EQ(ledger.find(abc)->averagePrice, 110.0);
+
+    // Covering the short below the sale price is a gain
+    ledger.applyFill(abc, 15, toCash(1500.0), 100.0);
+    EXPECT_EQ(ledger.getShares(abc), 0);
+    EXPECT_EQ(ledger.getRealizedPnL(), toCash(250.0));
+}
+
+TEST_F(PositionLedgerTest, MarksUpdateTotals)
+{
+    ledger.applyFill(abc, 10, toCash(1000.0), 100.0);
+    ledger.applyFill(xyz, -20, toCash(1000.0), 50.0);
+    EXPECT_EQ(ledger.size(), 2);
+
+    ledger.mark(abc, 90.0);
+    ledger.mark(xyz, 40.0);
+    ledger.mark(SymbolRegistry::instance().intern("LEDGER_NEVER"), 1.0);
+
+    EXPECT_EQ(ledger.getNetExposure(), toCash(900.0 - 800.0));
+    EXPECT_EQ(ledger.getGrossExposure(), toCash(1700.0));
+    EXPECT_EQ(ledger.getUnrealizedPnL(), toCash(-100.0 + 200.0));
+    EXPECT_DOUBLE_EQ(ledger.find(xyz)->unrealizedPnL, 200.0);
+}
+
+TEST_F(PositionLedgerTest, TraderQueriesReadTheTotals)
+{
+    Trader trader(1, "Ledger", 10000.0);
+    trader.onOrderFilled("LEDGER_ABC", 10, 100.0, true);
+    trader.onOrderFilled("LEDGER_XYZ", 20, 50.0, true);
+    trader.onOrderFilled("LEDGER_ABC", 5, 120.0, false);
+    trader.updatePosition("LEDGER_XYZ", 55.0);
+
+    EXPECT_DOUBLE_EQ(trader.getCash(), 10000.0 - 1000.0 - 1000.0 + 600.0);
+    EXPECT_DOUBLE_EQ(trader.getRealizedPnL(), 100.0);
+    EXPECT_DOUBLE_EQ(trader.getUnrealizedPnL(), 100.0 + 100.0);
+    EXPECT_DOUBLE_EQ(trader.getTotalPnL(), 300.0);
+    EXPECT_DOUBLE_EQ(trader.getPortfolioValue(), 8600.0 + 500.0 + 1000.0);
+    EXPECT_DOUBLE_EQ(trader.getNetExposure(), 600.0 + 1100.0);
+
+    int visited = 0;
+    for (const Position &position : trader.getPositions())
+    {
+        EXPECT_NE(position.quantity, 0);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 2);
+
+    trader.restore(toCash(50.0), {Position(abc, 3, 10.0)});
+    EXPECT_EQ(trader.getShares(abc), 3);
+    EXPECT_EQ(trader.getShares(xyz), 0);
+    EXPECT_DOUBLE_EQ(trader.getPortfolioValue(), 80.0);
+    EXPECT_DOUBLE_EQ(trader.getTotalPnL(), 0.0);
+}
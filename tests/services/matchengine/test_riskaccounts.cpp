@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include <cmath>
+#include <limits>
+#include <memory>
+
+class RiskAccountTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        engine.registerTrader(std::make_shared<Trader>(1, "Buyer", 1000.0));
+        engine.registerTrader(std::make_shared<Trader>(2, "Seller", 0.0));
+        engine.getTrader(2)->onOrderFilled("RISK", 100, 0.0, true);
+    }
+
+    Cash reservedCash(int traderId) const { return engine.getRiskAccount(traderId)->reservedCash; }
+    std::int64_t reservedShares(int traderId) const
+    {
+        return engine.getRiskAccount(traderId)->getReservedShares(engine.getSymbolId("RISK"));
+    }
+
+    MatchingEngine engine;
+};
+
+TEST_F(RiskAccountTest, RestingBuysReserveCashUntilCancelled)
+{
+    int first = engine.submitOrder(1, "RISK", 50, 10.0, OrderSide::BUY);
+    EXPECT_EQ(reservedCash(1), toCash(500.0));
+    EXPECT_EQ(engine.getRiskAccount(1)->getAvailableCash(), toCash(500.0));
+
+    // Both would pass a check against the balance alone
+    EXPECT_THROW(engine.submitOrder(1, "RISK", 60, 10.0, OrderSide::BUY), std::runtime_error);
+    EXPECT_THROW(engine.submitOrder(1, "RISK", 10, 0.0, OrderSide::BUY, OrderType::STOP, 60.0),
+                 std::runtime_error);
+
+    EXPECT_TRUE(engine.cancelOrder(first));
+    EXPECT_EQ(reservedCash(1), 0);
+    EXPECT_NO_THROW(engine.submitOrder(1, "RISK", 60, 10.0, OrderSide::BUY));
+    EXPECT_EQ(reservedCash(1), toCash(600.0));
+}
+
+TEST_F(RiskAccountTest, FillsSettleAgainstReservations)
+{
+    engine.submitOrder(2, "RISK", 30, 10.0, OrderSide::SELL);
+    EXPECT_EQ(reservedShares(2), 30);
+
+    // Fills at the resting 10.00 although the buy was willing to pay 12.00
+    engine.submitOrder(1, "RISK", 20, 12.0, OrderSide::BUY);
+    EXPECT_EQ(reservedCash(1), 0);
+    EXPECT_EQ(engine.getTrader(1)->getCashUnits(), toCash(800.0));
+    EXPECT_EQ(reservedShares(2), 10);
+    EXPECT_EQ(engine.getTrader(2)->getShares(engine.getSymbolId("RISK")), 80);
+
+    // A partly filled buy keeps the reservation for what is left
+    engine.submitOrder(1, "RISK", 40, 11.0, OrderSide::BUY);
+    EXPECT_EQ(reservedCash(1), toCash(330.0));
+    EXPECT_EQ(reservedShares(2), 0);
+    EXPECT_EQ(engine.getRiskAccount(1)->getAvailableCash(), toCash(800.0 - 100.0 - 330.0));
+}
+
+TEST_F(RiskAccountTest, SellsReserveShares)
+{
+    int first = engine.submitOrder(2, "RISK", 60, 10.0, OrderSide::SELL);
+    EXPECT_EQ(engine.getRiskAccount(2)->getAvailableShares(engine.getSymbolId("RISK")), 40);
+    EXPECT_THROW(engine.submitOrder(2, "RISK", 50, 11.0, OrderSide::SELL), std::runtime_error);
+
+    engine.cancelOrder(first);
+    EXPECT_EQ(reservedShares(2), 0);
+    EXPECT_NO_THROW(engine.submitOrder(2, "RISK", 100, 11.0, OrderSide::SELL));
+}
+
+TEST_F(RiskAccountTest, MarketBuysReserveTheSweep)
+{
+    engine.submitOrder(2, "RISK", 50, 10.0, OrderSide::SELL);
+    engine.submitOrder(2, "RISK", 50, 11.0, OrderSide::SELL);
+
+    // 50 x 10.00 + 50 x 11.00 is more than the buyer has, although 100 at
+    // the best ask is not
+    EXPECT_THROW(engine.submitOrder(1, "RISK", 100, 0.0, OrderSide::BUY, OrderType::MARKET), std::runtime_error);
+    EXPECT_NO_THROW(engine.submitOrder(1, "RISK", 90, 0.0, OrderSide::BUY, OrderType::MARKET));
+    EXPECT_EQ(engine.getTrader(1)->getCashUnits(), toCash(1000.0 - 500.0 - 440.0));
+    EXPECT_EQ(reservedCash(1), 0);
+    EXPECT_EQ(reservedShares(2), 10);
+}
+
+TEST_F(RiskAccountTest, TriggeredStopBuysArePricedAtTheSweep)
+{
+    SymbolId symbolId = engine.getSymbolId("RISK");
+    engine.registerTrader(std::make_shared<Trader>(3, "Small", 1.0));
+    engine.registerTrader(std::make_shared<Trader>(4, "Stopper", 600.0));
+
+    // Last trade at 100.00, with 50 more offered there
+    engine.submitOrder(2, "RISK", 10, 100.0, OrderSide::SELL);
+    engine.submitOrder(1, "RISK", 10, 100.0, OrderSide::BUY);
+    engine.submitOrder(2, "RISK", 50, 100.0, OrderSide::SELL);
+
+    // Reserved at 50 x 0.01, but triggers at once and would sweep 5000.00
+    int stop = engine.submitOrder(3, "RISK", 50, 0.0, OrderSide::BUY, OrderType::STOP, 0.01);
+    EXPECT_EQ(engine.getOrder(stop), nullptr);
+    EXPECT_EQ(engine.getTrader(3)->getCashUnits(), toCash(1.0));
+    EXPECT_EQ(engine.getTrader(3)->getShares(symbolId), 0);
+    EXPECT_EQ(reservedCash(3), 0);
+    EXPECT_EQ(engine.getOrderBook("RISK")->getAskDepth(), 1);
+
+    // One the trader can cover is re-priced and fills
+    engine.submitOrder(4, "RISK", 5, 0.0, OrderSide::BUY, OrderType::STOP, 0.01);
+    EXPECT_EQ(engine.getTrader(4)->getCashUnits(), toCash(100.0));
+    EXPECT_EQ(engine.getTrader(4)->getShares(symbolId), 5);
+    EXPECT_EQ(reservedCash(4), 0);
+
+    // A pending stop is checked when it triggers: reserved at 5 x 101.00,
+    // it would sweep 5 x 150.00 once the trade at 101.00 takes that level
+    engine.registerTrader(std::make_shared<Trader>(5, "Pending", 600.0));
+    engine.registerTrader(std::make_shared<Trader>(6, "Whale", 100000.0));
+    int pending = engine.submitOrder(5, "RISK", 5, 0.0, OrderSide::BUY, OrderType::STOP, 101.0);
+    EXPECT_EQ(reservedCash(5), toCash(505.0));
+    engine.submitOrder(2, "RISK", 5, 101.0, OrderSide::SELL);
+    engine.submitOrder(2, "RISK", 5, 150.0, OrderSide::SELL);
+    engine.submitOrder(6, "RISK", 50, 101.0, OrderSide::BUY);
+    EXPECT_EQ(engine.getOrderBook("RISK")->getLastTradePrice(), 101.0);
+    EXPECT_EQ(engine.getOrder(pending), nullptr);
+    EXPECT_EQ(engine.getTrader(5)->getCashUnits(), toCash(600.0));
+    EXPECT_EQ(engine.getTrader(5)->getShares(symbolId), 0);
+    EXPECT_EQ(reservedCash(5), 0);
+    EXPECT_EQ(engine.getOrderBook("RISK")->getAskDepth(), 1);
+}
+
+TEST_F(RiskAccountTest, TraderIdsIndexTheTable)
+{
+    EXPECT_EQ(engine.getRiskAccount(3), nullptr);
+    EXPECT_EQ(engine.getRiskAccount(-1), nullptr);
+    EXPECT_THROW(engine.registerTrader(std::make_shared<Trader>(-1, "Negative")), std::invalid_argument);
+    EXPECT_THROW(engine.registerTrader(std::make_shared<Trader>(RiskAccounts::kMaxTraderId + 1, "Huge")),
+                 std::invalid_argument);
+    EXPECT_EQ(engine.getTrader(-1), nullptr);
+
+    engine.registerTrader(std::make_shared<Trader>(RiskAccounts::kMaxTraderId, "Last"));
+    ASSERT_NE(engine.getRiskAccount(RiskAccounts::kMaxTraderId), nullptr);
+    EXPECT_EQ(engine.getRiskAccount(RiskAccounts::kMaxTraderId)->trader->getName(), "Last");
+}
+
+TEST_F(RiskAccountTest, OrdersBeyondTheInstrumentLimitsAreRejected)
+{
+    Instrument instrument("RISKMAX", 2, 1, 1);
+    instrument.maxLots = 1000;
+    instrument.maxTicks = 100000;
+    engine.defineInstrument(instrument);
+    engine.registerTrader(std::make_shared<Trader>(3, "Whale", 1e9));
+
+    EXPECT_NO_THROW(engine.submitOrder(3, "RISKMAX", 1000, 1000.00, OrderSide::BUY));
+    EXPECT_NO_THROW(engine.submitOrder(3, "RISKMAX", 1, 0.0, OrderSide::BUY, OrderType::STOP, 1000.00));
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", 1001, 1000.00, OrderSide::BUY), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", 1, 1000.01, OrderSide::BUY), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", 1, 0.0, OrderSide::BUY, OrderType::STOP, 1000.01),
+                 std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", 1, 1e300, OrderSide::BUY), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", 1e300, 1.00, OrderSide::SELL), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(3, "RISKMAX", std::nan(""), 1.00, OrderSide::BUY), std::invalid_argument);
+    EXPECT_EQ(engine.getRiskAccount(3)->reservedCash, toCash(1000 * 1000.00 + 1000.00));
+
+    Instrument unbounded("RISKBAD");
+    unbounded.maxLots = std::numeric_limits<std::int64_t>::max() / 2;
+    unbounded.lotSize = 4;
+    EXPECT_THROW(engine.defineInstrument(unbounded), std::invalid_argument);
+}
+
+TEST_F(RiskAccountTest, NotionalThatOverflowsIsRejectedNotWrapped)
+{
+    // 10^12 shares at 1000.0000 is 10^19 cash units, which wraps negative
+    // in int64 and would pass any cash check
+    engine.defineInstrument(Instrument("RISKBIG", 4, 1, 1000));
+    EXPECT_EQ(engine.getInstrument("RISKBIG").checkedNotional(1'000'000'000, 10'000'000), std::nullopt);
+    EXPECT_EQ(engine.getInstrument("RISKBIG").checkedNotional(1'000'000, 10'000'000), 10'000'000'000'000'000);
+
+    EXPECT_THROW(engine.submitOrder(1, "RISKBIG", 1e12, 1000.0, OrderSide::BUY), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(1, "RISKBIG", 1e12, 0.0, OrderSide::BUY, OrderType::STOP, 1000.0),
+                 std::invalid_argument);
+    EXPECT_EQ(reservedCash(1), 0);
+
+    // Still refused for cash when the notional fits
+    EXPECT_THROW(engine.submitOrder(1, "RISKBIG", 1e9, 1000.0, OrderSide::BUY), std::runtime_error);
+}
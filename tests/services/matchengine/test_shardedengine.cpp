@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "ShardedMatchingEngine.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Polls until `count` results have arrived
+static std::vector<ShardResult> collect(ShardedMatchingEngine &engine, size_t count)
+{
+    std::vector<ShardResult> results(count);
+    size_t received = 0;
+    while (received < count)
+    {
+        size_t polled = engine.pollResults(results.data() + received, count - received);
+        if (polled == 0)
+        {
+            std::this_thread::yield();
+        }
+        received += polled;
+    }
+    return results;
+}
+
+TEST(ShardedEngineTest, SymbolsMatchOnTheirOwnShard)
+{
+    ShardedMatchingEngine engine(2);
+    SymbolId even = SymbolRegistry::instance().intern("SHARD_A");
+    SymbolId odd = SymbolRegistry::instance().intern("SHARD_B");
+    ASSERT_NE(engine.getShardIndex(even), engine.getShardIndex(odd));
+
+    engine.registerTrader(1, "Alice", 100000.0);
+    engine.registerTrader(2, "Bob", 100000.0);
+    for (SymbolId symbol : {even, odd})
+    {
+        engine.getTrader(2, symbol)->onOrderFilled(SymbolRegistry::instance().name(symbol), 100, 1.0, true);
+    }
+    engine.start();
+
+    std::uint64_t tag = 0;
+    for (SymbolId symbol : {even, odd})
+    {
+        ASSERT_TRUE(engine.submitOrder(++tag, 2, symbol, 100, 10.0, OrderSide::SELL));
+        ASSERT_TRUE(engine.submitOrder(++tag, 1, symbol, 60, 10.0, OrderSide::BUY));
+    }
+    auto results = collect(engine, 4);
+    engine.stop();
+
+    std::vector<int> orderIds;
+    for (const ShardResult &result : results)
+    {
+        EXPECT_EQ(result.status, ShardResultStatus::ACCEPTED);
+        orderIds.push_back(result.orderId);
+    }
+    std::sort(orderIds.begin(), orderIds.end());
+    EXPECT_EQ(std::adjacent_find(orderIds.begin(), orderIds.end()), orderIds.end());
+
+    for (SymbolId symbol : {even, odd})
+    {
+        MatchingEngine &shard = engine.getShardEngine(engine.getShardIndex(symbol));
+        EXPECT_EQ(shard.getTotalTradeCount(), 1);
+        EXPECT_DOUBLE_EQ(shard.getTotalVolume(), 60.0);
+        EXPECT_DOUBLE_EQ(engine.getTrader(1, symbol)->getCash(), 100000.0 - 600.0);
+    }
+}
+
+TEST(ShardedEngineTest, CancelsRouteByOrderIdAndRejectsCarryReason)
+{
+    ShardedMatchingEngine engine(3);
+    SymbolId symbol = SymbolRegistry::instance().intern("SHARD_C");
+    engine.registerTrader(1, "Alice", 100000.0);
+    engine.start();
+
+    ASSERT_TRUE(engine.submitOrder(1, 1, symbol, 10, 9.0, OrderSide::BUY));
+    ASSERT_TRUE(engine.submitOrder(2, 42, symbol, 10, 9.0, OrderSide::BUY));
+    auto submitted = collect(engine, 2);
+    std::sort(submitted.begin(), submitted.end(),
+              [](const ShardResult &a, const ShardResult &b) { return a.tag < b.tag; });
+    EXPECT_EQ(submitted[0].status, ShardResultStatus::ACCEPTED);
+    EXPECT_EQ(submitted[1].status, ShardResultStatus::REJECTED);
+    EXPECT_EQ(submitted[1].reason, RejectReason::UNKNOWN_TRADER);
+
+    ASSERT_TRUE(engine.cancelOrder(3, submitted[0].orderId));
+    ASSERT_TRUE(engine.cancelOrder(4, submitted[0].orderId));
+    auto cancelled = collect(engine, 2);
+    EXPECT_EQ(cancelled[0].status, ShardResultStatus::CANCELLED);
+    EXPECT_EQ(cancelled[1].status, ShardResultStatus::CANCEL_REJECTED);
+}
+
+TEST(ShardedEngineTest, StopOrdersReachTheShard)
+{
+    ShardedMatchingEngine engine(2);
+    SymbolId symbol = SymbolRegistry::instance().intern("SHARD_STOP");
+    engine.registerTrader(1, "Alice", 100000.0);
+    engine.registerTrader(2, "Bob", 100000.0);
+    engine.getTrader(2, symbol)->onOrderFilled("SHARD_STOP", 100, 1.0, true);
+    engine.start();
+
+    // Both stops park until the trade at 10.00 reaches their trigger
+    ASSERT_TRUE(engine.submitOrder(1, 2, symbol, 100, 10.0, OrderSide::SELL));
+    ASSERT_TRUE(engine.submitOrder(2, 1, symbol, 10, 0.0, OrderSide::BUY, OrderType::STOP, 10.0));
+    ASSERT_TRUE(engine.submitOrder(3, 1, symbol, 20, 10.0, OrderSide::BUY, OrderType::STOP_LIMIT, 10.0));
+    ASSERT_TRUE(engine.submitOrder(4, 1, symbol, 10, 0.0, OrderSide::BUY, OrderType::STOP));
+    auto parked = collect(engine, 4);
+    ASSERT_TRUE(engine.submitOrder(5, 1, symbol, 30, 10.0, OrderSide::BUY));
+    auto results = collect(engine, 1);
+    engine.stop();
+
+    std::sort(parked.begin(), parked.end(),
+              [](const ShardResult &a, const ShardResult &b) { return a.tag < b.tag; });
+    EXPECT_EQ(parked[1].status, ShardResultStatus::ACCEPTED);
+    EXPECT_EQ(parked[2].status, ShardResultStatus::ACCEPTED);
+    EXPECT_EQ(parked[3].status, ShardResultStatus::REJECTED);
+    EXPECT_EQ(parked[3].reason, RejectReason::INVALID_PRICE);
+    EXPECT_EQ(results[0].status, ShardResultStatus::ACCEPTED);
+
+    MatchingEngine &shard = engine.getShardEngine(engine.getShardIndex(symbol));
+    EXPECT_EQ(shard.getOrderBook(symbol)->getPendingStopCount(), 0);
+    EXPECT_EQ(shard.getTotalTradeCount(), 3);
+    EXPECT_EQ(engine.getTrader(1, symbol)->getShares(symbol), 60);
+}
+
+TEST(ShardedEngineTest, ManyProducersEveryRequestAnswered)
+{
+    constexpr int kProducers = 4;
+    constexpr int kOrdersEach = 2000;
+
+    ShardedMatchingEngine engine(4, 1 << 14, 256);
+    std::vector<SymbolId> symbols;
+    for (int i = 0; i < 8; ++i)
+    {
+        symbols.push_back(SymbolRegistry::instance().intern("SHARD_P" + std::to_string(i)));
+    }
+    engine.registerTrader(1, "Alice", 1e9);
+    engine.start();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&engine, &symbols, p]()
+        {
+            for (int i = 0; i < kOrdersEach; ++i)
+            {
+                std::uint64_t tag = static_cast<std::uint64_t>(p) * kOrdersEach + i;
+                SymbolId symbol = symbols[i % symbols.size()];
+                while (!engine.submitOrder(tag, 1, symbol, 1, 1.0, OrderSide::BUY))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    auto results = collect(engine, kProducers * kOrdersEach);
+    for (auto &producer : producers)
+    {
+        producer.join();
+    }
+    engine.stop();
+
+    std::vector<bool> seen(kProducers * kOrdersEach);
+    for (const ShardResult &result : results)
+    {
+        EXPECT_EQ(result.status, ShardResultStatus::ACCEPTED);
+        seen[result.tag] = true;
+    }
+    EXPECT_EQ(std::count(seen.begin(), seen.end(), true), kProducers * kOrdersEach);
+}
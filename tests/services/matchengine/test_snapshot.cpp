@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "EngineTestMarket.hpp"
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static const EngineTestMarket kMarket{"SNAP_A", "SNAP_B"};
+
+TEST(SnapshotTest, SnapshotPlusJournalSuffixRestoresState)
+{
+    std::string journal = freshTempPath("matchengine_snap.journal");
+    std::string snapshot = freshTempPath("matchengine_snap.snapshot");
+    std::vector<std::int64_t> before;
+    std::uint64_t records = 0;
+    {
+        auto engine = kMarket.startEngine();
+        engine->enableJournal(journal);
+        engine->enableSnapshots(snapshot, 700);
+        std::mt19937 rng(23);
+        kMarket.trade(*engine, rng, 3000, OrderType::STOP_LIMIT);
+        engine->getJournal()->commit();
+        engine->flushSnapshots();
+        records = engine->getJournal()->getLastSequence();
+        before = kMarket.describe(*engine);
+    }
+
+    auto restarted = kMarket.startEngine();
+    std::uint64_t covered = restarted->restoreSnapshot(snapshot);
+    EXPECT_GT(covered, 0);
+    EXPECT_LT(covered, records);
+    size_t replayed = restarted->enableJournal(journal);
+    EXPECT_GT(replayed, 0);
+    EXPECT_LT(replayed, records - covered + 1);
+    EXPECT_EQ(restarted->getJournal()->getLastSequence(), records);
+    EXPECT_EQ(kMarket.describe(*restarted), before);
+
+    // The full journal on its own still rebuilds the same state
+    auto replayedOnly = kMarket.startEngine();
+    replayedOnly->enableJournal(journal);
+    EXPECT_EQ(kMarket.describe(*replayedOnly), before);
+
+    std::filesystem::remove(journal);
+    std::filesystem::remove(snapshot);
+}
+
+TEST(SnapshotTest, RestoredOrdersKeepTimePriority)
+{
+    std::string snapshot = freshTempPath("matchengine_priority.snapshot");
+    int first = 0;
+    int stop = 0;
+    {
+        auto engine = kMarket.startEngine();
+        first = engine->submitOrder(2, "SNAP_A", 10, 10.0, OrderSide::BUY);
+        engine->submitOrder(3, "SNAP_A", 10, 10.0, OrderSide::BUY);
+        engine->submitOrder(1, "SNAP_A", 4, 10.0, OrderSide::SELL);
+        stop = engine->submitOrder(1, "SNAP_A", 5, 0.0, OrderSide::BUY, OrderType::STOP, 12.0);
+        EXPECT_EQ(engine->takeSnapshot(snapshot), 0);
+        engine->flushSnapshots();
+    }
+
+    MatchingEngine engine;
+    engine.restoreSnapshot(snapshot);
+    ASSERT_NE(engine.getTrader(2), nullptr);
+    EXPECT_EQ(engine.getTrader(2)->getName(), "T2");
+    ASSERT_NE(engine.getOrder(first), nullptr);
+    EXPECT_EQ(engine.getOrder(first)->getFilledQuantity(), 4);
+    ASSERT_NE(engine.getOrder(stop), nullptr);
+    EXPECT_EQ(engine.getOrderBook("SNAP_A")->getPendingStopCount(), 1);
+    EXPECT_EQ(engine.getOrderBook("SNAP_A")->getTradeCount(), 1);
+
+    // The partly filled first bid is still ahead of the second
+    int next = engine.submitOrder(1, "SNAP_A", 6, 10.0, OrderSide::SELL);
+    EXPECT_GT(next, stop);
+    EXPECT_EQ(engine.getOrder(first), nullptr);
+    EXPECT_EQ(engine.getOrderBook("SNAP_A")->getBestBidQuantity(), 10);
+    std::filesystem::remove(snapshot);
+}
+
+TEST(SnapshotTest, PositionsRoundTripExactly)
+{
+    std::string snapshot = freshTempPath("matchengine_positions.snapshot");
+    MatchingEngine engine;
+    engine.registerTrader(std::make_shared<Trader>(1, "T1", 1e6));
+    auto trader = engine.getTrader(1);
+
+    // A cost basis no average price rounds back to, a flat position that
+    // realized P&L, and a mark away from the last fill
+    trader->onOrderFilled("SNAP_A", 3, 10.01, true);
+    trader->onOrderFilled("SNAP_A", 4, 10.02, true);
+    trader->onOrderFilled("SNAP_A", 2, 10.50, false);
+    trader->onOrderFilled("SNAP_B", 100, 5.00, true);
+    trader->onOrderFilled("SNAP_B", 100, 5.25, false);
+    trader->updatePosition(engine.getSymbolId("SNAP_A"), 11.37);
+    const PositionLedger &before = trader->getPositions();
+    ASSERT_NE(before.getRealizedPnL(), 0);
+    ASSERT_EQ(before.size(), 1);
+
+    engine.takeSnapshot(snapshot);
+    engine.flushSnapshots();
+
+    MatchingEngine restarted;
+    restarted.restoreSnapshot(snapshot);
+    const PositionLedger &after = restarted.getTrader(1)->getPositions();
+    EXPECT_EQ(after.size(), 1);
+    EXPECT_EQ(after.getCostBasis(), before.getCostBasis());
+    EXPECT_EQ(after.getNetExposure(), before.getNetExposure());
+    EXPECT_EQ(after.getGrossExposure(), before.getGrossExposure());
+    EXPECT_EQ(after.getRealizedPnL(), before.getRealizedPnL());
+    EXPECT_EQ(after.getUnrealizedPnL(), before.getUnrealizedPnL());
+
+    const Position *a = after.find(restarted.getSymbolId("SNAP_A"));
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(a->quantity, 5);
+    EXPECT_DOUBLE_EQ(a->marketPrice, 11.37);
+    EXPECT_EQ(a->realizedPnL, before.find(engine.getSymbolId("SNAP_A"))->realizedPnL);
+    EXPECT_EQ(after.getShares(restarted.getSymbolId("SNAP_B")), 0);
+
+    std::filesystem::remove(snapshot);
+}
+
+TEST(SnapshotTest, RejectsTruncatedFileAndBusyEngine)
+{
+    std::string snapshot = freshTempPath("matchengine_truncated.snapshot");
+    {
+        auto engine = kMarket.startEngine();
+        engine->submitOrder(1, "SNAP_B", 10, 10.0, OrderSide::BUY);
+        engine->takeSnapshot(snapshot);
+        engine->flushSnapshots();
+        EXPECT_THROW(engine->restoreSnapshot(snapshot), std::logic_error);
+    }
+    std::filesystem::resize_file(snapshot, std::filesystem::file_size(snapshot) - 8);
+
+    MatchingEngine engine;
+    EXPECT_THROW(engine.restoreSnapshot(snapshot), std::runtime_error);
+    std::filesystem::remove(snapshot);
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include <memory>
+#include <vector>
+
+class StopOrderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        orderBook = std::make_unique<OrderBook>("STOP_A");
+    }
+
+    std::unique_ptr<OrderBook> orderBook;
+    std::vector<std::unique_ptr<Order>> orders;
+
+    Price ticks(double price) const { return orderBook->getInstrument().toTicks(price); }
+    Quantity lots(double quantity) const { return orderBook->getInstrument().toLots(quantity); }
+
+    Order *add(int id, OrderSide side, double quantity, double price,
+               OrderType type = OrderType::LIMIT, double stopPrice = 0.0)
+    {
+        orders.push_back(std::make_unique<Order>(id, 100 + id, orderBook->getSymbolId(), lots(quantity),
+                                                 ticks(price), side, type, ticks(stopPrice)));
+        orderBook->addOrder(orders.back().get());
+        return orders.back().get();
+    }
+};
+
+TEST_F(StopOrderTest, MarketOrderSweepsAndCancelsRemainder)
+{
+    add(1, OrderSide::SELL, 10, 100.0);
+    add(2, OrderSide::SELL, 10, 105.0);
+
+    Order *market = add(3, OrderSide::BUY, 25, 0.0, OrderType::MARKET);
+    EXPECT_EQ(orderBook->getTradeCount(), 2);
+    EXPECT_EQ(market->getFilledQuantity(), lots(20));
+    EXPECT_EQ(market->getStatus(), OrderStatus::CANCELLED);
+    EXPECT_EQ(orderBook->getBidDepth(), 0);
+    EXPECT_EQ(orderBook->getAskDepth(), 0);
+}
+
+TEST_F(StopOrderTest, BuyStopParksUntilTradeReachesTrigger)
+{
+    add(1, OrderSide::SELL, 10, 100.0);
+    add(2, OrderSide::SELL, 10, 101.0);
+    add(3, OrderSide::SELL, 10, 102.0);
+
+    Order *stop = add(4, OrderSide::BUY, 10, 0.0, OrderType::STOP, 101.0);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 1);
+    EXPECT_TRUE(orderBook->hasOrder(stop));
+    EXPECT_EQ(orderBook->getBidDepth(), 0);
+
+    // A trade below the trigger leaves it parked
+    add(5, OrderSide::BUY, 10, 100.0);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 1);
+    EXPECT_FALSE(stop->isTriggered());
+
+    // Trading at the trigger releases it against the remaining ask
+    add(6, OrderSide::BUY, 10, 101.0);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 0);
+    EXPECT_TRUE(stop->isTriggered());
+    EXPECT_EQ(stop->getStatus(), OrderStatus::FILLED);
+    ASSERT_EQ(orderBook->getTradeCount(), 3);
+    EXPECT_EQ(orderBook->getTrades().back().price, ticks(102.0));
+    EXPECT_EQ(orderBook->getTrades().back().buyOrderId, 4);
+}
+
+TEST_F(StopOrderTest, StopAlreadyReachedTriggersOnEntry)
+{
+    add(1, OrderSide::SELL, 10, 100.0);
+    add(2, OrderSide::BUY, 5, 100.0);
+    add(3, OrderSide::BUY, 5, 0.0, OrderType::STOP, 99.0);
+
+    EXPECT_EQ(orderBook->getPendingStopCount(), 0);
+    EXPECT_EQ(orderBook->getTradeCount(), 2);
+    EXPECT_EQ(orderBook->getAskDepth(), 0);
+}
+
+TEST_F(StopOrderTest, TriggeredStopLimitRestsAtItsLimit)
+{
+    add(1, OrderSide::BUY, 10, 100.0);
+    add(2, OrderSide::BUY, 10, 95.0);
+
+    Order *stopLimit = add(3, OrderSide::SELL, 10, 98.0, OrderType::STOP_LIMIT, 100.0);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 1);
+
+    add(4, OrderSide::SELL, 10, 100.0);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 0);
+    EXPECT_EQ(stopLimit->getFilledQuantity(), 0);
+    EXPECT_EQ(stopLimit->getStatus(), OrderStatus::PENDING);
+    EXPECT_EQ(orderBook->getBestAskPrice(), 98.0);
+    EXPECT_EQ(orderBook->getBestBidPrice(), 95.0);
+}
+
+TEST_F(StopOrderTest, TriggeredStopLimitQueuesBehindEarlierLimits)
+{
+    // The stop is submitted before the limit at its price but only rests
+    // once triggered, so the limit keeps priority
+    Order *stopLimit = add(1, OrderSide::SELL, 10, 98.0, OrderType::STOP_LIMIT, 100.0);
+    Order *limit = add(2, OrderSide::SELL, 10, 98.0);
+    add(3, OrderSide::BUY, 5, 98.0);
+    ASSERT_EQ(orderBook->getPendingStopCount(), 0);
+    ASSERT_EQ(orderBook->getAskLevelCount(), 1);
+
+    add(4, OrderSide::BUY, 10, 98.0);
+    const TradeHistory &trades = orderBook->getTrades();
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[1].sellOrderId, 2);
+    EXPECT_EQ(trades[2].sellOrderId, 1);
+    EXPECT_EQ(limit->getStatus(), OrderStatus::FILLED);
+    EXPECT_EQ(stopLimit->getRemainingQuantity(), lots(5));
+}
+
+TEST_F(StopOrderTest, CascadeActivatesInTriggerThenTimeOrder)
+{
+    add(1, OrderSide::BUY, 10, 100.0);
+    add(2, OrderSide::BUY, 10, 99.0);
+    add(3, OrderSide::BUY, 10, 98.0);
+    add(4, OrderSide::BUY, 10, 97.0);
+
+    // Two stops at the same trigger keep their arrival order; the nearer
+    // trigger goes first
+    add(5, OrderSide::SELL, 5, 0.0, OrderType::STOP, 98.0);
+    add(6, OrderSide::SELL, 5, 0.0, OrderType::STOP, 98.0);
+    add(7, OrderSide::SELL, 10, 0.0, OrderType::STOP, 99.0);
+    ASSERT_EQ(orderBook->getPendingStopCount(), 3);
+
+    // Sweeps 100 and 99, which triggers 7 into 98, which triggers 5 and 6
+    add(8, OrderSide::SELL, 20, 99.0);
+
+    EXPECT_EQ(orderBook->getPendingStopCount(), 0);
+    const TradeHistory &trades = orderBook->getTrades();
+    ASSERT_EQ(trades.size(), 5);
+    std::vector<std::pair<int, Price>> expected = {
+        {8, ticks(100.0)}, {8, ticks(99.0)}, {7, ticks(98.0)}, {5, ticks(97.0)}, {6, ticks(97.0)}};
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(trades[i].sellOrderId, expected[i].first) << "trade " << i;
+        EXPECT_EQ(trades[i].price, expected[i].second) << "trade " << i;
+    }
+    EXPECT_EQ(orderBook->getBidDepth(), 0);
+}
+
+TEST_F(StopOrderTest, PendingStopCanBeCancelled)
+{
+    Order *stop = add(1, OrderSide::SELL, 10, 0.0, OrderType::STOP, 90.0);
+    ASSERT_EQ(orderBook->getPendingStopCount(), 1);
+
+    EXPECT_TRUE(orderBook->cancelOrder(stop));
+    EXPECT_EQ(stop->getStatus(), OrderStatus::CANCELLED);
+    EXPECT_EQ(orderBook->getPendingStopCount(), 0);
+    EXPECT_FALSE(orderBook->hasOrder(stop));
+    EXPECT_FALSE(orderBook->cancelOrder(stop));
+
+    // Nothing fires once it is gone
+    add(2, OrderSide::BUY, 10, 85.0);
+    add(3, OrderSide::SELL, 10, 85.0);
+    EXPECT_EQ(orderBook->getTradeCount(), 1);
+}
+
+TEST(StopOrderEngineTest, StopsGoThroughTheEngineAndReleaseTheirSlots)
+{
+    MatchingEngine engine;
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 100000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 100000.0));
+    engine.getTrader(2)->onOrderFilled("STOP_E", 100, 1.0, true);
+
+    int stopId = engine.submitOrder(1, "STOP_E", 10, 0.0, OrderSide::BUY, OrderType::STOP, 50.0);
+    EXPECT_NE(engine.getOrder(stopId), nullptr);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 1);
+
+    engine.submitOrder(2, "STOP_E", 30, 50.0, OrderSide::SELL);
+    engine.submitOrder(1, "STOP_E", 10, 50.0, OrderSide::BUY);
+
+    EXPECT_EQ(engine.getTotalTradeCount(), 2);
+    EXPECT_EQ(engine.getOrder(stopId), nullptr);
+    EXPECT_EQ(engine.getOrderPoolStats().inUse, 1); // the rest of Bob's sell
+    EXPECT_DOUBLE_EQ(engine.getTrader(1)->getCash(), 100000.0 - 1000.0);
+
+    EXPECT_THROW(engine.submitOrder(1, "STOP_E", 10, 0.0, OrderSide::BUY, OrderType::STOP), std::invalid_argument);
+    EXPECT_THROW(engine.submitOrder(1, "STOP_E", 10, 0.0, OrderSide::BUY, OrderType::STOP_LIMIT, 50.0),
+                 std::invalid_argument);
+}
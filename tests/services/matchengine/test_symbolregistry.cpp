@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "MatchingEngine.hpp"
+#include "SymbolRegistry.hpp"
+#include <memory>
+
+TEST(SymbolRegistryTest, InternAssignsDenseStableIds)
+{
+    auto &registry = SymbolRegistry::instance();
+    size_t before = registry.size();
+
+    SymbolId first = registry.intern("REG_FIRST");
+    SymbolId second = registry.intern("REG_SECOND");
+
+    EXPECT_EQ(first, before);
+    EXPECT_EQ(second, before + 1);
+    EXPECT_EQ(registry.intern("REG_FIRST"), first);
+    EXPECT_EQ(registry.find("REG_SECOND"), second);
+    EXPECT_EQ(registry.name(first), "REG_FIRST");
+    EXPECT_EQ(registry.size(), before + 2);
+}
+
+TEST(SymbolRegistryTest, UnknownSymbols)
+{
+    auto &registry = SymbolRegistry::instance();
+
+    EXPECT_EQ(registry.find("REG_NEVER_SEEN"), kInvalidSymbolId);
+    EXPECT_THROW(registry.name(kInvalidSymbolId), std::out_of_range);
+}
+
+TEST(SymbolRegistryTest, EngineKeysBooksAndPositionsById)
+{
+    MatchingEngine engine;
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 100000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 100000.0));
+    engine.getTrader(2)->onOrderFilled("REG_IBM", 10, 100.0, true);
+
+    SymbolId ibm = engine.getSymbolId("REG_IBM");
+    engine.submitOrder(2, ibm, 10, 101.0, OrderSide::SELL);
+    engine.submitOrder(1, "REG_IBM", 4, 101.0, OrderSide::BUY);
+
+    ASSERT_NE(engine.getOrderBook(ibm), nullptr);
+    EXPECT_EQ(engine.getOrderBook(ibm), engine.getOrderBook("REG_IBM"));
+    EXPECT_EQ(engine.getLastPrice(ibm), 101.0);
+    EXPECT_EQ(engine.getBestAsk("REG_IBM"), 101.0);
+    EXPECT_EQ(engine.getOrderBook("REG_UNKNOWN"), nullptr);
+
+    // Asking for an id does not register the name
+    size_t known = SymbolRegistry::instance().size();
+    EXPECT_EQ(engine.getSymbolId("REG_UNKNOWN"), kInvalidSymbolId);
+    EXPECT_EQ(SymbolRegistry::instance().size(), known);
+
+    const auto &positions = engine.getTrader(1)->getPositions();
+    ASSERT_NE(positions.find(ibm), nullptr);
+    EXPECT_EQ(positions.find(ibm)->quantity, 4);
+    EXPECT_TRUE(engine.getTrader(2)->hasSufficientShares("REG_IBM", 6));
+    EXPECT_FALSE(engine.getTrader(2)->hasSufficientShares(ibm, 7));
+}
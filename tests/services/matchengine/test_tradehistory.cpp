@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "TradeHistory.hpp"
+#include "MatchingEngine.hpp"
+#include <filesystem>
+#include <memory>
+
+static const SymbolId kHist = SymbolRegistry::instance().intern("HIST");
+
+static Trade makeTrade(int id)
+{
+    return Trade(id, id + 1000, 1, 2, kHist, id, 10000 + id);
+}
+
+static std::filesystem::path freshDirectory(const std::string &name)
+{
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+TEST(TradeHistoryTest, RingKeepsNewestTrades)
+{
+    TradeHistory history(3);
+    EXPECT_EQ(history.getCapacity(), 4);
+    EXPECT_TRUE(history.empty());
+
+    for (int id = 0; id < 10; ++id)
+    {
+        history.append(makeTrade(id));
+    }
+
+    EXPECT_EQ(history.getTotalCount(), 10);
+    EXPECT_EQ(history.size(), 4);
+    EXPECT_EQ(history.getFirstInMemory(), 6);
+    EXPECT_EQ(history[0].buyOrderId, 6);
+    EXPECT_EQ(history.back().buyOrderId, 9);
+    EXPECT_EQ(history.at(7).price, 10007);
+
+    EXPECT_THROW(history.at(5), std::out_of_range);
+    EXPECT_THROW(history.readFrom(2), std::out_of_range);
+}
+
+TEST(TradeHistoryTest, CursorReadsAcrossSpillFileAndRing)
+{
+    auto dir = freshDirectory("matchengine_trade_history");
+    TradeHistory history(4);
+    history.spillTo((dir / "HIST.trades").string());
+
+    // Nothing may be overwritten before it is on disk, so drain as we go
+    for (int id = 0; id < 10; ++id)
+    {
+        history.append(makeTrade(id));
+        if (id % 4 == 3)
+        {
+            history.flushPending();
+        }
+    }
+    EXPECT_EQ(history.getSpilledCount(), 8);
+    EXPECT_EQ(history.flushPending(), 2);
+    EXPECT_EQ(std::filesystem::file_size(dir / "HIST.trades"), 10 * sizeof(Trade));
+
+    auto cursor = history.readFrom(1);
+    Trade trade;
+    int expected = 1;
+    while (cursor.next(trade))
+    {
+        EXPECT_EQ(trade.buyOrderId, expected);
+        EXPECT_EQ(trade.quantity, expected);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 10);
+    EXPECT_EQ(cursor.position(), 10);
+}
+
+TEST(TradeHistoryTest, EngineSpillsTradesBeyondTheRing)
+{
+    auto dir = freshDirectory("matchengine_trade_spill");
+    MatchingEngine engine;
+    engine.configureTradeHistory(4);
+    engine.enableTradeSpill(dir.string());
+    engine.registerTrader(std::make_shared<Trader>(1, "Alice", 1000000.0));
+    engine.registerTrader(std::make_shared<Trader>(2, "Bob", 1000000.0));
+    engine.getTrader(2)->onOrderFilled("SPILL", 1000, 10.0, true);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        engine.submitOrder(2, "SPILL", 10, 10.0, OrderSide::SELL);
+        engine.submitOrder(1, "SPILL", 10, 10.0, OrderSide::BUY);
+    }
+    engine.flushTradeSpill();
+
+    const TradeHistory &history = engine.getOrderBook("SPILL")->getTrades();
+    EXPECT_EQ(history.size(), 4);
+    EXPECT_EQ(history.getTotalCount(), 50);
+    EXPECT_EQ(history.getSpilledCount(), 50);
+
+    auto trades = engine.getAllTrades();
+    ASSERT_EQ(trades.size(), 50);
+    for (size_t i = 0; i < trades.size(); ++i)
+    {
+        EXPECT_EQ(trades[i].sellOrderId, static_cast<int>(2 * i + 1));
+        EXPECT_EQ(trades[i].buyOrderId, static_cast<int>(2 * i + 2));
+    }
+    EXPECT_EQ(engine.getTotalTradeCount(), 50);
+}
+
+TEST(TradeHistoryTest, FailedSpillStopsWaitingForTheWriter)
+{
+    if (!std::filesystem::exists("/dev/full"))
+    {
+        GTEST_SKIP() << "needs /dev/full";
+    }
+    TradeHistory history(4);
+    history.spillTo("/dev/full"); // opens, but every write fails
+    TradeSpillWriter writer;
+    writer.add(history);
+
+    // Without the writer draining the ring, append would wait forever
+    for (int id = 0; id < 100; ++id)
+    {
+        history.append(makeTrade(id));
+    }
+    EXPECT_THROW(writer.flush(), std::runtime_error);
+    EXPECT_TRUE(history.hasSpillFailed());
+    EXPECT_EQ(history.getSpilledCount(), 0);
+    EXPECT_EQ(history.flushPending(), 0);
+
+    // Only the ring is left to read
+    EXPECT_EQ(history.getFirstAvailable(), 96);
+    EXPECT_THROW(history.readFrom(0), std::out_of_range);
+    auto cursor = history.readFrom(history.getFirstAvailable());
+    Trade trade;
+    int expected = 96;
+    while (cursor.next(trade))
+    {
+        EXPECT_EQ(trade.buyOrderId, expected++);
+    }
+    EXPECT_EQ(expected, 100);
+}